@@ -0,0 +1,38 @@
+// Covered query results are written from the index key; check every key type round trips and the
+// covered counters in explain and serverStatus.
+
+t = db.jstests_coveredIndex6;
+t.drop();
+
+t.ensureIndex( { a:1, b:1, c:1 } );
+
+values = [ MinKey, null, false, true, 5, 2.5, NumberLong( 7 ), 'str', '', ObjectId(),
+          new Date( 1000 ), BinData( 0, 'AAAA' ), MaxKey, { x:1 } ];
+for( i in values ) {
+    t.save( { a:i * 1, b:values[ i ], c:'c' + i } );
+}
+
+// Fields are returned in key order with their projected names, skipping those not wanted.
+results = t.find( { a:{ $gte:0 } }, { _id:0, a:1, b:1 } ).sort( { a:1 } ).batchSize( 3 ).toArray();
+assert.eq( values.length, results.length );
+for( i in values ) {
+    assert.eq( { a:i * 1, b:values[ i ] }, results[ i ] );
+}
+results = t.find( { a:{ $gte:0 } }, { _id:0, c:1, a:1 } ).sort( { a:1 } ).toArray();
+for( i in values ) {
+    assert.eq( [ 'a', 'c' ], Object.keySet( results[ i ] ) );
+    assert.eq( 'c' + i, results[ i ].c );
+}
+
+explain = t.find( { a:{ $gte:0 } }, { _id:0, a:1, b:1 } ).explain();
+assert( explain.indexOnly );
+assert.eq( values.length, explain.nCovered );
+explain = t.find( { a:{ $gte:0 } } ).explain();
+assert( !explain.indexOnly );
+assert.eq( 0, explain.nCovered );
+
+before = db.serverStatus().coveredQueries;
+t.find( { a:{ $gte:0 } }, { _id:0, a:1 } ).batchSize( 2 ).toArray();
+after = db.serverStatus().coveredQueries;
+assert.eq( before.query + 1, after.query );
+assert.lt( before.getmore, after.getmore );
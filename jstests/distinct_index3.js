@@ -0,0 +1,52 @@
+// Skip scanning an index led by the distinct key.
+
+t = db.distinct_index3;
+t.drop();
+
+function d( k , q ){
+    return t.runCommand( "distinct" , { key : k , query : q || {} } );
+}
+
+function sorted( x ){
+    return x.values.sort( function( a , b ){ return bsonWoCompare( { x : a } , { x : b } ); } );
+}
+
+for ( i=0; i<3000; i++ ){
+    t.insert( { a : i % 7 , b : i % 11 , c : i } );
+}
+t.insert( { b : 1 } );
+t.insert( { a : null , b : 2 } );
+
+t.ensureIndex( { a : 1 , b : 1 } );
+
+// Leading field of a compound index.
+x = d( "a" );
+assert.eq( [ null , 0 , 1 , 2 , 3 , 4 , 5 , 6 ] , sorted( x ) , "A1" );
+assert.gt( 20 , x.stats.nscanned , "A2" );
+assert.eq( 0 , x.stats.nscannedObjects , "A3" );
+
+// A non leading field can't be skip scanned.
+x = d( "b" );
+assert.eq( 11 , x.values.length , "B1" );
+assert.eq( 3002 , x.stats.nscanned , "B2" );
+
+// A query on the leading field bounds the skip scan.
+x = d( "a" , { a : { $gte : 2 , $lt : 5 } } );
+assert.eq( [ 2 , 3 , 4 ] , sorted( x ) , "C1" );
+assert.eq( 3 , x.stats.nscanned , "C2" );
+
+// Keys failing the matcher are stepped over until one matches.
+x = d( "a" , { a : { $gte : 0 } , b : 10 } );
+assert.eq( [ 0 , 1 , 2 , 3 , 4 , 5 , 6 ] , sorted( x ) , "D1" );
+
+// Descending indexes are skip scanned too.
+t.dropIndexes();
+t.ensureIndex( { a : -1 , c : 1 } );
+x = d( "a" );
+assert.eq( [ null , 0 , 1 , 2 , 3 , 4 , 5 , 6 ] , sorted( x ) , "E1" );
+assert.gt( 20 , x.stats.nscanned , "E2" );
+
+// Without skipping, multikey values must all be seen.
+t.insert( { a : [ 7 , 8 ] } );
+x = d( "a" );
+assert.eq( [ null , 0 , 1 , 2 , 3 , 4 , 5 , 6 , 7 , 8 ] , sorted( x ) , "F1" );
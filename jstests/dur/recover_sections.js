@@ -0,0 +1,58 @@
+/* test durability
+   replays a journal holding many group commits that write to several data files, so recovery
+   applies each section's writes on more than one worker and later sections overwrite earlier ones
+*/
+
+testname = "recover_sections";
+load("jstests/_tst.js");
+
+var path = "/data/db/" + testname + "dur";
+var dbs = [ "rs_a", "rs_b", "rs_c", "rs_d" ];
+var rounds = 5;
+
+tst.log("run mongod with --dur");
+var conn = startMongodEmpty("--port", 30001, "--dbpath", path, "--dur", "--smallfiles", "--durOptions", 8);
+
+tst.log("work");
+var big = "x"; while( big.length < 4096 ) big += big;
+for( var r = 0; r < rounds; r++ ) {
+    dbs.forEach( function( name ) {
+        var c = conn.getDB( name ).foo;
+        for( var i = 0; i < 500; i++ ) {
+            if( r == 0 )
+                c.insert( { _id:i, round:r, z:big } );
+            else
+                c.update( { _id:i }, { $set:{ round:r } } );
+        }
+        c.getDB().getLastError();
+    } );
+    // let a group commit happen so each round lands in its own journal section(s)
+    sleep( 300 );
+}
+
+tst.log("sleep a bit for a group commit");
+sleep( 8000 );
+
+tst.log("kill -9 mongod");
+stopMongod(30001, /*signal*/9);
+
+assert(listFiles(path + "/journal/").length > 0, "journal directory is unexpectedly empty after kill");
+
+// replay every section from the start of the journal
+removeFile(path + "/journal/lsn");
+
+tst.log("restart and recover");
+conn = startMongodNoReset("--port", 30002, "--dbpath", path, "--dur", "--smallfiles", "--durOptions", 8);
+
+tst.log("check data results");
+dbs.forEach( function( name ) {
+    var c = conn.getDB( name ).foo;
+    assert.eq( 500, c.count(), name + " count" );
+    assert.eq( 500, c.find( { round:rounds - 1 } ).itcount(), name + " last round not applied" );
+    assert( c.validate().valid, name + " validate" );
+} );
+
+tst.log("stop");
+stopMongod(30002);
+
+tst.success();
@@ -0,0 +1,53 @@
+/**
+ *  Throughput of updates running alongside long unindexed scans.
+ *  Scans yield only when the updates are queued behind them, so both numbers
+ *  should hold up as the number of scanning clients grows.
+ *
+ *  benchRun runs every op in the list on each of its threads, so the scanning
+ *  readers and the updater are separate runs going at the same time.
+ */
+
+var t = db.perf_yield_mixed;
+t.drop();
+
+for( var i = 0; i < 100000; ++i ) {
+    t.insert( { _id:i, x:0, s:"" + i } );
+}
+db.getLastError();
+
+var seconds = 5;
+
+function run( readers ) {
+    var readRun = null;
+    if ( readers > 0 ) {
+        readRun = benchStart( { ops:[ { ns:t.getFullName(), op:"findOne", query:{ s:"none" } } ],
+                                parallel:readers, seconds:seconds, host:db.getMongo().host } );
+    }
+    var updates = benchRun( { ops:[ { ns:t.getFullName(), op:"update",
+                                      query:{ _id:{ "#RAND_INT":[ 0, 100000 ] } },
+                                      update:{ $inc:{ x:1 } } } ],
+                              parallel:1, seconds:seconds, host:db.getMongo().host } );
+    var reads = readRun ? benchFinish( readRun ) : {};
+
+    // opcounters are server wide, but the two runs only issue updates and queries respectively
+    var res = { readers:readers,
+                updatesPerSec:updates.update,
+                updateLatencyAverageMicros:updates.updateLatencyAverageMs,
+                queriesPerSec:reads.query,
+                queryLatencyAverageMicros:reads.findOneLatencyAverageMs };
+    printjson( res );
+    assert.eq( 0, updates.errCount, "update errors" );
+    if ( readRun ) {
+        assert.eq( 0, reads.errCount, "query errors" );
+    }
+    return res;
+}
+
+var results = [ 0, 1, 4, 16 ].map( run );
+
+print( "readers\tupdates/s\tqueries/s" );
+results.forEach( function( r ) {
+    print( r.readers + "\t" + r.updatesPerSec + "\t" + ( r.queriesPerSec || 0 ) );
+} );
+
+t.drop();
@@ -0,0 +1,49 @@
+// Case insensitive prefix regexes are bounded on an index, and required literals prefilter
+// unanchored regexes.
+
+t = db.jstests_regexc;
+t.drop();
+
+t.save( { a : "abc" } );
+t.save( { a : "ABCD" } );
+t.save( { a : "aBx" } );
+t.save( { a : "Abd" } );
+t.save( { a : "b" } );
+t.save( { a : "ZZZ" } );
+t.save( { a : "an Error occurred" } );
+t.save( { a : "kelvin" } );
+t.save( { a : "Kelvin" } );
+
+function check( query, count ) {
+    assert.eq( count, t.find( query ).itcount(), tojson( query ) );
+}
+
+check( { a : /^abc/i }, 2 );
+check( { a : /^ab/i }, 4 );
+check( { a : /error/i }, 1 );
+check( { a : /n error o/i }, 1 );
+check( { a : /erroR/ }, 0 );
+check( { a : /Error|zz/ }, 1 );
+check( { a : /err(or)?/i }, 1 );
+check( { a : { $not : /error/i } }, 8 );
+check( { a : { $in : [ /^ab/i, /zz/i ] } }, 5 );
+
+for( i = 0; i < 50; ++i ) {
+    t.save( { a : "zz" + i } );
+}
+t.ensureIndex( { a : 1 } );
+
+check( { a : /^abc/i }, 2 );
+check( { a : /^ab/i }, 4 );
+check( { a : /error/i }, 1 );
+check( { a : { $in : [ /^ab/i, /zz/i ] } }, 55 );
+
+// Each case variant of the prefix is scanned as its own interval, followed by the regex itself.
+assert.eq( 5, t.find( { a : /^ab/i } ).explain().indexBounds.a.length );
+assert.gt( 10, t.find( { a : /^ab/i } ).explain().nscanned );
+assert.gt( 10, t.find( { a : /^abc/i } ).explain().nscanned );
+// Only the first four letters are expanded.
+assert.eq( 17, t.find( { a : /^abcdef/i } ).explain().indexBounds.a.length );
+
+// No bounds from k and s, which have non ascii case variants.
+check( { a : /^kelvin/i }, 2 );
@@ -0,0 +1,27 @@
+// Multi removes delete matching documents in batches; check the indexes stay consistent.
+
+t = db.jstests_removed;
+t.drop();
+
+t.ensureIndex( { a:1 } );
+t.ensureIndex( { b:-1 } );
+for( i = 0; i < 1000; ++i ) {
+    t.save( { _id:i, a:[ i % 7, i % 7 + 10, 20 ], b:i } );
+}
+db.getLastError();
+
+// A multikey scan finds each document under several keys.
+t.remove( { a:{ $gte:0 }, b:{ $mod:[ 2, 0 ] } } );
+assert( !db.getLastError() );
+assert.eq( 500, db.getLastErrorObj().n );
+assert.eq( 500, t.count() );
+assert.eq( 500, t.find( { a:20 } ).hint( { a:1 } ).itcount() );
+assert.eq( 500, t.find().hint( { b:-1 } ).itcount() );
+assert.eq( 0, t.find( { b:{ $mod:[ 2, 0 ] } } ).itcount() );
+
+// The scan ends on a document that does not match, with a partial batch pending.
+t.remove( { b:{ $lt:999 } } );
+assert.eq( 1, t.count() );
+assert.eq( [ { _id:999 } ], t.find( { a:20 }, { _id:1 } ).hint( { a:1 } ).toArray() );
+
+assert( t.validate().valid );
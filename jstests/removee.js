@@ -0,0 +1,37 @@
+// Cursors open over a batched multi remove are moved off every deleted document, even when moving
+// off one deleted document puts them on another deleted earlier in the batch.
+
+t = db.jstests_removee;
+t.drop();
+
+t.ensureIndex( { a:1 } );
+t.ensureIndex( { b:1 } );
+for( i = 0; i < 1000; ++i ) {
+    t.save( { _id:i, a:i, b:i } );
+}
+db.getLastError();
+
+// Ascending on b, left on b:102.
+up = t.find( { b:{ $gte:100 } } ).sort( { b:1 } ).batchSize( 2 );
+assert.eq( 100, up.next().b );
+assert.eq( 101, up.next().b );
+
+// Descending on a, left on a:149.  The remove below deletes a:100 to a:199 in one batch in
+// ascending order, so moving this cursor off a:149 puts it on a:148, already deleted.
+down = t.find( { a:{ $lt:152 } } ).sort( { a:-1 } ).batchSize( 2 );
+assert.eq( 151, down.next().a );
+assert.eq( 150, down.next().a );
+
+t.remove( { a:{ $gte:100, $lt:200 } } );
+assert( !db.getLastError() );
+assert.eq( 900, t.count() );
+
+upRest = up.toArray();
+assert.eq( 800, upRest.length );
+assert.eq( 200, upRest[ 0 ].b );
+
+downRest = down.toArray();
+assert.eq( 100, downRest.length );
+assert.eq( 99, downRest[ 0 ].a );
+
+assert( t.validate().valid );
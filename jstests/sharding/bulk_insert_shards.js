@@ -0,0 +1,40 @@
+// A bulk insert spanning chunks on several shards is sent as one batch per shard, and
+// getLastError merges the errors of every shard.
+
+s = new ShardingTest( "bulk_insert_shards" , 3 , 1 , 1 );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+// six chunks, two per shard
+for ( i = 1; i < 6; i++ ) {
+    s.adminCommand( { split : "test.foo" , middle : { num : i * 100 } } );
+}
+shards = s.config.shards.find().sort( { _id : 1 } ).toArray();
+for ( i = 0; i < 6; i++ ) {
+    s.adminCommand( { movechunk : "test.foo" , find : { num : i * 100 } , to : shards[ i % 3 ]._id } );
+}
+
+docs = [];
+for ( i = 0; i < 600; i++ ) {
+    docs.push( { _id : i , num : i } );
+}
+db.foo.insert( docs );
+assert.isnull( db.getLastError() , "bulk insert" );
+assert.eq( 600 , db.foo.count() , "count" );
+for ( i = 0; i < 3; i++ ) {
+    assert.eq( 200 , s._connections[ i ].getDB( "test" ).foo.count() , "spread " + i );
+}
+
+// duplicates on two shards, inserts continue on error
+db.foo.insert( [ { _id : 1 , num : 1 } , { _id : 1000 , num : 1000 } , { _id : 101 , num : 101 } ,
+                 { _id : 1001 , num : 250 } ] );
+gle = db.getLastErrorObj();
+printjson( gle );
+assert( gle.err , "dup error" );
+assert.eq( 2 , gle.errs.length , "errors from both shards" );
+assert.eq( 602 , db.foo.count() , "continued on error" );
+
+s.stop();
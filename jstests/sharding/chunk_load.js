@@ -0,0 +1,44 @@
+// Shards count the reads and writes of each chunk and report them to the balancer through
+// getChunkLoad, halving the counts on every report.
+
+s = new ShardingTest( "chunk_load" , 2 , 1 , 1 );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+s.adminCommand( { split : "test.foo" , middle : { num : 100 } } );
+
+db = s.getDB( "test" );
+for ( i = 0; i < 200; i++ ) {
+    db.foo.insert( { _id : i , num : i } );
+}
+assert.isnull( db.getLastError() , "insert" );
+
+db.foo.update( { num : 150 } , { $set : { x : 1 } } );
+assert.isnull( db.getLastError() , "update" );
+db.foo.remove( { num : 50 } );
+assert.isnull( db.getLastError() , "remove" );
+assert.eq( 100 , db.foo.find( { num : { $gte : 100 } } ).itcount() , "read" );
+
+primary = s.getServer( "test" );
+function chunkLoads() {
+    res = primary.getDB( "admin" ).runCommand( { getChunkLoad : "test.foo" } );
+    assert( res.ok , tojson( res ) );
+    loads = {};
+    res.chunks.forEach( function( c ) { loads[ tojson( c.min.num ) ] = c; } );
+    return loads;
+}
+
+loads = chunkLoads();
+lower = loads[ tojson( MinKey ) ];
+upper = loads[ tojson( 100 ) ];
+assert.eq( 101 , lower.writes , tojson( loads ) );
+assert.eq( 0 , lower.reads , tojson( loads ) );
+assert.eq( 101 , upper.writes , tojson( loads ) );
+assert.eq( 100 , upper.reads , tojson( loads ) );
+assert.lt( 0 , upper.bytes , tojson( loads ) );
+
+loads = chunkLoads();
+assert.eq( 50 , loads[ tojson( MinKey ) ].writes , tojson( loads ) );
+assert.eq( 50 , loads[ tojson( 100 ) ].reads , tojson( loads ) );
+
+s.stop();
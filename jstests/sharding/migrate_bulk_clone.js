@@ -0,0 +1,42 @@
+// Moving a chunk to a shard without any of the collection clones compressed batches and
+// builds the non-unique secondary indexes in the background after the documents are in, and
+// the result is the same as an incremental migration.  Unique indexes are built up front.
+
+s = new ShardingTest( "migrate_bulk_clone" , 3 , 1 , 1 );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+db.foo.ensureIndex( { a : 1 } );
+db.foo.ensureIndex( { b : 1 } , { unique : true } );
+
+big = new Array( 1000 ).join( "x" );
+for ( i = 0; i < 3000; i++ ) {
+    db.foo.insert( { _id : i , num : i , a : i % 10 , b : i , s : big } );
+}
+assert.isnull( db.getLastError() , "insert" );
+
+s.adminCommand( { split : "test.foo" , middle : { num : 1000 } } );
+s.adminCommand( { split : "test.foo" , middle : { num : 2000 } } );
+
+primary = s.getServer( "test" );
+others = s.config.shards.find( { _id : { $ne : s.getServerName( "test" ) } } ).sort( { _id : 1 } ).toArray();
+
+// the first move lands on a shard without the collection, the second on one that already has some
+assert( s.adminCommand( { movechunk : "test.foo" , find : { num : 1000 } , to : others[ 0 ]._id } ).ok );
+assert( s.adminCommand( { movechunk : "test.foo" , find : { num : 2000 } , to : others[ 0 ]._id } ).ok );
+
+to = new Mongo( others[ 0 ].host ).getDB( "test" );
+assert.eq( 2000 , to.foo.count() , "recipient count" );
+assert.eq( 1000 , primary.getDB( "test" ).foo.count() , "donor count" );
+assert.eq( 3000 , db.foo.count() , "total count" );
+
+indexes = to.system.indexes.find( { ns : "test.foo" } ).toArray();
+assert.eq( 4 , indexes.length , tojson( indexes ) );
+assert.eq( 200 , to.foo.find( { a : 3 } ).hint( { a : 1 } ).itcount() , "secondary index" );
+assert.eq( 1 , to.foo.find( { b : 1500 } ).hint( { b : 1 } ).itcount() , "unique index" );
+assert( to.system.indexes.findOne( { ns : "test.foo" , key : { a : 1 } } ).background , "deferred index" );
+assert( ! to.system.indexes.findOne( { ns : "test.foo" , key : { b : 1 } } ).background , "unique index up front" );
+
+s.stop();
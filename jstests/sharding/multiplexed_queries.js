@@ -0,0 +1,74 @@
+// With --queryConnectionsPerShard the queries of many clients to unsharded collections share a few
+// connections to each shard, and every client still gets its own results.  Queries of sharded
+// collections and writes keep their own connections, so shard versions and getLastError are
+// unaffected.
+
+s = new ShardingTest( { name : "multiplexed_queries" , shards : 2 , mongos : 1 ,
+                        other : { mongosOptions : { queryConnectionsPerShard : 2 } } } );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+for ( i = 0; i < 2000; i++ ) {
+    db.foo.insert( { _id : i , num : i , mod : i % 10 } );
+    db.bar.insert( { _id : i , num : i , mod : i % 10 } );
+}
+assert.isnull( db.getLastError() , "insert" );
+
+s.adminCommand( { split : "test.foo" , middle : { num : 1000 } } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 1000 } , to : s.getOther( s.getServer( "test" ) ).name } );
+
+// interleaved cursors of one client, on the shared connections and across both shards
+a = db.bar.find( { mod : 1 } ).batchSize( 10 );
+b = db.bar.find( { mod : 2 } ).sort( { num : -1 } ).batchSize( 10 );
+c = db.foo.find( { mod : 3 } ).batchSize( 10 );
+na = 0;
+nb = 0;
+nc = 0;
+while ( a.hasNext() || b.hasNext() || c.hasNext() ) {
+    if ( a.hasNext() ) { assert.eq( 1 , a.next().mod ); na++; }
+    if ( b.hasNext() ) { assert.eq( 2 , b.next().mod ); nb++; }
+    if ( c.hasNext() ) { assert.eq( 3 , c.next().mod ); nc++; }
+}
+assert.eq( 200 , na , "interleaved a" );
+assert.eq( 200 , nb , "interleaved b" );
+assert.eq( 200 , nc , "interleaved c" );
+
+// concurrent clients
+joins = [];
+for ( i = 0; i < 4; i++ ) {
+    joins.push( startParallelShell( "for ( j = 0; j < 50; j++ ) {" +
+                                    "    m = j % 10;" +
+                                    "    assert.eq( 200 , db.getSisterDB( 'test' ).bar.find( { mod : m } ).itcount() );" +
+                                    "    assert.eq( 2000 , db.getSisterDB( 'test' ).bar.find().batchSize( 7 ).itcount() );" +
+                                    "    assert.eq( 2000 , db.getSisterDB( 'test' ).foo.find().batchSize( 7 ).itcount() );" +
+                                    "}" ) );
+}
+
+// writes and getLastError in the meantime
+for ( i = 0; i < 100; i++ ) {
+    db.bar.update( { num : i * 20 } , { $inc : { x : 1 } } );
+    gle = db.getLastErrorObj();
+    assert.eq( 1 , gle.n , tojson( gle ) );
+}
+
+// a chunk moving under the sharded collection's queries
+s.adminCommand( { movechunk : "test.foo" , find : { num : 1000 } , to : s.getServer( "test" ).name } );
+
+joins.forEach( function( join ) { join(); } );
+
+assert.eq( 100 , db.bar.find( { x : 1 } ).itcount() , "updated" );
+assert.eq( 2000 , db.foo.find().itcount() , "after move" );
+
+stats = db.adminCommand( "connPoolStats" );
+printjson( stats.multiplexed );
+assert.eq( 2 , stats.multiplexed.connectionsPerHost , tojson( stats ) );
+nhosts = 0;
+for ( host in stats.multiplexed.hosts ) {
+    nhosts++;
+    assert.lte( stats.multiplexed.hosts[ host ].connections , 2 + 4 , tojson( stats.multiplexed ) );
+}
+assert.lt( 0 , nhosts , tojson( stats.multiplexed ) );
+
+s.stop();
@@ -0,0 +1,68 @@
+// Each shard receives only the $in values and $or clauses on the shard key that it can match.
+
+s = new ShardingTest( "narrow_in_or" , 3 , 1 , 1 );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+shards = s.config.shards.find().sort( { _id : 1 } ).toArray();
+for ( i = 1; i < 3; i++ ) {
+    s.adminCommand( { split : "test.foo" , middle : { num : i * 100 } } );
+}
+for ( i = 0; i < 3; i++ ) {
+    s.adminCommand( { movechunk : "test.foo" , find : { num : i * 100 } , to : shards[ i ]._id } );
+}
+
+for ( i = 0; i < 300; i++ ) {
+    db.foo.insert( { num : i , x : i % 10 } );
+}
+assert.isnull( db.getLastError() );
+
+function shardDB( i ) {
+    return s._connections[ i ].getDB( "test" );
+}
+
+function profiledQueries( i ) {
+    return shardDB( i ).system.profile.find( { op : "query" , ns : "test.foo" } ).toArray();
+}
+
+function startProfiling() {
+    for ( var i = 0; i < 3; i++ ) {
+        shardDB( i ).setProfilingLevel( 0 );
+        shardDB( i ).system.profile.drop();
+        shardDB( i ).setProfilingLevel( 2 );
+    }
+}
+
+// $in values 5 and 150 live on shards 0 and 1
+startProfiling();
+assert.eq( 2 , db.foo.find( { num : { $in : [ 5 , 150 ] } } ).itcount() );
+assert.eq( [ 5 ] , profiledQueries( 0 )[ 0 ].query.num.$in );
+assert.eq( [ 150 ] , profiledQueries( 1 )[ 0 ].query.num.$in );
+assert.eq( 0 , profiledQueries( 2 ).length );
+
+// other operators on the key and other fields are kept, as are sort options
+startProfiling();
+arr = db.foo.find( { num : { $in : [ 7 , 8 , 250 , 299 ] , $lt : 290 } , x : { $gte : 0 } } ).sort( { num : -1 } ).toArray();
+assert.eq( [ 250 , 8 , 7 ] , arr.map( function( z ) { return z.num; } ) );
+q = profiledQueries( 2 )[ 0 ].query;
+q = q.query || q.$query || q;
+assert.eq( [ 250 , 299 ] , q.num.$in );
+assert.eq( 290 , q.num.$lt );
+
+// $or clauses
+startProfiling();
+assert.eq( 3 , db.foo.find( { $or : [ { num : 1 } , { num : 201 } , { num : { $gt : 298 } } ] } ).itcount() );
+assert.eq( 1 , profiledQueries( 0 )[ 0 ].query.$or.length );
+assert.eq( 2 , profiledQueries( 2 )[ 0 ].query.$or.length );
+
+// a clause without the shard key goes everywhere
+startProfiling();
+assert.eq( 31 , db.foo.find( { $or : [ { num : 1 } , { x : 3 } ] } ).itcount() );
+for ( i = 0; i < 3; i++ ) {
+    assert.eq( 2 , profiledQueries( i )[ 0 ].query.$or.length );
+}
+
+s.stop();
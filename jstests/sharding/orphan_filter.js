@@ -0,0 +1,40 @@
+// Documents written straight to a shard outside its chunks are filtered out of queries through
+// mongos, both in the first batch and in getMores, and once they are deleted every document is
+// returned again.
+
+s = new ShardingTest( "orphan_filter" , 2 , 1 , 1 );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+for ( i = 0; i < 1000; i++ ) {
+    db.foo.insert( { _id : i , num : i } );
+}
+assert.isnull( db.getLastError() , "insert" );
+
+s.adminCommand( { split : "test.foo" , middle : { num : 500 } } );
+s.adminCommand( { movechunk : "test.foo" , find : { num : 500 } , to : s.getOther( s.getServer( "test" ) ).name } );
+
+assert.eq( 1000 , db.foo.find().itcount() , "before orphans" );
+
+// a cursor open before the orphans show up
+cursor = db.foo.find().batchSize( 10 );
+assert.eq( 10 , cursor.objsLeftInBatch() , "first batch" );
+
+// orphans in the range the primary shard gave away
+primary = s.getServer( "test" ).getDB( "test" );
+for ( i = 0; i < 100; i++ ) {
+    primary.foo.insert( { _id : "orphan" + i , num : 700 + i } );
+}
+assert.isnull( primary.getLastError() , "orphan insert" );
+
+assert.eq( 1000 , cursor.itcount() , "cursor across the orphan writes" );
+assert.eq( 1000 , db.foo.find().batchSize( 7 ).itcount() , "with orphans" );
+assert.eq( 100 , db.foo.find( { num : { $gte : 700 , $lt : 800 } } ).itcount() , "orphan range" );
+
+primary.foo.remove( { _id : /^orphan/ } );
+assert.isnull( primary.getLastError() , "orphan remove" );
+assert.eq( 1000 , db.foo.find().batchSize( 7 ).itcount() , "after orphans" );
+
+s.stop();
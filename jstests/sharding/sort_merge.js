@@ -0,0 +1,49 @@
+// Sorted queries merge the shard cursors in order while later batches are prefetched.
+
+s = new ShardingTest( "sort_merge" , 3 , 1 , 1 );
+s.stopBalancer();
+s.adminCommand( { enablesharding : "test" } );
+s.adminCommand( { shardcollection : "test.foo" , key : { num : 1 } } );
+
+db = s.getDB( "test" );
+
+shards = s.config.shards.find().sort( { _id : 1 } ).toArray();
+for ( i = 1; i < 9; i++ ) {
+    s.adminCommand( { split : "test.foo" , middle : { num : i * 100 } } );
+}
+for ( i = 0; i < 9; i++ ) {
+    s.adminCommand( { movechunk : "test.foo" , find : { num : i * 100 } , to : shards[ i % 3 ]._id } );
+}
+
+// the sort field is spread over every shard, with duplicates
+for ( i = 0; i < 900; i++ ) {
+    db.foo.insert( { num : i , x : ( i * 7 ) % 50 } );
+}
+assert.isnull( db.getLastError() );
+
+function checkSorted( dir , batchSize ) {
+    var arr = db.foo.find().sort( { x : dir , num : 1 } ).batchSize( batchSize ).toArray();
+    assert.eq( 900 , arr.length , "count " + dir + " " + batchSize );
+    for ( var i = 1; i < arr.length; i++ ) {
+        var cmp = dir * ( arr[ i ].x - arr[ i - 1 ].x );
+        assert( cmp > 0 || ( cmp == 0 && arr[ i ].num > arr[ i - 1 ].num ) ,
+                "order " + dir + " " + batchSize + " at " + i );
+    }
+}
+
+checkSorted( 1 , 5 );
+checkSorted( -1 , 5 );
+checkSorted( 1 , 100 );
+checkSorted( -1 , 0 );
+
+// abandon cursors with getMores in flight, the connections must still be usable
+for ( i = 0; i < 10; i++ ) {
+    c = db.foo.find().sort( { x : 1 } ).batchSize( 3 );
+    c.next();
+    c.next();
+    c.close();
+}
+checkSorted( 1 , 7 );
+assert.eq( 900 , db.foo.find().sort( { num : -1 } ).itcount() );
+
+s.stop();
@@ -1,4 +1,5 @@
-// Test that a memory exception is triggered for in memory sorts, but not for indexed sorts.
+// Test that in memory sorts exceeding the memory limit spill to disk, except when they compete with
+// an indexed plan, which then wins.
 
 t = db.jstests_sortg;
 t.drop();
@@ -10,21 +11,28 @@ for( i = 0; i < 100; ++i ) {
 }
 
 for( i = 0; i < 40; ++i ) {
-    t.save( {a:big} );
+    t.save( {a:big, i:i} );
 }
 
+// A single batch can't be followed by results read from disk.
 function memoryException( sortSpec, querySpec ) {
     querySpec = querySpec || {};
     assert.throws( function() {
-                  t.find( querySpec ).sort( sortSpec ).batchSize( 1000 ).itcount()
+                  t.find( querySpec ).sort( sortSpec ).limit( -1000 ).itcount()
                   } );
     assert( db.getLastError().match( /too much data for sort\(\) with no index/ ) );
     assert.throws( function() {
-                  t.find( querySpec ).sort( sortSpec ).batchSize( 1000 ).explain( true )
+                  t.find( querySpec ).sort( sortSpec ).limit( -1000 ).explain( true )
                   } );
     assert( db.getLastError().match( /too much data for sort\(\) with no index/ ) );
 }
 
+function spilled( sortSpec, querySpec, expected ) {
+    querySpec = querySpec || {};
+    assert.eq( expected, t.find( querySpec ).sort( sortSpec ).batchSize( 1000 ).itcount() );
+    assert.eq( expected, t.find( querySpec ).sort( sortSpec ).batchSize( 1000 ).explain( true ).n );
+}
+
 function noMemoryException( sortSpec, querySpec ) {
     querySpec = querySpec || {};
     t.find( querySpec ).sort( sortSpec ).batchSize( 1000 ).itcount();
@@ -38,8 +46,22 @@ function noMemoryException( sortSpec, querySpec ) {
 }
 
 // Unindexed sorts.
+spilled( {a:1}, {}, 140 );
+spilled( {b:1}, {}, 140 );
 memoryException( {a:1} );
-memoryException( {b:1} );
+
+// Spilled results are merged in order.
+c = t.find( {}, {a:0} ).sort( {i:-1} ).batchSize( 1000 );
+for( i = 39; i >= 0; --i ) {
+    assert.eq( i, c.next().i );
+}
+assert.eq( 100, c.itcount() );
+
+// Skip and limit apply to spilled results.
+r = t.find( {}, {a:0} ).sort( {i:-1} ).skip( 2 ).limit( 35 ).toArray();
+assert.eq( 35, r.length );
+assert.eq( 37, r[ 0 ].i );
+assert.eq( 3, r[ 34 ].i );
 
 // Indexed sorts.
 noMemoryException( {_id:1} );
@@ -53,8 +75,8 @@ t.ensureIndex( {c:1} );
 noMemoryException( {a:1} );
 noMemoryException( {b:1} );
 
-// A memory exception is triggered for an unindexed sort involving multiple plans.
-memoryException( {d:1}, {b:null,c:null} );
+// An unindexed sort involving multiple unindexed plans spills too.
+spilled( {d:1}, {b:null,c:null}, 40 );
 
 // With an indexed plan on _id:1 and an unindexed plan on b:1, the indexed plan
 // should succeed even if the unindexed one would exhaust its memory limit.
@@ -203,4 +203,50 @@ if ( db.runCommand( "isMaster" ).msg != "isdbgrid" ) {
 }
 
 
+// -------------------------
+// Case 10: "estimate" mode, where split points are picked from the upper levels of the btree
+//
+
+f.drop();
+f.ensureIndex( { x: 1 } );
+
+// Long keys make for a few keys per bucket, and so a deep tree from a small collection.
+pad = "";
+while( pad.length < 600 ) pad += "b";
+numDocs = 5000;
+for( i=0; i<numDocs; i++ ){
+    f.save( { x: pad + ( 100000 + i ), y: filler } );
+}
+db.getLastError();
+
+exact = db.runCommand( { splitVector: f.getFullName() , keyPattern: {x:1} , maxChunkSize: 1 } );
+res = db.runCommand( { splitVector: f.getFullName() , keyPattern: {x:1} , maxChunkSize: 1 , estimate: true } );
+
+assert.eq( true , res.ok , "10a" );
+assert.eq( true , res.estimated , "10b: " + tojson( res ) );
+assert.close( exact.splitKeys.length , res.splitKeys.length , "10c" , -1 );
+for( i=1; i<res.splitKeys.length; i++ ){
+    assert.lt( res.splitKeys[i-1].x , res.splitKeys[i].x , "10d" );
+}
+assert.eq( 1 , f.find( res.splitKeys[0] ).itcount() , "10e" );
+
+res = db.runCommand( { splitVector: f.getFullName() , keyPattern: {x:1} , force: true , estimate: true } );
+assert.eq( true , res.ok , "10f" );
+assert.eq( 1 , res.splitKeys.length , "10g" );
+assert.close( numDocs / 2 , f.find( { x: { $lt: res.splitKeys[0].x } } ).count() , "10h" , -3 );
+
+// A small index falls back to the exact scan.
+f.drop();
+f.ensureIndex( { x: 1 } );
+f.save( { x: 1 } );
+f.save( { x: 2 } );
+f.save( { x: 3 } );
+db.getLastError();
+
+res = db.runCommand( { splitVector: f.getFullName() , keyPattern: {x:1} , force: true , estimate: true } );
+assert.eq( true , res.ok , "10i" );
+assert.eq( undefined , res.estimated , "10j" );
+assert.eq( 2 , res.splitKeys[0].x , "10k" );
+
+
 print("PASSED");
@@ -7,3 +7,14 @@ t.save( { a : 1 } );
 assert.lt( 0 , t.dataSize() , "A" );
 assert.lt( t.dataSize() , t.storageSize() , "B" );
 assert.lt( 0 , t.totalIndexSize() , "C" );
+
+// compressionSample reports an estimated snappy ratio over the first n records, compressed in blocks
+for ( i = 0; i < 100; i++ )
+    t.save( { a : i , s : "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" } );
+s = db.runCommand( { collstats : t.getName() , compressionSample : 50 } );
+assert.eq( 50 , s.compression.sampledObjects , "D" );
+assert.lt( s.compression.compressedBytes , s.compression.sampledBytes , "E" );
+assert.eq( 1 , s.compression.blocks , "E2" ); // 50 small records fit in one block
+assert.isnull( t.stats().compression , "F" );
+s = db.runCommand( { collstats : t.getName() , compressionSample : 1e12 } );
+assert.eq( t.count() , s.compression.sampledObjects , "G" );
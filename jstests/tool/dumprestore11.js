@@ -0,0 +1,43 @@
+// dumprestore11.js
+// restore with a small --batchSize, including documents that fill or exceed the 8MB batch byte limit
+
+t = new ToolTest( "dumprestore11" );
+
+c = t.startDB( "foo" );
+
+var mb = "x"; while( mb.length < 1024 * 1024 ) mb += mb;
+var threeMb = mb + mb + mb;
+var nineMb = threeMb + threeMb + threeMb;
+
+for( var i = 0; i < 500; i++ )
+    c.save( { _id : i , a : i } );
+// three 3MB documents fill a batch by bytes before it fills by count
+for( var i = 500; i < 503; i++ )
+    c.save( { _id : i , big : threeMb } );
+// one document larger than the whole batch byte limit, between small ones
+c.save( { _id : 503 , big : nineMb } );
+for( var i = 504; i < 1005; i++ )
+    c.save( { _id : i , a : i } );
+assert.eq( 1005 , c.count() , "setup" );
+assert( !c.getDB().getLastError() , "setup error" );
+
+t.runTool( "dump" , "--out" , t.ext );
+
+function check( batchSize ) {
+    c.drop();
+    assert.eq( 0 , c.count() , "after drop, batchSize " + batchSize );
+
+    t.runTool( "restore" , "--dir" , t.ext , "--batchSize" , "" + batchSize );
+
+    assert.eq( 1005 , c.count() , "count, batchSize " + batchSize );
+    assert.eq( 1001 , c.find( { a : { $exists : true } } ).itcount() , "small docs, batchSize " + batchSize );
+    assert.eq( 3 , c.find( { _id : { $gte : 500 , $lt : 503 } , big : threeMb } ).itcount() ,
+               "3MB docs, batchSize " + batchSize );
+    assert.eq( nineMb.length , c.findOne( { _id : 503 } ).big.length , "9MB doc, batchSize " + batchSize );
+    assert.eq( 1004 , c.findOne( { _id : 1004 } ).a , "last doc, batchSize " + batchSize );
+}
+
+check( 7 );
+check( 1 );
+
+t.stop();
@@ -0,0 +1,48 @@
+// Appending to an array at the end of a document uses the record's padding in place.
+
+t = db.jstests_update_inplace_append;
+t.drop();
+
+db.createCollection( t.getName() );
+assert.commandWorked( db.runCommand( { collMod:t.getName(), usePowerOf2Sizes:true } ) );
+
+function diskLoc() {
+    return t.find()._addSpecial( "$showDiskLoc", true ).next()[ '$diskLoc' ];
+}
+
+function checkInPlace( modifier, expected ) {
+    loc = diskLoc();
+    t.update( {}, modifier );
+    assert( !db.getLastError() );
+    assert.eq( expected, t.findOne( {}, { _id:0 } ) );
+    assert.eq( loc, diskLoc(), tojson( modifier ) );
+}
+
+// The document fits a 128 byte record with room to spare.
+t.save( { _id:0, pad:'xxxxx', a:[ 1 ] } );
+checkInPlace( { $push:{ a:2 } }, { pad:'xxxxx', a:[ 1, 2 ] } );
+checkInPlace( { $pushAll:{ a:[ 3, 4 ] } }, { pad:'xxxxx', a:[ 1, 2, 3, 4 ] } );
+checkInPlace( { $addToSet:{ a:{ $each:[ 4, 5, 5 ] } } },
+              { pad:'xxxxx', a:[ 1, 2, 3, 4, 5 ] } );
+checkInPlace( { $addToSet:{ a:6 }, $set:{ pad:'yyyyy' } },
+              { pad:'yyyyy', a:[ 1, 2, 3, 4, 5, 6 ] } );
+
+// Filling the record moves the document.
+t.update( {}, { $pushAll:{ a:[ 7, 8, 9, 10, 11, 12, 13, 14 ] } } );
+assert.eq( [ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 ], t.findOne().a );
+
+// Nested arrays at the end of the document.
+t.remove();
+t.save( { _id:0, b:{ c:1, a:[ 'x' ] } } );
+checkInPlace( { $push:{ 'b.a':'y' } }, { b:{ c:1, a:[ 'x', 'y' ] } } );
+
+// An array followed by other fields is rebuilt, with the same result.
+t.remove();
+t.save( { _id:0, a:[ 1 ], z:1 } );
+t.update( {}, { $push:{ a:2 } } );
+assert.eq( { a:[ 1, 2 ], z:1 }, t.findOne( {}, { _id:0 } ) );
+
+// A double increment of a long rewrites it as a double in place.
+t.remove();
+t.save( { _id:0, a:NumberLong( 2 ) } );
+checkInPlace( { $inc:{ a:0.5 } }, { a:2.5 } );
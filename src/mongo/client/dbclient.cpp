@@ -643,6 +643,8 @@ namespace mongo {
         // requires that?
         server.reset(new SockAddr(_server.host().c_str(), _server.port()));
         p.reset(new MessagingPort( _so_timeout, _logLevel ));
+        // replies still due on the old socket will never come
+        _clearReplies();
 
         if (_server.host().empty() || server->getAddr() == "0.0.0.0") {
             stringstream s;
@@ -1026,6 +1028,9 @@ namespace mongo {
             _failed = true;
             throw;
         }
+        int op = toSend.operation();
+        if ( op == dbQuery || op == dbGetMore )
+            _lazyRequests.push_back( toSend.header()->id );
     }
 
     void DBClientConnection::sayPiggyBack( Message &toSend ) {
@@ -1033,7 +1038,108 @@ namespace mongo {
     }
 
     bool DBClientConnection::recv( Message &m ) {
-        return port().recv(m);
+        if ( _lazyRequests.empty() ) {
+            // the next reply of an exhaust cursor, which answers the previous reply
+            return port().recv(m);
+        }
+        return recvReply( m , _lazyRequests.front() );
+    }
+
+    bool DBClientConnection::recvReply( Message& m , MSGID requestId ) {
+        deque<unsigned>::iterator i = find( _lazyRequests.begin() , _lazyRequests.end() , (unsigned)requestId );
+        if ( i != _lazyRequests.end() )
+            _lazyRequests.erase( i );
+
+        try {
+            if ( _recvReply( requestId , m ) )
+                return true;
+        }
+        catch( SocketException & ) {
+            _failed = true;
+            throw;
+        }
+        _failed = true;
+        return false;
+    }
+
+    bool DBClientConnection::_recvReply( MSGID requestId , Message& response ) {
+        map<unsigned,Message*>::iterator i = _replies.find( requestId );
+        if ( i != _replies.end() ) {
+            auto_ptr<Message> m( i->second );
+            _replies.erase( i );
+            response = *m;
+            return true;
+        }
+
+        while ( true ) {
+            auto_ptr<Message> m( new Message() );
+            if ( ! port().recv( *m ) )
+                return false;
+
+            unsigned responseTo = m->header()->responseTo;
+            if ( responseTo == requestId ) {
+                response = *m;
+                return true;
+            }
+            if ( _abandonedReplies.erase( responseTo ) )
+                continue;
+            bool duplicate = _replies.count( responseTo ) != 0;
+            if ( duplicate ) {
+                // replies can no longer be matched to requests, so the stream is useless
+                _failed = true;
+            }
+            massert( 16337 , str::stream() << "dbclient got a second reply to request " << responseTo
+                             << " from " << getServerAddress() , ! duplicate );
+            _replies[responseTo] = m.release();
+        }
+    }
+
+    void DBClientConnection::_abandonReply( MSGID requestId ) {
+        deque<unsigned>::iterator i = find( _lazyRequests.begin() , _lazyRequests.end() , (unsigned)requestId );
+        if ( i != _lazyRequests.end() )
+            _lazyRequests.erase( i );
+
+        map<unsigned,Message*>::iterator j = _replies.find( requestId );
+        if ( j != _replies.end() ) {
+            delete j->second;
+            _replies.erase( j );
+            return;
+        }
+        _abandonedReplies.insert( requestId );
+    }
+
+    void DBClientConnection::_clearReplies() {
+        for ( map<unsigned,Message*>::iterator i = _replies.begin(); i != _replies.end(); ++i )
+            delete i->second;
+        _replies.clear();
+        _abandonedReplies.clear();
+        _lazyRequests.clear();
+    }
+
+    auto_ptr<DBClientConnection::ReplyFuture> DBClientConnection::callAsync( Message& toSend ) {
+        int op = toSend.operation();
+        massert( 16330 , "only queries and getMores can be sent with callAsync" , op == dbQuery || op == dbGetMore );
+
+        say( toSend );
+        // the future, not recv(), collects the reply
+        _lazyRequests.pop_back();
+        return auto_ptr<ReplyFuture>( new ReplyFuture( this , toSend.header()->id ) );
+    }
+
+    DBClientConnection::ReplyFuture::~ReplyFuture() {
+        if ( ! _taken )
+            _conn->_abandonReply( _id );
+    }
+
+    bool DBClientConnection::ReplyFuture::ready() const {
+        return _taken || _conn->_replies.count( _id ) > 0;
+    }
+
+    void DBClientConnection::ReplyFuture::get( Message& response ) {
+        verify( ! _taken );
+        _taken = true;
+        if ( ! _conn->recvReply( response , _id ) )
+            uasserted( 10278 , str::stream() << "dbclient error communicating with server: " << _conn->getServerAddress() );
     }
 
     bool DBClientConnection::call( Message &toSend, Message &response, bool assertOk , string * actualServer ) {
@@ -1043,7 +1149,9 @@ namespace mongo {
         */
         checkConnection();
         try {
-            if ( !port().call(toSend, response) ) {
+            port().say( toSend );
+            // replies to lazy requests still in flight are kept for them
+            if ( !_recvReply( toSend.header()->id , response ) ) {
                 _failed = true;
                 if ( assertOk )
                     uasserted( 10278 , str::stream() << "dbclient error communicating with server: " << getServerAddress() );
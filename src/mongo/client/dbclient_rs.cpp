@@ -1049,6 +1049,19 @@ namespace mongo {
         }
     }
 
+    bool DBClientReplicaSet::recvReply( Message& m , MSGID requestId ) {
+
+        verify( _lazyState._lastClient );
+
+        try {
+            return _lazyState._lastClient->recvReply( m , requestId );
+        }
+        catch( DBException& e ){
+            log() << "could not receive data from " << _lazyState._lastClient << causedBy( e ) << endl;
+            return false;
+        }
+    }
+
     void DBClientReplicaSet::checkResponse( const char* data, int nReturned, bool* retry, string* targetHost ){
 
         // For now, do exactly as we did before, so as not to break things.  In general though, we
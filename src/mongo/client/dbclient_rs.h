@@ -322,6 +322,7 @@ namespace mongo {
 
         virtual void say( Message &toSend, bool isRetry = false , string* actualServer = 0);
         virtual bool recv( Message &toRecv );
+        virtual bool recvReply( Message &toRecv , MSGID requestId );
         virtual void checkResponse( const char* data, int nReturned, bool* retry = NULL, string* targetHost = NULL );
 
         /* this is the callback from our underlying connections to notify us that we got a "not master" error.
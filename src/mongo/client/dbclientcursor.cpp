@@ -32,6 +32,9 @@ namespace mongo {
 
     void DBClientCursor::_finishConsInit() {
         _originalHost = _client->toString();
+        _prefetching = false;
+        _lazyId = 0;
+        _prefetchId = 0;
     }
 
     int DBClientCursor::nextBatchSize() {
@@ -82,11 +85,12 @@ namespace mongo {
         Message toSend;
         _assembleInit( toSend );
         _client->say( toSend, isRetry, &_originalHost );
+        _lazyId = toSend.header()->id;
     }
 
     bool DBClientCursor::initLazyFinish( bool& retry ) {
 
-        bool recvd = _client->recv( *batch.m );
+        bool recvd = _client->recvReply( *batch.m , _lazyId );
 
         // If we get a bad response, return false
         if ( ! recvd || batch.m->empty() ) {
@@ -116,9 +120,7 @@ namespace mongo {
         return ok;
     }
 
-    void DBClientCursor::requestMore() {
-        verify( cursorId && batch.pos == batch.nReturned );
-
+    void DBClientCursor::_assembleGetMore( Message& toSend ) {
         if (haveLimit) {
             nToReturn -= batch.nReturned;
             verify(nToReturn > 0);
@@ -129,12 +131,25 @@ namespace mongo {
         b.appendNum(nextBatchSize());
         b.appendNum(cursorId);
 
-        Message toSend;
         toSend.setData(dbGetMore, b.buf(), b.len());
-        auto_ptr<Message> response(new Message());
+    }
+
+    void DBClientCursor::requestMore() {
+        verify( cursorId && batch.pos == batch.nReturned );
+
+        if ( _prefetching )
+            finishPrefetch();
+
+        // the getMore may already have been answered, see prefetchMore()
+        bool haveResponse = _prefetched.get();
+        Message toSend;
+        auto_ptr<Message> response( haveResponse ? _prefetched.release() : new Message() );
+        if ( ! haveResponse )
+            _assembleGetMore( toSend );
 
         if ( _client ) {
-            _client->call( toSend, *response );
+            if ( ! haveResponse )
+                _client->call( toSend, *response );
             this->batch.m = response;
             dataReceived();
         }
@@ -142,7 +157,8 @@ namespace mongo {
             verify( _scopedHost.size() );
             scoped_ptr<ScopedDbConnection> conn(
                     ScopedDbConnection::getScopedDbConnection( _scopedHost ) );
-            conn->get()->call( toSend , *response );
+            if ( ! haveResponse )
+                conn->get()->call( toSend , *response );
             _client = conn->get();
             this->batch.m = response;
             dataReceived();
@@ -151,6 +167,33 @@ namespace mongo {
         }
     }
 
+    void DBClientCursor::prefetchMore() {
+        if ( _prefetching || _prefetched.get() || ! cursorId || ! _client || haveLimit )
+            return;
+        if ( opts & ( QueryOption_CursorTailable | QueryOption_Exhaust ) )
+            return;
+        if ( ! _client->lazySupported() )
+            return;
+
+        Message toSend;
+        _assembleGetMore( toSend );
+        _client->say( toSend );
+        _prefetchId = toSend.header()->id;
+        _prefetching = true;
+    }
+
+    void DBClientCursor::finishPrefetch() {
+        if ( ! _prefetching )
+            return;
+        verify( _client );
+        _prefetching = false;
+
+        auto_ptr<Message> response( new Message() );
+        massert( 16326, "DBClientCursor prefetched getMore failed",
+                 _client->recvReply( *response , _prefetchId ) && ! response->empty() );
+        _prefetched = response;
+    }
+
     /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
     void DBClientCursor::exhaustReceiveMore() {
         verify( cursorId && batch.pos == batch.nReturned );
@@ -303,6 +346,7 @@ namespace mongo {
             _scopedHost = conn->getHost();
         }
 
+        finishPrefetch();
         conn->done();
         _client = 0;
         _lazyHost = "";
@@ -314,6 +358,9 @@ namespace mongo {
 
         DESTRUCTOR_GUARD (
 
+        // don't leave an unread reply on the connection
+        finishPrefetch();
+
         if ( cursorId && _ownCursor && ! inShutdown() ) {
             BufBuilder b;
             b.appendNum( (int)0 ); // reserved
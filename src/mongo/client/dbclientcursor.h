@@ -188,6 +188,19 @@ namespace mongo {
         void initLazy( bool isRetry = false );
         bool initLazyFinish( bool& retry );
 
+        /**
+         * Sends the getMore for the next batch now, so the server builds it while the current
+         * batch is consumed; more() then only has to read the reply.  A no-op unless the cursor
+         * has its own lazy-capable connection, and for tailable, exhaust and limited cursors.
+         * Connections that match replies by id, like DBClientConnection, may meanwhile be used
+         * for other requests, including the prefetches of other cursors; with any other the
+         * connection must not be used for anything else until the reply is read.
+         */
+        void prefetchMore();
+
+        /** reads the reply to a getMore sent by prefetchMore(), if any, freeing the connection */
+        void finishPrefetch();
+
         class Batch : boost::noncopyable { 
             friend class DBClientCursor;
             auto_ptr<Message> m;
@@ -223,6 +236,10 @@ namespace mongo {
         string _scopedHost;
         string _lazyHost;
         bool wasError;
+        MSGID _lazyId; // request id of the query sent by initLazy()
+        bool _prefetching; // a getMore has been sent and its reply not yet read
+        MSGID _prefetchId;
+        auto_ptr<Message> _prefetched; // reply to a prefetched getMore, not yet consumed
 
         void dataReceived() { bool retry; string lazyHost; dataReceived( retry, lazyHost ); }
         void dataReceived( bool& retry, string& lazyHost );
@@ -238,6 +255,7 @@ namespace mongo {
 
         // init pieces
         void _assembleInit( Message& toSend );
+        void _assembleGetMore( Message& toSend );
     };
 
     /** iterate over objects in current batch only - will not cause a network call
@@ -22,6 +22,8 @@
 
 #include "pch.h"
 
+#include <deque>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/client/authlevel.h"
 #include "mongo/util/net/message.h"
@@ -433,6 +435,12 @@ namespace mongo {
         virtual void sayPiggyBack( Message &toSend ) = 0;
         /* used by QueryOption_Exhaust.  To use that your subclass must implement this. */
         virtual bool recv( Message& m ) { verify(false); return false; }
+        /**
+         * Reads the reply to requestId, a request sent with say().  Connectors that match replies
+         * by id keep the replies to other requests for later, so several may be in flight; the
+         * default suits those with one lazy request at a time.
+         */
+        virtual bool recvReply( Message& m , MSGID requestId ) { return recv( m ); }
         // In general, for lazy queries, we'll need to say, recv, then checkResponse
         virtual void checkResponse( const char* data, int nReturned, bool* retry = NULL, string* targetHost = NULL ) {
             if( retry ) *retry = false; if( targetHost ) *targetHost = "";
@@ -917,11 +925,42 @@ namespace mongo {
     /**
         A basic connection to the database.
         This is the main entry point for talking to a simple Mongo setup
+
+        Requests are pipelined: replies are matched to requests by id, so any number of queries
+        and getMores sent with say() or callAsync() may be in flight at once, and their replies
+        taken in any order, interleaved with call().  Like the rest of the class this is not
+        thread safe.
     */
     class DBClientConnection : public DBClientBase {
     public:
         using DBClientBase::query;
 
+        /**
+         * The reply to a request sent with callAsync().  The reply is read off the socket by get(),
+         * or earlier by whatever other reply the connection waits for.  A future destroyed
+         * before get() drops its reply when it arrives.  Must not outlive its connection.
+         */
+        class ReplyFuture : boost::noncopyable {
+        public:
+            ~ReplyFuture();
+
+            MSGID requestId() const { return _id; }
+
+            /** @return true if the reply has been read, so get() won't block */
+            bool ready() const;
+
+            /** waits for the reply; throws like call() if the connection fails.  Call once. */
+            void get( Message& response );
+
+        private:
+            friend class DBClientConnection;
+            ReplyFuture( DBClientConnection* conn , MSGID id ) : _conn( conn ) , _id( id ) , _taken( false ) {}
+
+            DBClientConnection* _conn;
+            MSGID _id;
+            bool _taken;
+        };
+
         /**
            @param _autoReconnect if true, automatically reconnect on a connection failure
            @param cp used by DBClientReplicaSet.  You do not need to specify this parameter
@@ -934,6 +973,7 @@ namespace mongo {
         }
 
         virtual ~DBClientConnection() {
+            _clearReplies();
             _numConnections--;
         }
 
@@ -1019,8 +1059,13 @@ namespace mongo {
         virtual bool callRead( Message& toSend , Message& response ) { return call( toSend , response ); }
         virtual void say( Message &toSend, bool isRetry = false , string * actualServer = 0 );
         virtual bool recv( Message& m );
+        virtual bool recvReply( Message& m , MSGID requestId );
         virtual void checkResponse( const char *data, int nReturned, bool* retry = NULL, string* host = NULL );
         virtual bool call( Message &toSend, Message &response, bool assertOk = true , string * actualServer = 0 );
+
+        /** sends toSend, a query or getMore, without waiting for the reply */
+        auto_ptr<ReplyFuture> callAsync( Message& toSend );
+
         virtual ConnectionString::ConnectionType type() const { return ConnectionString::MASTER; }
         void setSoTimeout(double to) { _so_timeout = to; }
         double getSoTimeout() const { return _so_timeout; }
@@ -1062,6 +1107,16 @@ namespace mongo {
         static SSLManager* sslManager();
         static SSLManager* _sslManager;
 #endif
+
+    private:
+        /** reads until the reply to requestId, keeping the others; false on a socket error */
+        bool _recvReply( MSGID requestId , Message& response );
+        void _abandonReply( MSGID requestId );
+        void _clearReplies();
+
+        map<unsigned,Message*> _replies; // read while waiting for another reply
+        set<unsigned> _abandonedReplies;
+        deque<unsigned> _lazyRequests; // sent with say(), answered in this order by recv()
     };
 
     /** pings server to check if it's up
@@ -31,6 +31,16 @@
 using namespace std;
 using namespace mongo;
 
+static void makeQuery( Message& toSend , const string& ns , const BSONObj& query ) {
+    BufBuilder b;
+    b.appendNum( 0 ); // options
+    b.appendStr( ns );
+    b.appendNum( 0 ); // nToSkip
+    b.appendNum( 1 ); // nToReturn
+    query.appendSelfToBufBuilder( b );
+    toSend.setData( dbQuery , b.buf() , b.len() );
+}
+
 int main( int argc, const char **argv ) {
 
     const char *port = "27017";
@@ -248,6 +258,58 @@ int main( int argc, const char **argv ) {
         //MONGO_PRINT(out);
     }
 
+    {
+        // pipelined requests: replies are matched to requests, whatever order they are read in
+        const string ns = "test.pipeline";
+        conn.dropCollection( ns );
+        for ( int i = 0; i < 1000; i++ )
+            conn.insert( ns , BSON( "_id" << i << "x" << i % 2 ) );
+
+        auto_ptr<DBClientCursor> a = conn.query( ns , QUERY( "x" << 0 ) , 0 , 0 , 0 , 0 , 10 );
+        auto_ptr<DBClientCursor> b = conn.query( ns , QUERY( "x" << 1 ) , 0 , 0 , 0 , 0 , 10 );
+        int na = 0;
+        int nb = 0;
+        while ( a->more() || b->more() ) {
+            a->prefetchMore();
+            b->prefetchMore();
+            // a plain call while both getMores are in flight
+            verify( conn.count( ns ) == 1000 );
+            if ( b->more() ) {
+                verify( b->next()["x"].numberInt() == 1 );
+                nb++;
+            }
+            if ( a->more() ) {
+                verify( a->next()["x"].numberInt() == 0 );
+                na++;
+            }
+        }
+        verify( na == 500 );
+        verify( nb == 500 );
+
+        Message q1, q2, q3;
+        makeQuery( q1 , ns , BSON( "_id" << 1 ) );
+        makeQuery( q2 , ns , BSON( "_id" << 2 ) );
+        makeQuery( q3 , ns , BSON( "_id" << 3 ) );
+        auto_ptr<DBClientConnection::ReplyFuture> f1 = conn.callAsync( q1 );
+        auto_ptr<DBClientConnection::ReplyFuture> f2 = conn.callAsync( q2 );
+        {
+            // never collected, its reply is dropped
+            auto_ptr<DBClientConnection::ReplyFuture> f3 = conn.callAsync( q3 );
+        }
+        verify( ! f1->ready() );
+
+        Message r2;
+        f2->get( r2 );
+        verify( (unsigned)r2.header()->responseTo == (unsigned)f2->requestId() );
+        // read on the way to the reply for f2
+        verify( f1->ready() );
+        Message r1;
+        f1->get( r1 );
+        verify( (unsigned)r1.header()->responseTo == (unsigned)f1->requestId() );
+
+        verify( conn.findOne( ns , QUERY( "_id" << 7 ) )["x"].numberInt() == 1 );
+    }
+
     { 
         // test timeouts
 
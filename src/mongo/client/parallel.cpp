@@ -463,6 +463,7 @@ namespace mongo {
         _numServers = _servers.size();
         _lastFrom = 0;
         _cursors = 0;
+        _heapInit = false;
 
         if( ! _qSpec.isEmpty() ){
 
@@ -527,6 +528,17 @@ namespace mongo {
 
         if( ! retryNext && pcState ){
 
+            if( pcState->cursor && pcState->conn && pcState->conn->ok() ){
+                try {
+                    // Read any prefetched batch, so the conn is not returned with a reply pending
+                    pcState->cursor->finishPrefetch();
+                }
+                catch( std::exception& ){
+                    warning() << "exception reading prefetched batch" << endl;
+                    errored = true;
+                }
+            }
+
             if( errored && pcState->conn ){
                 // Don't return this conn to the pool if it's bad
                 pcState->conn->kill();
@@ -681,6 +693,20 @@ namespace mongo {
 
     }
 
+    /** @return query, which may wrap its filter in $query, with the filter replaced */
+    static BSONObj _replaceFilter( const BSONObj& query, const BSONObj& filter ) {
+        bool hasDollar;
+        if( ! Query( query ).isComplex( &hasDollar ) ) return filter;
+
+        const char* name = hasDollar ? "$query" : "query";
+        BSONObjBuilder b;
+        BSONForEach( e, query ){
+            if( str::equals( e.fieldName(), name ) ) b.append( name, filter );
+            else b.append( e );
+        }
+        return b.obj();
+    }
+
     void ParallelSortClusteredCursor::startInit() {
 
         bool returnPartial = ( _qSpec.options() & QueryOption_PartialResults );
@@ -733,6 +759,10 @@ namespace mongo {
 
         verify( todo.size() );
 
+        // Send each shard only the $in values and $or clauses it can match
+        map<Shard,BSONObj> narrowed;
+        if( manager && ! specialFilter && ! isCommand() ) manager->narrowQueryForShards( _qSpec.filter(), todo, narrowed );
+
         log( pc ) << "initializing over " << todo.size() << " shards required by " << vinfo << endl;
 
         // Don't retry indefinitely for whatever reason
@@ -798,8 +828,13 @@ namespace mongo {
 
                 verify( ! primary || shard == *primary || ! isVersioned() );
 
-                // Setup conn
-                if( ! state->conn ) state->conn.reset( new ShardConnection( shard, ns, manager ) );
+                // Setup conn.  Plain queries of unsharded collections may share a socket with other
+                // clients; slaveOk queries need the replica set connection to reach secondaries,
+                // commands may write, and tailable and exhaust queries hold the socket's replies up
+                bool queryOnly = ! isCommand() &&
+                    ! ( _qSpec.options() & ( QueryOption_SlaveOk | QueryOption_CursorTailable |
+                                             QueryOption_AwaitData | QueryOption_Exhaust ) );
+                if( ! state->conn ) state->conn.reset( new ShardConnection( shard, ns, manager, queryOnly ) );
 
                 if( state->conn->setVersion() ){
                     // It's actually okay if we set the version here, since either the manager will be verified as
@@ -816,7 +851,11 @@ namespace mongo {
                     // or if the number of shards to query is > 1
                     if( ( isVersioned() && ! primary ) || _qShards.size() > 1 ){
 
-                        state->cursor.reset( new DBClientCursor( state->conn->get(), ns, _qSpec.query(),
+                        map<Shard,BSONObj>::const_iterator n = narrowed.find( shard );
+                        BSONObj query = n == narrowed.end() ? _qSpec.query() : _replaceFilter( _qSpec.query(), n->second );
+                        if( n != narrowed.end() ) log( pc ) << "narrowed query for shard " << shard << " to " << n->second << endl;
+
+                        state->cursor.reset( new DBClientCursor( state->conn->get(), ns, query,
                                                                  isCommand() ? 1 : 0, // nToReturn (0 if query indicates multi)
                                                                  0, // nToSkip
                                                                  // Does this need to be a ptr?
@@ -1464,6 +1503,11 @@ namespace mongo {
             _needToSkip = n;
         }
 
+        if ( ! _sortKey.isEmpty() ) {
+            _initHeap();
+            return ! _heap.empty();
+        }
+
         for ( int i=0; i<_numServers; i++ ) {
             if ( _cursors[i].more() )
                 return true;
@@ -1471,7 +1515,61 @@ namespace mongo {
         return false;
     }
 
+    bool ParallelSortClusteredCursor::CursorHeapCmp::operator()( int a, int b ) const {
+        // std heaps keep the greatest element on top, so order by descending next document
+        int comp = _cursors[a].peek().woSortOrder( _cursors[b].peek() , _sortKey , true );
+        if ( comp != 0 )
+            return comp > 0;
+        return a > b;
+    }
+
+    void ParallelSortClusteredCursor::_initHeap() {
+        if ( _heapInit )
+            return;
+        _heapInit = true;
+
+        for ( int i = 0; i < _numServers; i++ ) {
+            if ( _cursors[i].more() ) {
+                _cursors[i].prefetch();
+                _heap.push_back( i );
+            }
+            else if( _cursors[i].rawMData() ) {
+                _cursors[i].rawMData()->pcState->done = true;
+            }
+        }
+        make_heap( _heap.begin(), _heap.end(), CursorHeapCmp( _cursors, _sortKey ) );
+    }
+
     BSONObj ParallelSortClusteredCursor::next() {
+        if ( ! _sortKey.isEmpty() ) {
+            // k-way merge, each step costs log( number of cursors ) comparisons
+            _initHeap();
+            uassert( 10019 ,  "no more elements" , ! _heap.empty() );
+
+            CursorHeapCmp cmp( _cursors, _sortKey );
+            pop_heap( _heap.begin(), _heap.end(), cmp );
+            int from = _heap.back();
+            _heap.pop_back();
+
+            BSONObj best = _cursors[from].next();
+
+            if( _cursors[from].rawMData() )
+                _cursors[from].rawMData()->pcState->count++;
+
+            if ( _cursors[from].more() ) {
+                // keep the shard working on its next batch while this one is merged
+                _cursors[from].prefetch();
+                _heap.push_back( from );
+                push_heap( _heap.begin(), _heap.end(), cmp );
+            }
+            else if( _cursors[from].rawMData() ) {
+                _cursors[from].rawMData()->pcState->done = true;
+            }
+
+            _lastFrom = from;
+            return best;
+        }
+
         BSONObj best = BSONObj();
         int bestFrom = -1;
 
@@ -1488,27 +1586,16 @@ namespace mongo {
                 continue;
             }
 
-            BSONObj me = _cursors[i].peek();
-
-            if ( best.isEmpty() ) {
-                best = me;
-                bestFrom = i;
-                if( _sortKey.isEmpty() ) break;
-                continue;
-            }
-
-            int comp = best.woSortOrder( me , _sortKey , true );
-            if ( comp < 0 )
-                continue;
-
-            best = me;
+            best = _cursors[i].peek();
             bestFrom = i;
+            break;
         }
 
         _lastFrom = bestFrom;
 
         uassert( 10019 ,  "no more elements" , ! best.isEmpty() );
         _cursors[bestFrom].next();
+        _cursors[bestFrom].prefetch();
 
         if( _cursors[bestFrom].rawMData() )
             _cursors[bestFrom].rawMData()->pcState->count++;
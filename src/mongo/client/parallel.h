@@ -136,6 +136,9 @@ namespace mongo {
 
         BSONObj peek();
 
+        /** asks the server for the next batch ahead of need, see DBClientCursor::prefetchMore() */
+        void prefetch() { if ( _cursor.get() && ! _done ) _cursor->prefetchMore(); }
+
         DBClientCursor* raw() { return _cursor.get(); }
         ParallelConnectionMetadata* rawMData(){ return _pcmData; }
 
@@ -395,6 +398,24 @@ namespace mongo {
 
         FilteringClientCursor * _cursors;
         int _needToSkip;
+
+        /** orders cursor indexes so the one with the smallest next document is on top */
+        class CursorHeapCmp {
+        public:
+            CursorHeapCmp( FilteringClientCursor* cursors, const BSONObj& sortKey )
+                : _cursors( cursors ), _sortKey( sortKey ) { }
+            bool operator()( int a, int b ) const;
+        private:
+            FilteringClientCursor* _cursors;
+            BSONObj _sortKey;
+        };
+
+        void _initHeap();
+
+        // for sorted merges, indexes of the cursors with more results, as a heap on their next
+        // document.  Built on first use.
+        vector<int> _heap;
+        bool _heapInit;
     };
 
     /**
@@ -1108,6 +1108,23 @@ namespace mongo {
         
         virtual long long nscanned() { return _nscanned; }
 
+        /**
+         * Moves forward over the keys that follow the current key within its bucket, have no child
+         * bucket before them, and are equal to the current key, stopping on the last used one.
+         * Lets exact key matches be counted a bucket at a time: only the last candidate key is
+         * compared, since keys in between sort between two equal keys.
+         * @return the number of used keys moved over.
+         */
+        virtual long long skipEqualKeysInBucket() = 0;
+
+        /**
+         * Seeks to the first key, in the cursor's direction, whose first field differs from that
+         * of the current key, without visiting the keys in between.  Used to iterate the distinct
+         * values of an index's leading field.
+         * @return ok()
+         */
+        bool advancePastKeyPrefix();
+
         /** for debugging only */
         const DiskLoc getBucket() const { return bucket; }
         int getKeyOfs() const { return keyOfs; }
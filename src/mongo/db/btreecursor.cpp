@@ -70,10 +70,39 @@ namespace mongo {
             return bucket.btree<V>()->keyNode(keyOfs).key.toBson();
         }
 
+        virtual void hydrateCurrKey( const Projection::KeyOnly &keyOnly, BSONObjBuilder &b ) const {
+            verify( !bucket.isNull() );
+            keyOnly.hydrate( bucket.btree<V>()->keyNode(keyOfs).key, b );
+        }
+
         virtual bool curKeyHasChild() { 
             return !currKeyNode().prevChildBucket.isNull();
         }
 
+        virtual long long skipEqualKeysInBucket() {
+            if ( bucket.isNull() || _direction != 1 )
+                return 0;
+            const BtreeBucket<V> *b = bucket.btree<V>();
+            int n = b->getN();
+            // Keys up to the first one with a child before it are iterated consecutively.
+            int end = keyOfs + 1;
+            while( end < n && b->keyNode( end ).prevChildBucket.isNull() )
+                ++end;
+            if ( end - 1 == keyOfs || !b->keyNode( end - 1 ).key.woEqual( b->keyNode( keyOfs ).key ) )
+                return 0;
+            long long skipped = 0;
+            int lastUsed = keyOfs;
+            for( int i = keyOfs + 1; i < end; ++i ) {
+                if ( b->k( i ).isUsed() ) {
+                    ++skipped;
+                    lastUsed = i;
+                }
+            }
+            keyOfs = lastUsed;
+            _nscanned += skipped;
+            return skipped;
+        }
+
         bool skipUnusedKeys() {
             int u = 0;
             while ( 1 ) {
@@ -374,6 +403,32 @@ namespace mongo {
         return ok();
     }
 
+    bool BtreeCursor::advancePastKeyPrefix() {
+        killCurrentOp.checkForInterrupt();
+        if ( bucket.isNull() )
+            return false;
+
+        // With afterKey set only the first field of keyBegin is compared, but customBSONCmp
+        // steps through one keyEnd entry per compared field.
+        BSONObj prefix = currKey().getOwned();
+        BSONElement first = prefix.firstElement();
+        vector< const BSONElement * > keyEnd( 1, &first );
+        vector< bool > keyEndInclusive( 1, true );
+        advanceTo( prefix, 1, true, keyEnd, keyEndInclusive );
+
+        if ( !_independentFieldRanges ) {
+            skipUnusedKeys();
+            checkEnd();
+            if ( ok() ) {
+                ++_nscanned;
+            }
+        }
+        else {
+            skipAndCheck();
+        }
+        return ok();
+    }
+
     void BtreeCursor::noteLocation() {
         if ( !eof() ) {
             BSONObj o = currKey().getOwned();
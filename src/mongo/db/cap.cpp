@@ -48,6 +48,13 @@
 
 namespace mongo {
 
+    /* counts capped allocations so tailable cursors with QueryOption_AwaitData can block
+       instead of sleeping and polling.  see waitForCappedInsert().
+    */
+    static mongo::mutex cappedInsertMutex( "cappedInsert" );
+    static boost::condition cappedInsertNotifier;
+    static unsigned long long cappedInserts = 0;
+
     /* combine adjacent deleted records *for the current extent* of the capped collection
 
        this is O(n^2) but we call it for capped tables where typically n==1 or 2!
@@ -263,9 +270,29 @@ namespace mongo {
         if ( capFirstNewRecord.isValid() && capFirstNewRecord.isNull() )
             getDur().writingDiskLoc(capFirstNewRecord) = loc;
 
+        {
+            mutex::scoped_lock lk( cappedInsertMutex );
+            cappedInserts++;
+            cappedInsertNotifier.notify_all(); // waiters proceed once the write lock is released
+        }
+
         return loc;
     }
 
+    unsigned long long NamespaceDetails::cappedInsertCount() {
+        mutex::scoped_lock lk( cappedInsertMutex );
+        return cappedInserts;
+    }
+
+    void NamespaceDetails::waitForCappedInsert( unsigned long long lastSeen, unsigned millis ) {
+        mutex::scoped_lock lk( cappedInsertMutex );
+        while ( cappedInserts == lastSeen ) {
+            if ( !cappedInsertNotifier.timed_wait( lk.boost() ,
+                                                    boost::posix_time::milliseconds( millis ) ) )
+                return; // timed out
+        }
+    }
+
     void NamespaceDetails::dumpExtents() {
         cout << "dumpExtents:" << endl;
         for ( DiskLoc i = firstExtent; !i.isNull(); i = i.ext()->xnext ) {
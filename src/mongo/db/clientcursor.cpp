@@ -217,13 +217,23 @@ namespace mongo {
 
         aboutToDeleteForSharding( db , dl );
 
+        advanceCursorsAt( dl );
+    }
+
+    bool ClientCursor::advanceCursorsAt(const DiskLoc& dl) {
+        recursive_scoped_lock lock(ccmutex);
+
+        Database *db = cc().database();
+        verify(db);
+
         CCByLoc& bl = db->ccByLoc;
         CCByLoc::iterator j = bl.lower_bound(ByLocKey::min(dl));
         CCByLoc::iterator stop = bl.upper_bound(ByLocKey::max(dl));
         if ( j == stop )
-            return;
+            return false;
 
         vector<ClientCursor*> toAdvance;
+        bool moved = false;
 
         while ( 1 ) {
             toAdvance.push_back(j->second);
@@ -255,6 +265,7 @@ namespace mongo {
             wassert(cc->_db == db);
 
             if ( cc->_doingDeletes ) continue;
+            moved = true;
 
             Cursor *c = cc->_c.get();
             if ( c->capped() ) {
@@ -288,6 +299,7 @@ namespace mongo {
             }
             cc->updateLocation();
         }
+        return moved;
     }
     void aboutToDelete(const DiskLoc& dl) { ClientCursor::aboutToDelete(dl); }
 
@@ -303,7 +315,7 @@ namespace mongo {
         _c(c), _pos(0),
         _query(query),  _queryOptions(queryOptions),
         _idleAgeMillis(0), _pinValue(0),
-        _doingDeletes(false), _yieldSometimesTracker(128,10) {
+        _doingDeletes(false), _yieldSometimesTracker(32,2) {
 
         Lock::assertAtLeastReadLocked(ns);
 
@@ -422,16 +434,18 @@ namespace mongo {
         return b.obj();
     }
     
-    void ClientCursor::fillQueryResultFromObj( BufBuilder &b ) const {
+    bool ClientCursor::fillQueryResultFromObj( BufBuilder &b ) const {
         const Projection::KeyOnly *keyFieldsOnly = c()->keyFieldsOnly();
         if ( keyFieldsOnly ) {
-            mongo::fillQueryResultFromObj( b, 0, keyFieldsOnly->hydrate( c()->currKey() ) );
-        }
-        else {
-            DiskLoc loc = c()->currLoc();
-            mongo::fillQueryResultFromObj( b, fields.get(), c()->current(),
-                                          ( ( pq && pq->showDiskLoc() ) ? &loc : 0 ) );
+            BSONObjBuilder bob( b );
+            c()->hydrateCurrKey( *keyFieldsOnly, bob );
+            bob.done();
+            return true;
         }
+        DiskLoc loc = c()->currLoc();
+        mongo::fillQueryResultFromObj( b, fields.get(), c()->current(),
+                                      ( ( pq && pq->showDiskLoc() ) ? &loc : 0 ) );
+        return false;
     }
 
     /* call when cursor's location changes so that we can update the
@@ -453,17 +467,17 @@ namespace mongo {
     }
 
     int ClientCursor::suggestYieldMicros() {
+        // only threads queued on a lock we hold gain anything from our yielding
         int writers = 0;
         int readers = 0;
+        Lock::queuedBehindMe( writers , readers );
 
-        int micros = Client::recommendedYieldMicros( &writers , &readers );
-
-        if ( micros > 0 && writers == 0 && Lock::isR() ) {
-            // we have a read lock, and only reads are coming on, so why bother unlocking
-            return 0;
+        if ( writers == 0 && readers == 0 ) {
+            // if there has been a kill request for this op - we should yield to allow the op to stop
+            return *killCurrentOp.checkForInterruptNoAssert() ? 100 : 0;
         }
 
-        wassert( micros < 10000000 );
+        int micros = min( readers * 100 + writers * 500 , 1000000 );
         dassert( micros <  1000001 );
         return micros;
     }
@@ -499,7 +513,7 @@ namespace mongo {
         return rec;
     }
 
-    bool ClientCursor::yieldSometimes( RecordNeeds need, bool *yielded ) {
+    bool ClientCursor::yieldSometimes( RecordNeeds need, bool *yielded , YieldCallback* callback ) {
         if ( yielded ) {
             *yielded = false;   
         }
@@ -510,7 +524,10 @@ namespace mongo {
                 if ( yielded ) {
                     *yielded = true;   
                 }
-                return yield( suggestYieldMicros() , rec );
+                if ( callback ) {
+                    callback->aboutToYield();
+                }
+                return _yieldFor( CurOp::YieldForPageFault , suggestYieldMicros() , rec );
             }
             return true;
         }
@@ -520,13 +537,23 @@ namespace mongo {
             if ( yielded ) {
                 *yielded = true;   
             }
-            return yield( micros , _recordForYield( need ) );
+            if ( callback ) {
+                callback->aboutToYield();
+            }
+            return _yieldFor( *killCurrentOp.checkForInterruptNoAssert() ?
+                              CurOp::YieldForInterrupt : CurOp::YieldForLockWaiters ,
+                              micros , _recordForYield( need ) );
         }
         return true;
     }
 
-    void ClientCursor::staticYield( int micros , const StringData& ns , Record * rec ) {
+    bool ClientCursor::staticYield( int micros , const StringData& ns , Record * rec ) {
         killCurrentOp.checkForInterrupt( false );
+        // ask before unlocking, while we still hold the locks others may be queued on
+        if ( micros == -1 )
+            micros = suggestYieldMicros();
+
+        bool unlocked = false;
         {
             auto_ptr<LockMongoFilesShared> lk;
             if ( rec ) {
@@ -536,8 +563,7 @@ namespace mongo {
             
             dbtempreleasecond unlock;
             if ( unlock.unlocked() ) {
-                if ( micros == -1 )
-                    micros = Client::recommendedYieldMicros();
+                unlocked = true;
                 if ( micros > 0 )
                     sleepmicros( micros );
             }
@@ -556,6 +582,7 @@ namespace mongo {
 
             lk.reset(0); // need to release this before dbtempreleasecond
         }
+        return unlocked;
     }
 
     bool ClientCursor::prepareToYield( YieldData &data ) {
@@ -618,6 +645,21 @@ namespace mongo {
         return ClientCursor::recoverFromYield( data );
     }
 
+    bool ClientCursor::_yieldFor( int reason , int micros , Record * recordToLoad ) {
+
+        if ( ! _c->supportYields() )
+            return true;
+
+        YieldData data;
+        prepareToYield( data );
+        CurOp * op = cc().curop();
+        if ( staticYield( micros , _ns , recordToLoad ) ) {
+            // only count yields that released the lock, not ones blocked by a recursive lock
+            op->yieldedFor( (CurOp::YieldReason)reason );
+        }
+        return ClientCursor::recoverFromYield( data );
+    }
+
     // See SERVER-5726.
     long long ctmLast = 0; // so we don't have to do find() which is a little slow very often.
     long long ClientCursor::allocCursorId_inlock() {
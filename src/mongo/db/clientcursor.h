@@ -210,16 +210,28 @@ namespace mongo {
             DontNeed = -1 , MaybeCovered = 0 , WillNeed = 100
         };
             
+        class YieldCallback {
+        public:
+            virtual ~YieldCallback() {}
+            /** called while still locked, just before yieldSometimes() yields */
+            virtual void aboutToYield() = 0;
+        };
+
         /**
          * @param needRecord whether or not the next record has to be read from disk for sure
          *                   if this is true, will yield of next record isn't in memory
          * @param yielded true if a yield occurred, and potentially if a yield did not occur
+         * @param callback if set, notified before a yield
          * @return same as yield()
          */
-        bool yieldSometimes( RecordNeeds need, bool *yielded = 0 );
+        bool yieldSometimes( RecordNeeds need, bool *yielded = 0 , YieldCallback* callback = 0 );
 
         static int suggestYieldMicros();
-        static void staticYield( int micros , const StringData& ns , Record * rec );
+        /**
+         * @param micros -1 : sleep for suggestYieldMicros(), computed before unlocking
+         * @return true if the lock was released, false if a recursive lock prevented it
+         */
+        static bool staticYield( int micros , const StringData& ns , Record * rec );
 
         struct YieldData { CursorId _id; bool _doingDeletes; };
         bool prepareToYield( YieldData &data );
@@ -287,7 +299,8 @@ namespace mongo {
         */
         BSONObj extractFields(const BSONObj &pattern , bool fillWithNull = false) ;
         
-        void fillQueryResultFromObj( BufBuilder &b ) const;
+        /** @return true if the result was read from the index key alone. */
+        bool fillQueryResultFromObj( BufBuilder &b ) const;
         
         bool currentIsDup() { return _c->getsetdup( _c->currLoc() ); }
 
@@ -373,6 +386,11 @@ namespace mongo {
         static unsigned numCursors() { return clientCursorsById.size(); }
         static void informAboutToDeleteBucket(const DiskLoc& b);
         static void aboutToDelete(const DiskLoc& dl);
+        /**
+         * moves the cursors positioned at dl off it, without the notifications of aboutToDelete()
+         * @return true if any cursor was moved
+         */
+        static bool advanceCursorsAt(const DiskLoc& dl);
         static void find( const string& ns , set<CursorId>& all );
 
 
@@ -385,6 +403,8 @@ namespace mongo {
         CCByLoc& byLoc() { return _db->ccByLoc; }
         
         Record* _recordForYield( RecordNeeds need );
+        /** yield() for yieldSometimes(), recording the CurOp::YieldReason if the lock was released */
+        bool _yieldFor( int reason , int micros , Record * recordToLoad );
 
     private:
 
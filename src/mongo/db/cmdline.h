@@ -74,9 +74,11 @@ namespace mongo {
 
         bool quiet;            // --quiet
         bool noTableScan;      // --notablescan no table scans allowed
+        bool indexIntersection; // --indexIntersection consider plans intersecting two indexes
         bool prealloc;         // --noprealloc no preallocation of data files
         bool preallocj;        // --nopreallocj no preallocation of journal files
         bool smallfiles;       // --smallfiles allocate smaller data files
+        bool numaInterleave;   // --numaInterleave interleave process memory across NUMA nodes
 
         bool configsvr;        // --configsvr
 
@@ -155,7 +157,8 @@ namespace mongo {
     // todo move to cmdline.cpp?
     inline CmdLine::CmdLine() :
         port(DefaultDBPort), rest(false), jsonp(false), quiet(false),
-        noTableScan(false), prealloc(true), preallocj(true), smallfiles(sizeof(int*) == 4),
+        noTableScan(false), indexIntersection(false), prealloc(true), preallocj(true), smallfiles(sizeof(int*) == 4),
+        numaInterleave(false),
         configsvr(false), quota(false), quotaFiles(8), cpu(false),
         durOptions(0), objcheck(false), oplogSize(0), defaultProfile(0),
         slowMS(100), defaultLocalThresholdMillis(10), pretouch(0), moveParanoia( true ),
@@ -171,6 +171,7 @@ namespace mongo {
 }
 
 #include "../client/connpool.h"
+#include "../s/multiplexed_connection.h"
 
 namespace mongo {
 
@@ -198,6 +199,11 @@ namespace mongo {
         virtual LockType locktype() const { return NONE; }
         virtual bool run(const string&, mongo::BSONObj&, int, std::string&, mongo::BSONObjBuilder& result, bool) {
             pool.appendInfo( result );
+            if ( multiplexedConnectionPool.enabled() ) {
+                BSONObjBuilder b( result.subobjStart( "multiplexed" ) );
+                multiplexedConnectionPool.appendInfo( b );
+                b.done();
+            }
             result.append( "numDBClientConnection" , DBClientConnection::getNumConnections() );
             result.append( "numAScopedConnection" , AScopedConnection::getNumConnections() );
             return true;
@@ -18,12 +18,18 @@
 //#include "pch.h"
 #include "../commands.h"
 #include "../instance.h"
+#include "../btree.h"
 #include "../clientcursor.h"
 #include "../../util/timer.h"
 
 namespace mongo {
 
     class DistinctCommand : public Command {
+        static bool isLeadingIndexField( const IndexDetails &idx , const string &key ) {
+            BSONElement first = idx.keyPattern().firstElement();
+            return first.isNumber() && key == first.fieldName();
+        }
+
     public:
         DistinctCommand() : Command("distinct") {}
         virtual bool slaveOk() const { return true; }
@@ -68,21 +74,24 @@ namespace mongo {
             else {
 
                 // query is empty, so lets see if we can find an index
-                // with the key so we don't have to hit the raw data
-                NamespaceDetails::IndexIterator ii = d->ii();
-                while ( ii.more() ) {
-                    IndexDetails& idx = ii.next();
-
-                    if ( d->isMultikey( ii.pos() - 1 ) )
-                        continue;
-
-                    if ( idx.inKeyPattern( key ) ) {
-                        cursor = NamespaceDetailsTransient::bestGuessCursor( ns.c_str() ,
-                                                                            BSONObj() ,
-                                                                            idx.keyPattern() );
-                        if( cursor.get() ) break;
-                    }
+                // with the key so we don't have to hit the raw data.  an index
+                // led by the key is preferred, as it can be skip scanned
+                for ( int leading = 1; leading >= 0 && ! cursor.get(); --leading ) {
+                    NamespaceDetails::IndexIterator ii = d->ii();
+                    while ( ii.more() ) {
+                        IndexDetails& idx = ii.next();
+
+                        if ( d->isMultikey( ii.pos() - 1 ) )
+                            continue;
+
+                        if ( leading ? isLeadingIndexField( idx , key ) : idx.inKeyPattern( key ) ) {
+                            cursor = NamespaceDetailsTransient::bestGuessCursor( ns.c_str() ,
+                                                                                BSONObj() ,
+                                                                                idx.keyPattern() );
+                            if( cursor.get() ) break;
+                        }
 
+                    }
                 }
 
                 if ( ! cursor.get() )
@@ -93,12 +102,21 @@ namespace mongo {
             
             verify( cursor );
             string cursorName = cursor->toString();
-            
+
+            // Every key of a non multikey index holds exactly the value of each of the document's
+            // indexed fields.  So when the index is led by the key, once a document has produced
+            // a value the remaining keys with that value can be skipped with a btree seek.
+            BtreeCursor *skipScan = dynamic_cast<BtreeCursor*>( cursor.get() );
+            if ( skipScan && ( skipScan->isMultiKey() ||
+                               skipScan->indexKeyPattern().firstElementFieldName() != key ) )
+                skipScan = 0;
+
             auto_ptr<ClientCursor> cc (new ClientCursor(QueryOption_NoCursorTimeout, cursor, ns));
 
             while ( cursor->ok() ) {
                 nscanned++;
                 bool loadedRecord = false;
+                bool skipKeyPrefix = false;
 
                 if ( cursor->currentMatches( &md ) && !cursor->getsetdup( cursor->currLoc() ) ) {
                     n++;
@@ -106,6 +124,9 @@ namespace mongo {
                     BSONObj holder;
                     BSONElementSet temp;
                     loadedRecord = ! cc->getFieldsDotted( key , temp, holder );
+                    // a document missing the key shares its null index key with documents holding
+                    // null, so only skip once a value has actually been seen
+                    skipKeyPrefix = skipScan && ! temp.empty();
 
                     for ( BSONElementSet::iterator i=temp.begin(); i!=temp.end(); ++i ) {
                         BSONElement e = *i;
@@ -126,7 +147,10 @@ namespace mongo {
                 if ( loadedRecord || md.hasLoadedRecord() )
                     nscannedObjects++;
 
-                cursor->advance();
+                if ( skipKeyPrefix )
+                    skipScan->advancePastKeyPrefix();
+                else
+                    cursor->advance();
 
                 if (!cc->yieldSometimes( ClientCursor::MaybeCovered )) {
                     cc.release();
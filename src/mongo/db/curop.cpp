@@ -50,6 +50,8 @@ namespace mongo {
         _progressMeter.finished();
         _killed = false;
         _numYields = 0;
+        for( int i = 0; i < NumYieldReasons; ++i )
+            _yieldReasons[i] = 0;
         _expectedLatencyMs = 0;
     }
 
@@ -172,6 +174,11 @@ namespace mongo {
             b.append("killed", true);
         
         b.append( "numYields" , _numYields );
+        if ( _numYields ) {
+            b.append( "yieldReasons" , BSON( "lockWaiters" << _yieldReasons[YieldForLockWaiters] <<
+                                             "pageFault" << _yieldReasons[YieldForPageFault] <<
+                                             "interrupt" << _yieldReasons[YieldForInterrupt] ) );
+        }
 
         return b.obj();
     }
@@ -220,6 +220,10 @@ namespace mongo {
         void kill() { _killed = true; }
         bool killed() const { return _killed; }
         void yielded() { _numYields++; }
+
+        /** why ClientCursor::yieldSometimes chose to yield, counted only when the lock was released */
+        enum YieldReason { YieldForLockWaiters, YieldForPageFault, YieldForInterrupt, NumYieldReasons };
+        void yieldedFor( YieldReason reason ) { _yieldReasons[reason]++; }
         void setNS(const char *ns) {
             strncpy(_ns, ns, Namespace::MaxNsLen);
             _ns[Namespace::MaxNsLen] = 0;
@@ -256,6 +260,7 @@ namespace mongo {
         ProgressMeter _progressMeter;
         volatile bool _killed;
         int _numYields;
+        int _yieldReasons[NumYieldReasons];
 
         // this is how much "extra" time a query might take
         // a writebacklisten for example will block for 30s 
@@ -210,6 +210,14 @@ namespace mongo {
         virtual void setKeyFieldsOnly( const shared_ptr<Projection::KeyOnly> &keyFieldsOnly ) {
             massert( 16159, "manual keyFieldsOnly config not allowed", false );
         }
+
+        /**
+         * Append the covered index projection keyOnly of the current iterate's key to b.
+         * Implementations may read the key in place rather than building currKey().
+         */
+        virtual void hydrateCurrKey( const Projection::KeyOnly &keyOnly, BSONObjBuilder &b ) const {
+            keyOnly.hydrate( currKey(), b );
+        }
         
         virtual void explainDetails( BSONObjBuilder& b ) { return; }
     };
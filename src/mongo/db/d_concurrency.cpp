@@ -229,6 +229,35 @@ namespace mongo {
         result.append("locks", b.obj());
     }
 
+    /** counts the threads acquiring lock that a holder in mode held, one of RWrw, blocks */
+    static void addQueuedBehind( const LockStat& stats, char held, int& writers, int& readers ) {
+        writers += stats.numAcquiring('W');
+        if( held == 'R' || held == 'W' )
+            writers += stats.numAcquiring('w');
+        if( held == 'w' || held == 'W' )
+            readers += stats.numAcquiring('R');
+        if( held == 'W' )
+            readers += stats.numAcquiring('r');
+    }
+
+    void Lock::queuedBehindMe( int& writers, int& readers ) {
+        writers = 0;
+        readers = 0;
+        LockState& ls = lockState();
+        if( ls.threadState() == 0 )
+            return;
+        addQueuedBehind( qlk.stats, ls.threadState(), writers, readers );
+        // db level locks are only ever taken in R or W mode
+        if( ls.nestableCount() ) {
+            addQueuedBehind( nestableLocks[ls.whichNestable()]->stats,
+                             ls.nestableCount() > 0 ? 'W' : 'R', writers, readers );
+        }
+        if( ls.otherCount() && ls.otherLock() ) {
+            addQueuedBehind( ls.otherLock()->stats,
+                             ls.otherCount() > 0 ? 'W' : 'R', writers, readers );
+        }
+    }
+
     int Lock::isLocked() {
         return threadState();
     }
@@ -49,6 +49,12 @@ namespace mongo {
 
         static bool dbLevelLockingEnabled(); 
 
+        /**
+         * Count the threads waiting for a lock in a mode that conflicts with a lock this thread
+         * holds, so that they are blocked until it is released.  Racy, for yield decisions.
+         */
+        static void queuedBehindMe( int& writers, int& readers );
+
         class ScopedLock;
 
         // note: avoid TempRelease when possible. not a good thing.
@@ -62,6 +62,11 @@
 # include <sys/file.h>
 #endif
 
+#if defined(__linux__)
+# include <sys/syscall.h>
+# include <linux/mempolicy.h>
+#endif
+
 namespace mongo {
 
     namespace dur { 
@@ -583,6 +588,49 @@ namespace mongo {
     }
 #endif
 
+#if defined(__linux__)
+    /** @return bitmask of the online NUMA nodes, parsed from e.g. "0-3,5" */
+    static unsigned long onlineNumaNodes() {
+        FILE *f = fopen( "/sys/devices/system/node/online" , "r" );
+        if ( f == NULL )
+            return 0;
+        unsigned long mask = 0;
+        int lo, hi;
+        char sep;
+        while ( fscanf( f , "%d" , &lo ) == 1 ) {
+            hi = lo;
+            int n = fscanf( f , "%c" , &sep );
+            if ( n == 1 && sep == '-' ) {
+                if ( fscanf( f , "%d" , &hi ) != 1 )
+                    break;
+                n = fscanf( f , "%c" , &sep );
+            }
+            for ( int i = lo; i <= hi && i < (int)sizeof(mask) * 8; i++ )
+                mask |= 1UL << i;
+            if ( n != 1 || sep != ',' )
+                break;
+        }
+        fclose( f );
+        return mask;
+    }
+
+    /** --numaInterleave: like running under numactl --interleave=all.  the policy covers the
+        page cache pages behind the shared data file mappings.  it is inherited by the threads
+        started after it is set, which is all of them but the signal handling thread started
+        before the options are parsed; that thread touches no data.  a no-op on single node
+        machines.
+    */
+    static void setNumaInterleave() {
+        unsigned long nodes = onlineNumaNodes();
+        if ( ( nodes & ( nodes - 1 ) ) == 0 )
+            return; // zero or one node
+        // the kernel reads maxnode - 1 bits of the mask
+        if ( syscall( SYS_set_mempolicy , MPOL_INTERLEAVE , &nodes , sizeof(nodes) * 8 + 1 ) ) {
+            warning() << "set_mempolicy MPOL_INTERLEAVE failed " << errnoWithDescription() << endl;
+        }
+    }
+#endif
+
 } // namespace mongo
 
 using namespace mongo;
@@ -640,6 +688,7 @@ static int mongoDbMain(int argc, char* argv[]) {
     ("journal", "enable journaling")
     ("journalCommitInterval", po::value<unsigned>(), "how often to group/batch commit (ms)")
     ("journalOptions", po::value<int>(), "journal diagnostic options")
+    ("indexIntersection", "let the query optimizer try plans intersecting two indexes")
     ("jsonp","allow JSONP access via http (has security implications)")
     ("noauth", "run without security")
     ("nohttpinterface", "disable http interface")
@@ -648,6 +697,9 @@ static int mongoDbMain(int argc, char* argv[]) {
     ("noscripting", "disable scripting engine")
     ("notablescan", "do not allow table scans")
     ("nssize", po::value<int>()->default_value(16), ".ns file size (in MB) for new databases")
+#if defined(__linux__)
+    ("numaInterleave", "interleave the memory of the process, data files included, across all NUMA nodes")
+#endif
     ("profile",po::value<int>(), "0=off 1=slow, 2=all")
     ("quota", "limits each database to a certain number of files (8 default)")
     ("quotaFiles", po::value<int>(), "number of files allowed per db, requires --quota")
@@ -858,6 +910,12 @@ static int mongoDbMain(int argc, char* argv[]) {
             cmdLine.prealloc = false;
             cout << "note: noprealloc may hurt performance in many applications" << endl;
         }
+#if defined(__linux__)
+        if (params.count("numaInterleave")) {
+            cmdLine.numaInterleave = true;
+            setNumaInterleave();
+        }
+#endif
         if (params.count("smallfiles")) {
             cmdLine.smallfiles = true;
             verify( dur::DataLimitPerJournalFile >= 128 * 1024 * 1024 );
@@ -887,6 +945,9 @@ static int mongoDbMain(int argc, char* argv[]) {
         if (params.count("notablescan")) {
             cmdLine.noTableScan = true;
         }
+        if (params.count("indexIntersection")) {
+            cmdLine.indexIntersection = true;
+        }
         if (params.count("master")) {
             replSettings.master = true;
         }
@@ -48,6 +48,7 @@
 #include "../util/version.h"
 #include "../s/d_writeback.h"
 #include "dur_stats.h"
+#include "../util/compress.h"
 #include "../server.h"
 #include "mongo/s/d_index_locator.h"
 
@@ -597,6 +598,12 @@ namespace mongo {
 
             result.append( "opcounters" , globalOpCounters.getObj() );
 
+            {
+                BSONObjBuilder bb( result.subobjStart( "coveredQueries" ) );
+                globalCoveredQueryCounters.append( bb );
+                bb.done();
+            }
+
             {
                 BSONObjBuilder asserts( result.subobjStart( "asserts" ) );
                 asserts.append( "regular" , assertionCount.regular );
@@ -1355,7 +1362,66 @@ namespace mongo {
         virtual LockType locktype() const { return READ; }
         virtual void help( stringstream &help ) const {
             help << "{ collStats:\"blog.posts\" , scale : 1 } scale divides sizes e.g. for KB use 1024\n"
-                    "    avgObjSize - in bytes";
+                    "    avgObjSize - in bytes\n"
+                    "    compressionSample : n - snappy compress the first n records (at most 10000) in 64KB blocks and report the ratio";
+        }
+
+        /** the most records compressionSample will compress, whatever is asked for */
+        static const long long CompressionSampleMax = 10000;
+        /** records are compressed together in groups of about this many bytes, as blocks would be */
+        static const int CompressionBlockBytes = 64 * 1024;
+
+        /**
+         * compresses up to 'sample' records of ns, consecutive records together in blocks of about
+         * CompressionBlockBytes, and reports what block compression would save.  nothing is
+         * stored compressed.  yields and checks for interrupts as it goes, so call it after nsd
+         * is no longer needed.
+         */
+        void appendCompressionEstimate( const string& ns, long long sample, BSONObjBuilder& result ) {
+            sample = std::min( sample , CompressionSampleMax );
+            long long n = 0;
+            long long rawBytes = 0;
+            long long compressedBytes = 0;
+            long long blocks = 0;
+            BufBuilder block( CompressionBlockBytes );
+            string buf;
+            Timer t;
+            shared_ptr<Cursor> c = theDataFileMgr.findAll( ns.c_str() );
+            ClientCursor::Holder cc( new ClientCursor( QueryOption_NoCursorTimeout, c, ns ) );
+            while ( c->ok() && n < sample ) {
+                if ( !cc->yieldSometimes( ClientCursor::WillNeed ) ) {
+                    cc.release(); // the collection went away while we yielded
+                    break;
+                }
+                if ( !c->ok() )
+                    break;
+                RARELY killCurrentOp.checkForInterrupt();
+
+                BSONObj o = c->current();
+                rawBytes += o.objsize();
+                block.appendBuf( o.objdata(), o.objsize() );
+                if ( block.len() >= CompressionBlockBytes ) {
+                    compressedBytes += compress( block.buf(), block.len(), &buf );
+                    blocks++;
+                    block.reset();
+                }
+                c->advance();
+                n++;
+            }
+            if ( block.len() ) {
+                compressedBytes += compress( block.buf(), block.len(), &buf );
+                blocks++;
+            }
+
+            BSONObjBuilder b( result.subobjStart( "compression" ) );
+            b.appendNumber( "sampledObjects" , n );
+            b.appendNumber( "sampledBytes" , rawBytes );
+            b.appendNumber( "compressedBytes" , compressedBytes );
+            b.appendNumber( "blocks" , blocks );
+            if ( compressedBytes )
+                b.append( "ratio" , double(rawBytes) / double(compressedBytes) );
+            b.append( "millis" , t.millis() );
+            b.done();
         }
         bool run(const string& dbname, BSONObj& jsobj, int, string& errmsg, BSONObjBuilder& result, bool fromRepl ) {
             string ns = dbname + "." + jsobj.firstElement().valuestr();
@@ -1413,6 +1479,10 @@ namespace mongo {
             if ( verbose )
                 result.appendArray( "extents" , extents.arr() );
 
+            long long compressionSample = jsobj["compressionSample"].numberLong();
+            if ( compressionSample > 0 )
+                appendCompressionEstimate( ns, compressionSample, result );
+
             return true;
         }
     } cmdCollectionStats;
@@ -135,6 +135,7 @@ namespace mongo {
             help << "supported so far:\n";
             help << "  quiet\n";
             help << "  notablescan\n";
+            help << "  indexIntersection\n";
             help << "  logLevel\n";
             help << "  syncdelay\n";
             help << "{ getParameter:'*' } to get everything\n";
@@ -150,6 +151,9 @@ namespace mongo {
             if( all || cmdObj.hasElement("notablescan") ) {
                 result.append("notablescan", cmdLine.noTableScan);
             }
+            if( all || cmdObj.hasElement("indexIntersection") ) {
+                result.append("indexIntersection", cmdLine.indexIntersection);
+            }
             if( all || cmdObj.hasElement("logLevel") ) {
                 result.append("logLevel", logLevel);
             }
@@ -181,6 +185,7 @@ namespace mongo {
             help << "set administrative option(s)\n";
             help << "{ setParameter:1, <param>:<value> }\n";
             help << "supported so far:\n";
+            help << "  indexIntersection\n";
             help << "  journalCommitInterval\n";
             help << "  logLevel\n";
             help << "  notablescan\n";
@@ -208,6 +213,13 @@ namespace mongo {
                 cmdLine.noTableScan = cmdObj["notablescan"].Bool();
                 s++;
             }
+            if( cmdObj.hasElement("indexIntersection") ) {
+                verify( !cmdLine.isMongos() );
+                if( s == 0 )
+                    result.append("was", cmdLine.indexIntersection);
+                cmdLine.indexIntersection = cmdObj["indexIntersection"].Bool();
+                s++;
+            }
             if( cmdObj.hasElement("quiet") ) {
                 if( s == 0 )
                     result.append("was", cmdLine.quiet );
@@ -205,6 +205,24 @@ namespace mongo {
         return me.obj();
     }
 
+    bool Helpers::hasKeysInRange( const string& ns , const BSONObj& min , const BSONObj& max , bool maxInclusive ) {
+        BSONObj keya , keyb;
+        BSONObj minClean = toKeyFormat( min , keya );
+        BSONObj maxClean = toKeyFormat( max , keyb );
+        verify( keya == keyb );
+
+        NamespaceDetails* nsd = nsdetails( ns.c_str() );
+        if ( ! nsd )
+            return false;
+
+        int ii = nsd->findIndexByKeyPattern( keya );
+        if ( ii < 0 )
+            return true;
+
+        scoped_ptr<BtreeCursor> c( BtreeCursor::make( nsd , ii , nsd->idx( ii ) , minClean , maxClean , maxInclusive , 1 ) );
+        return c->ok();
+    }
+
     long long Helpers::removeRange( const string& ns , const BSONObj& min , const BSONObj& max , bool yield , bool maxInclusive , RemoveCallback * callback, bool fromMigrate ) {
         BSONObj keya , keyb;
         BSONObj minClean = toKeyFormat( min , keya );
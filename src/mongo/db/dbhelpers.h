@@ -110,6 +110,15 @@ namespace mongo {
             virtual void goingToDelete( const BSONObj& o ) = 0;
         };
 
+        /**
+         * Checks the index whose key pattern has the fields of min and max for any key in the range.
+         * Must be called with ns's database as the context.
+         * @return false only if the index shows the range holds no document; true as well when
+         *         there is no such index
+         */
+        static bool hasKeysInRange( const string& ns , const BSONObj& min , const BSONObj& max ,
+                                    bool maxInclusive = false );
+
         /**
          * Remove all documents in the range.
          * Does oplog the individual document deletions.
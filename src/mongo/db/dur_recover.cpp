@@ -214,7 +214,7 @@ namespace mongo {
             _mmfs.clear();
         }
 
-        void RecoveryJob::write(const ParsedJournalEntry& entry) {
+        MongoMMF* RecoveryJob::findOrOpen(const ParsedJournalEntry& entry) {
             //TODO(mathias): look into making some of these dasserts
             verify(entry.e);
             verify(entry.dbName);
@@ -242,6 +242,11 @@ namespace mongo {
                 _mmfs.push_back(sp);
                 mmf = sp.get();
             }
+            return mmf;
+        }
+
+        void RecoveryJob::write(const ParsedJournalEntry& entry) {
+            MongoMMF* mmf = findOrOpen(entry);
 
             if ((entry.e->ofs + entry.e->len) <= mmf->length()) {
                 verify(mmf->view_write());
@@ -301,6 +306,86 @@ namespace mongo {
                 log() << "END section" << endl;
         }
 
+        /** regions of a data file that recovery may write concurrently.  a write that straddles a
+            region boundary is applied on its own so it is ordered against both neighbours.
+        */
+        const unsigned RegionShift = 26; // 64MB
+        const unsigned RecoveryApplyThreads = 8;
+
+        void RecoveryJob::applyRegion(MongoMMF *mmf, const vector<const JEntry*> *writes, unsigned long long *bytes, string *err) {
+            // runs on a pool worker, whose loop only logs exceptions: hand them back to go()
+            try {
+                char *view = (char*) mmf->view_write();
+                massert(16334, str::stream() << "recover error no view for " << mmf->filename(), view);
+                for( vector<const JEntry*>::const_iterator i = writes->begin(); i != writes->end(); ++i ) {
+                    const JEntry *e = *i;
+                    massert(16335, str::stream() << "recover error bad journal entry for " << mmf->filename()
+                                                 << " ofs:" << e->ofs << " len:" << e->len, e->srcData());
+                    memcpy(view + e->ofs, e->srcData(), e->len);
+                    *bytes += e->len;
+                }
+            }
+            catch( DBException& e ) {
+                *err = e.toString();
+            }
+            catch( std::exception& e ) {
+                *err = e.what();
+            }
+        }
+
+        /** applies and clears the pending writes. writes in different regions cannot overlap so
+            each region is applied by one worker, in journal order. most of the time goes to
+            faulting in data file pages, so this mostly buys concurrent disk reads.
+        */
+        void RecoveryJob::applyRegions(RegionWrites& regions) {
+            if( regions.empty() )
+                return;
+            vector<unsigned long long> bytes(regions.size(), 0);
+            vector<string> errs(regions.size());
+            unsigned n = 0;
+            if( regions.size() == 1 ) {
+                applyRegion(regions.begin()->first.first, &regions.begin()->second, &bytes[0], &errs[0]);
+            }
+            else {
+                for( RegionWrites::iterator i = regions.begin(); i != regions.end(); ++i, ++n ) {
+                    _applyPool->schedule(&RecoveryJob::applyRegion, i->first.first, &i->second, &bytes[n], &errs[n]);
+                }
+                _applyPool->join();
+            }
+            for( unsigned j = 0; j < bytes.size(); j++ ) {
+                massert(16336, str::stream() << "recover error applying journal writes: " << errs[j], errs[j].empty());
+                stats.curr->_writeToDataFilesBytes += bytes[j];
+                _bytesApplied += bytes[j];
+            }
+            regions.clear();
+        }
+
+        void RecoveryJob::applyEntriesInParallel(const vector<ParsedJournalEntry> &entries) {
+            RegionWrites regions;
+            for( vector<ParsedJournalEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i ) {
+                const JEntry *e = i->e;
+                if( e == 0 ) {
+                    // DurOps may create or drop files; everything before them must be on disk
+                    applyRegions(regions);
+                    applyEntry(*i, true, false);
+                    continue;
+                }
+                MongoMMF* mmf = findOrOpen(*i);
+                if( e->ofs + e->len > mmf->length() ) {
+                    continue; // past end of file, see write()
+                }
+                unsigned region = e->ofs >> RegionShift;
+                if( ( ( e->ofs + e->len - 1 ) >> RegionShift ) != region ) {
+                    applyRegions(regions);
+                    write(*i);
+                    _bytesApplied += e->len;
+                    continue;
+                }
+                regions[ make_pair(mmf, region) ].push_back(e);
+            }
+            applyRegions(regions);
+        }
+
         void RecoveryJob::processSection(const JSectHeader *h, const void *p, unsigned len, const JSectFooter *f) {
             scoped_lock lk(_mx);
             RACECHECK
@@ -360,7 +445,13 @@ namespace mongo {
             }
 
             // got all the entries for one group commit.  apply them:
-            applyEntries(entries);
+            if( _recovering && _applyPool &&
+                ( cmdLine.durOptions & (CmdLine::DurDumpJournal | CmdLine::DurScanOnly) ) == 0 ) {
+                applyEntriesInParallel(entries);
+            }
+            else {
+                applyEntries(entries);
+            }
         }
 
         /** apply a specific journal file, that is already mmap'd
@@ -453,7 +544,10 @@ namespace mongo {
         /** @param files all the j._0 style files we need to apply for recovery */
         void RecoveryJob::go(vector<boost::filesystem::path>& files) {
             log() << "recover begin" << endl;
+            Timer t;
             _recovering = true;
+            _bytesApplied = 0;
+            _applyPool.reset( new ThreadPool(RecoveryApplyThreads) );
 
             // load the last sequence number synced to the datafiles on disk before the last crash
             _lastDataSyncedFromLastRun = journalReadLSN();
@@ -464,11 +558,15 @@ namespace mongo {
                 if( abruptEnd && i+1 < files.size() ) {
                     log() << "recover error: abrupt end to file " << files[i].string() << ", yet it isn't the last journal file" << endl;
                     close();
+                    _applyPool.reset();
                     uasserted(13535, "recover abrupt journal file end");
                 }
             }
 
             close();
+            _applyPool.reset();
+            log() << "recover applied " << _bytesApplied / 1024 / 1024 << "MB from " << files.size()
+                  << " journal file(s) in " << t.millis() << "ms" << endl;
 
             if( cmdLine.durOptions & CmdLine::DurScanOnly ) {
                 uasserted(13545, str::stream() << "--durOptions " << (int) CmdLine::DurScanOnly << " (scan only) specified");
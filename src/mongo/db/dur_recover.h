@@ -4,6 +4,7 @@
 
 #include "dur_journalformat.h"
 #include "../util/concurrency/mutex.h"
+#include "../util/concurrency/thread_pool.h"
 #include "../util/file.h"
 
 namespace mongo {
@@ -16,7 +17,7 @@ namespace mongo {
          */
         class RecoveryJob : boost::noncopyable {
         public:
-            RecoveryJob() : _lastDataSyncedFromLastRun(0), 
+            RecoveryJob() : _bytesApplied(0), _lastDataSyncedFromLastRun(0), 
                 _mx("recovery"), _recovering(false) { _lastSeqMentionedInConsoleLog = 1; }
             void go(vector<boost::filesystem::path>& files);
             ~RecoveryJob();
@@ -28,15 +29,26 @@ namespace mongo {
 
             static RecoveryJob & get() { return _instance; }
         private:
+            /** basic writes to one region of one data file, in journal order */
+            typedef map< pair<MongoMMF*,unsigned>, vector<const JEntry*> > RegionWrites;
+
+            MongoMMF* findOrOpen(const ParsedJournalEntry& entry);
             void write(const ParsedJournalEntry& entry); // actually writes to the file
             void applyEntry(const ParsedJournalEntry& entry, bool apply, bool dump);
             void applyEntries(const vector<ParsedJournalEntry> &entries);
+            void applyEntriesInParallel(const vector<ParsedJournalEntry> &entries);
+            void applyRegions(RegionWrites& regions);
+            static void applyRegion(MongoMMF *mmf, const vector<const JEntry*> *writes, unsigned long long *bytes, string *err);
             bool processFileBuffer(const void *, unsigned len);
             bool processFile(boost::filesystem::path journalfile);
             void _close(); // doesn't lock
 
             list<boost::shared_ptr<MongoMMF> > _mmfs;
 
+            // applies sections' writes to disjoint file regions concurrently during recovery
+            scoped_ptr<ThreadPool> _applyPool;
+            unsigned long long _bytesApplied;
+
             unsigned long long _lastDataSyncedFromLastRun;
             unsigned long long _lastSeqMentionedInConsoleLog;
         public:
@@ -88,6 +88,7 @@ namespace mongo {
         bob.appendNumber( "nscanned", clauseInfo.nscanned() );
         bob.append( "scanAndOrder", _scanAndOrder );
         bob.append( "indexOnly", _indexOnly );
+        bob.appendNumber( "nCovered", clauseInfo.nCovered() );
         bob.appendNumber( "nYields", _nYields );
         bob.appendNumber( "nChunkSkips", clauseInfo.nChunkSkips() );
         bob.appendNumber( "millis", clauseInfo.millis() );
@@ -152,6 +153,10 @@ namespace mongo {
         return ret;
     }
 
+    long long ExplainClauseInfo::nCovered() const {
+        return virtualPickedPlan().indexOnly() ? _n : 0;
+    }
+
     const ExplainPlanInfo &ExplainClauseInfo::virtualPickedPlan() const {
         // Return a picked plan if possible.
         for( list<shared_ptr<const ExplainPlanInfo> >::const_iterator i = _plans.begin();
@@ -205,6 +210,7 @@ namespace mongo {
             long long n = 0;
             long long nscannedObjects = 0;
             long long nscanned = 0;
+            long long nCovered = 0;
             BSONArrayBuilder clauseArray( bob.subarrayStart( "clauses" ) );
             for( list<shared_ptr<ExplainClauseInfo> >::const_iterator i = _clauses.begin();
                 i != _clauses.end(); ++i ) {
@@ -212,11 +218,13 @@ namespace mongo {
                 n += (*i)->n();
                 nscannedObjects += (*i)->nscannedObjects();
                 nscanned += (*i)->nscanned();
+                nCovered += (*i)->nCovered();
             }
             clauseArray.done();
             bob.appendNumber( "n", n );
             bob.appendNumber( "nscannedObjects", nscannedObjects );
             bob.appendNumber( "nscanned", nscanned );
+            bob.appendNumber( "nCovered", nCovered );
             bob.appendNumber( "millis", _timer.duration() );
         }
         
@@ -65,6 +65,7 @@ namespace mongo {
 
         bool picked() const { return _picked; }
         bool done() const { return _done; }
+        bool indexOnly() const { return _indexOnly; }
         long long n() const { return _n; }
         long long nscanned() const { return _nscanned; }
 
@@ -103,6 +104,8 @@ namespace mongo {
         long long n() const { return _n; }
         long long nscannedObjects() const { return _nscannedObjects; }
         long long nscanned() const;
+        /** @return the number of documents returned from index keys alone. */
+        long long nCovered() const;
         long long nChunkSkips() const { return _nChunkSkips; }
         int millis() const { return _timer.duration(); }
 
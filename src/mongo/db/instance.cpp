@@ -648,19 +648,28 @@ namespace mongo {
         bool exhaust = false;
         QueryResult* msgdata = 0;
         OpTime last;
+        unsigned long long lastCappedInsert = 0;
         while( 1 ) {
             try {
                 const NamespaceString nsString( ns );
                 uassert( 16258, str::stream() << "Invalid ns [" << ns << "]", nsString.isValid() );
 
                 if (str::startsWith(ns, "local.oplog.")){
-                    if (pass == 0) {
-                        mutex::scoped_lock lk(OpTime::m);
-                        last = OpTime::getLast(lk);
-                    }
-                    else {
+                    // sampled on every pass, like the capped insert counter below: an oplog write
+                    // the cursor doesn't match must not leave later passes returning at once
+                    if (pass > 0) {
                         last.waitForDifferent(1000/*ms*/);
                     }
+                    mutex::scoped_lock lk(OpTime::m);
+                    last = OpTime::getLast(lk);
+                }
+                else {
+                    // other capped collections: sample the insert counter before locking so an
+                    // insert racing with our scan still wakes us on the next pass
+                    if (pass > 0) {
+                        NamespaceDetails::waitForCappedInsert(lastCappedInsert, 1000/*ms*/);
+                    }
+                    lastCappedInsert = NamespaceDetails::cappedInsertCount();
                 }
 
                 Client::ReadContext ctx(ns);
@@ -692,10 +701,8 @@ namespace mongo {
                 pass++;
                 if (debug)
                     sleepmillis(20);
-                else
-                    sleepmillis(2);
                 
-                // note: the 1100 is beacuse of the waitForDifferent above
+                // note: the 1100 is beacuse of the waitForDifferent / waitForCappedInsert above
                 // should eventually clean this up a bit
                 curop.setExpectedLatencyMs( 1100 + timer->millis() );
                 
@@ -0,0 +1,144 @@
+// @file intersectioncursor.cpp
+
+/**
+ *    Copyright (C) 2012 10gen Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pch.h"
+#include "intersectioncursor.h"
+
+namespace mongo {
+
+    IntersectionCursor::IntersectionCursor( const shared_ptr<Cursor> &primary,
+                                           const shared_ptr<Cursor> &secondary ) :
+        _primary( primary ),
+        _secondary( secondary ),
+        _secondaryName( secondary->toString() ),
+        _secondaryNscanned(),
+        _filtering(),
+        _abandoned() {
+        buildSome();
+        skipUnmatched();
+    }
+
+    void IntersectionCursor::buildSome() {
+        if ( !_secondary ) {
+            return;
+        }
+        for( int i = 0; i < BuildStep && _secondary->ok(); ++i, _secondary->advance() ) {
+            if ( (long long)_locs.size() >= MaxLocs ) {
+                _abandoned = true;
+                vector<DiskLoc>().swap( _locs );
+                break;
+            }
+            _locs.push_back( _secondary->currLoc() );
+        }
+        _secondaryNscanned = _secondary->nscanned();
+        if ( _abandoned ) {
+            _secondary.reset();
+        }
+        else if ( !_secondary->ok() ) {
+            sort( _locs.begin(), _locs.end() );
+            _locs.erase( unique( _locs.begin(), _locs.end() ), _locs.end() );
+            _filtering = true;
+            _secondary.reset();
+        }
+    }
+
+    void IntersectionCursor::skipUnmatched() {
+        if ( !_filtering ) {
+            return;
+        }
+        while( _primary->ok() &&
+              !binary_search( _locs.begin(), _locs.end(), _primary->currLoc() ) ) {
+            _primary->advance();
+        }
+    }
+
+    bool IntersectionCursor::advance() {
+        _primary->advance();
+        buildSome();
+        skipUnmatched();
+        return ok();
+    }
+
+    void IntersectionCursor::aboutToDeleteBucket( const DiskLoc &b ) {
+        _primary->aboutToDeleteBucket( b );
+        if ( _secondary ) {
+            _secondary->aboutToDeleteBucket( b );
+        }
+    }
+
+    void IntersectionCursor::noteLocation() {
+        _primary->noteLocation();
+        if ( _secondary ) {
+            _secondary->noteLocation();
+        }
+    }
+
+    void IntersectionCursor::checkLocation() {
+        _primary->checkLocation();
+        if ( _secondary ) {
+            _secondary->checkLocation();
+        }
+        skipUnmatched();
+    }
+
+    void IntersectionCursor::prepareToTouchEarlierIterate() {
+        _primary->prepareToTouchEarlierIterate();
+        if ( _secondary ) {
+            _secondary->prepareToTouchEarlierIterate();
+        }
+    }
+
+    void IntersectionCursor::recoverFromTouchingEarlierIterate() {
+        _primary->recoverFromTouchingEarlierIterate();
+        if ( _secondary ) {
+            _secondary->recoverFromTouchingEarlierIterate();
+        }
+        skipUnmatched();
+    }
+
+    bool IntersectionCursor::supportYields() {
+        return _primary->supportYields() && ( !_secondary || _secondary->supportYields() );
+    }
+
+    void IntersectionCursor::prepareToYield() {
+        _primary->prepareToYield();
+        if ( _secondary ) {
+            _secondary->prepareToYield();
+        }
+    }
+
+    void IntersectionCursor::recoverFromYield() {
+        _primary->recoverFromYield();
+        if ( _secondary ) {
+            _secondary->recoverFromYield();
+        }
+        skipUnmatched();
+    }
+
+    string IntersectionCursor::toString() {
+        return "IntersectionCursor " + _primary->toString() + " & " + _secondaryName;
+    }
+
+    void IntersectionCursor::explainDetails( BSONObjBuilder& b ) {
+        _primary->explainDetails( b );
+        b << "intersectedWith" << _secondaryName;
+        b << "intersectionSize" << (long long)_locs.size();
+        b << "intersectionAbandoned" << _abandoned;
+    }
+
+} // namespace mongo
@@ -0,0 +1,106 @@
+// @file intersectioncursor.h - Cursor restricting one index scan to the documents of another.
+
+/**
+ *    Copyright (C) 2012 10gen Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "cursor.h"
+#include "diskloc.h"
+
+namespace mongo {
+
+    /**
+     * Intersects the DiskLocs of two index scans before any document is fetched.
+     *
+     * The secondary cursor's DiskLocs are collected into a sorted vector a few at a time, BuildStep
+     * of them on construction and with every advance(), so no single call does unbounded work and
+     * the secondary scan yields along with the primary one.  Until the secondary scan is exhausted
+     * primary iterates are returned unfiltered; after that every iterate whose DiskLoc the
+     * secondary scan did not produce is skipped.  Iteration order, index keys and matching are all
+     * those of the primary cursor.  A plan that loses the plan race stops early, so it only pays
+     * for the part of the secondary scan it got through.
+     *
+     * If the secondary scan produces more than MaxLocs DiskLocs the intersection is abandoned and
+     * every primary iterate is returned, so memory stays bounded; such a plan will simply lose the
+     * plan race to the plain primary plan.
+     *
+     * This does not affect correctness because the query's matcher is still applied to each
+     * document: the secondary index's bounds are derived from the query, so every matching
+     * document the secondary scan passed over is in the set.
+     */
+    class IntersectionCursor : public Cursor {
+    public:
+        static const long long MaxLocs = 100 * 1000;
+        static const int BuildStep = 64;
+
+        IntersectionCursor( const shared_ptr<Cursor> &primary, const shared_ptr<Cursor> &secondary );
+
+        virtual bool ok() { return _primary->ok(); }
+        virtual Record* _current() { return _primary->_current(); }
+        virtual BSONObj current() { return _primary->current(); }
+        virtual DiskLoc currLoc() { return _primary->currLoc(); }
+        virtual bool advance();
+        virtual BSONObj currKey() const { return _primary->currKey(); }
+        virtual DiskLoc refLoc() { return _primary->refLoc(); }
+        virtual void aboutToDeleteBucket( const DiskLoc &b );
+        virtual BSONObj indexKeyPattern() { return _primary->indexKeyPattern(); }
+        virtual bool supportGetMore() { return _primary->supportGetMore(); }
+        virtual void noteLocation();
+        virtual void checkLocation();
+        virtual void prepareToTouchEarlierIterate();
+        virtual void recoverFromTouchingEarlierIterate();
+        virtual bool supportYields();
+        virtual void prepareToYield();
+        virtual void recoverFromYield();
+        virtual string toString();
+        virtual bool getsetdup( DiskLoc loc ) { return _primary->getsetdup( loc ); }
+        virtual bool isMultiKey() const { return _primary->isMultiKey(); }
+        virtual bool autoDedup() const { return _primary->autoDedup(); }
+        virtual bool modifiedKeys() const { return _primary->modifiedKeys(); }
+        virtual BSONObj prettyIndexBounds() const { return _primary->prettyIndexBounds(); }
+        virtual long long nscanned() { return _primary->nscanned() + _secondaryNscanned; }
+        virtual CoveredIndexMatcher *matcher() const { return _primary->matcher(); }
+        virtual shared_ptr<CoveredIndexMatcher> matcherPtr() const { return _primary->matcherPtr(); }
+        virtual void setMatcher( shared_ptr<CoveredIndexMatcher> matcher ) {
+            _primary->setMatcher( matcher );
+        }
+        virtual const Projection::KeyOnly *keyFieldsOnly() const { return _primary->keyFieldsOnly(); }
+        virtual void setKeyFieldsOnly( const shared_ptr<Projection::KeyOnly> &keyFieldsOnly ) {
+            _primary->setKeyFieldsOnly( keyFieldsOnly );
+        }
+        virtual void hydrateCurrKey( const Projection::KeyOnly &keyOnly, BSONObjBuilder &b ) const {
+            _primary->hydrateCurrKey( keyOnly, b );
+        }
+        virtual void explainDetails( BSONObjBuilder& b );
+
+    private:
+        /** collects up to BuildStep more DiskLocs from the secondary scan */
+        void buildSome();
+
+        /** advances the primary cursor past iterates not produced by the secondary scan */
+        void skipUnmatched();
+
+        shared_ptr<Cursor> _primary;
+        shared_ptr<Cursor> _secondary; // reset once the secondary scan is done with
+        string _secondaryName;
+        long long _secondaryNscanned;
+        bool _filtering;
+        bool _abandoned;
+        vector<DiskLoc> _locs; // sorted and unique once _filtering
+    };
+
+} // namespace mongo
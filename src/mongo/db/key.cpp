@@ -355,6 +355,67 @@ namespace mongo {
         dassert( (*_keyData & cNOTUSED) == 0 );
     }
 
+    /** appends the compact format element at p to b, named name, and advances p past it */
+    static void appendCompactElement(BSONObjBuilder& b, const char *name, const unsigned char *&p) {
+        unsigned bits = *p++;
+
+        switch( bits & 0x3f ) {
+            case cminkey: b.appendMinKey(name); break;
+            case cnull:   b.appendNull(name); break;
+            case cfalse:  b.appendBool(name, false); break;
+            case ctrue:   b.appendBool(name, true); break;
+            case cmaxkey: 
+                b.appendMaxKey(name); 
+                break;
+            case cstring:
+                {
+                    unsigned sz = *p++;
+                    // we build the element ourself as we have to null terminate it
+                    BufBuilder &bb = b.bb();
+                    bb.appendNum((char) String);
+                    bb.appendStr(name);
+                    bb.appendNum(sz+1);
+                    bb.appendBuf(p, sz);
+                    bb.appendUChar(0); // null char at end of string
+                    p += sz;
+                    break;
+                }
+            case coid:
+                b.appendOID(name, (OID *) p);
+                p += sizeof(OID);
+                break;
+            case cbindata:
+                {
+                    int len = binDataCodeToLength(*p);
+                    int subtype = (*p) & BinDataTypeMask;
+                    if( subtype & 0x8 ) { 
+                        subtype = (subtype & 0x7) | 0x80;
+                    }
+                    b.appendBinData(name, len, (BinDataType) subtype, ++p);
+                    p += len;
+                    break;
+                }
+            case cdate:
+                b.appendDate(name, (Date_t&) *p);
+                p += 8;
+                break;
+            case cdouble:
+                b.append(name, (double&) *p);
+                p += sizeof(double);
+                break;
+            case cint:
+                b.append(name, static_cast< int >((reinterpret_cast< const PackedDouble& >(*p)).d));
+                p += sizeof(double);
+                break;
+            case clong:
+                b.append(name, static_cast< long long>((reinterpret_cast< const PackedDouble& >(*p)).d));
+                p += sizeof(double);
+                break;
+            default:
+                verify(false);
+        }
+    }
+
     BSONObj KeyV1::toBson() const { 
         verify( _keyData != 0 );
         if( !isCompactFormat() )
@@ -363,64 +424,8 @@ namespace mongo {
         BSONObjBuilder b(512);
         const unsigned char *p = _keyData;
         while( 1 ) { 
-            unsigned bits = *p++;
-
-            switch( bits & 0x3f ) {
-                case cminkey: b.appendMinKey(""); break;
-                case cnull:   b.appendNull(""); break;
-                case cfalse:  b.appendBool("", false); break;
-                case ctrue:   b.appendBool("", true); break;
-                case cmaxkey: 
-                    b.appendMaxKey(""); 
-                    break;
-                case cstring:
-                    {
-                        unsigned sz = *p++;
-                        // we build the element ourself as we have to null terminate it
-                        BufBuilder &bb = b.bb();
-                        bb.appendNum((char) String);
-                        bb.appendUChar(0); // fieldname ""
-                        bb.appendNum(sz+1);
-                        bb.appendBuf(p, sz);
-                        bb.appendUChar(0); // null char at end of string
-                        p += sz;
-                        break;
-                    }
-                case coid:
-                    b.appendOID("", (OID *) p);
-                    p += sizeof(OID);
-                    break;
-                case cbindata:
-                    {
-                        int len = binDataCodeToLength(*p);
-                        int subtype = (*p) & BinDataTypeMask;
-                        if( subtype & 0x8 ) { 
-                            subtype = (subtype & 0x7) | 0x80;
-                        }
-                        b.appendBinData("", len, (BinDataType) subtype, ++p);
-                        p += len;
-                        break;
-                    }
-                case cdate:
-                    b.appendDate("", (Date_t&) *p);
-                    p += 8;
-                    break;
-                case cdouble:
-                    b.append("", (double&) *p);
-                    p += sizeof(double);
-                    break;
-                case cint:
-                    b.append("", static_cast< int >((reinterpret_cast< const PackedDouble& >(*p)).d));
-                    p += sizeof(double);
-                    break;
-                case clong:
-                    b.append("", static_cast< long long>((reinterpret_cast< const PackedDouble& >(*p)).d));
-                    p += sizeof(double);
-                    break;
-                default:
-                    verify(false);
-            }
-
+            unsigned bits = *p;
+            appendCompactElement(b, "", p);
             if( (bits & cHASMORE) == 0 )
                 break;
         }
@@ -604,6 +609,33 @@ namespace mongo {
         return p - _keyData;
     }
 
+    void KeyV1::appendElementsAs(BSONObjBuilder& b, const vector<bool>& include, const vector<string>& names) const {
+        verify( _keyData != 0 );
+        dassert( include.size() == names.size() );
+        if( !isCompactFormat() ) {
+            BSONObjIterator i(bson());
+            for( unsigned n = 0; i.more(); n++ ) {
+                verify( n < include.size() );
+                BSONElement e = i.next();
+                if( include[n] )
+                    b.appendAs(e, names[n]);
+            }
+            return;
+        }
+
+        const unsigned char *p = _keyData;
+        for( unsigned n = 0; ; n++ ) { 
+            verify( n < include.size() );
+            unsigned bits = *p;
+            if( include[n] )
+                appendCompactElement(b, names[n].c_str(), p);
+            else
+                p += sizeOfElement(p);
+            if( (bits & cHASMORE) == 0 )
+                break;
+        }
+    }
+
     bool KeyV1::woEqual(const KeyV1& right) const {
         const unsigned char *l = _keyData;
         const unsigned char *r = right._keyData;
@@ -76,6 +76,12 @@ namespace mongo {
         BSONObj toBson() const;
         string toString() const { return toBson().toString(); }
 
+        /**
+         * Appends the key's elements to b, the n-th named names[n] and skipped unless include[n],
+         * as appending toBson()'s elements would but without building that BSONObj.
+         */
+        void appendElementsAs(BSONObjBuilder& b, const vector<bool>& include, const vector<string>& names) const;
+
         /** get the key data we want to store in the btree bucket */
         const char * data() const { return (const char *) _keyData; }
 
@@ -59,12 +59,14 @@ namespace mongo {
     LockStat::Acquiring::Acquiring(LockStat& _ls, char t) : ls(_ls) { 
         type = mapNo(t);
         dassert( type < N );
+        ls.acquiring[type]++;
     }
 
     // note: we have race conditions on the following += 
     // hmmm....
 
     LockStat::Acquiring::~Acquiring() { 
+        ls.acquiring[type]--;
         ls.timeAcquiring[type] += tmr.micros();
         if( type == 1 ) 
             ls.W_Timer.reset();
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "util/timer.h"
+#include "mongo/bson/util/atomic_int.h"
 #include "mongo/platform/atomic_uint64.h"
 
 namespace mongo { 
@@ -41,12 +42,16 @@ namespace mongo {
 
         void unlocking(char type);
 
+        /** @return the number of threads currently acquiring the lock in mode type, RWrw */
+        unsigned numAcquiring(char type) const { return acquiring[mapNo(type)].get(); }
+
         BSONObj report() const;
 
     private:
         // RWrw
         AtomicUInt64 timeAcquiring[N];
         AtomicUInt64 timeLocked[N];
+        AtomicUInt acquiring[N];
 
         static unsigned mapNo(char type);
     };
@@ -145,6 +145,71 @@ namespace mongo {
         _where = 0;
     }
 
+    /**
+     * Hash of an element's value consistent with element_lt: elements comparing equal hash
+     * equal.  Types without a cheap canonical form hash by canonical type alone.
+     */
+    static size_t inSetHash( const BSONElement &e ) {
+        size_t h = e.canonicalType();
+        switch( e.type() ) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble: {
+            // Numbers of different types compare by value, as doubles.
+            double d = e.number();
+            if ( isNaN( d ) )
+                return h;
+            if ( d == 0 )
+                d = 0; // -0.0 == 0.0
+            boost::hash_combine( h, d );
+            return h;
+        }
+        case Code:
+        case Symbol:
+        case String:
+            boost::hash_combine( h, boost::hash_range( e.valuestr(),
+                                                       e.valuestr() + e.valuestrsize() ) );
+            return h;
+        case jstOID:
+            boost::hash_combine( h, boost::hash_range( e.value(), e.value() + 12 ) );
+            return h;
+        case Date:
+            boost::hash_combine( h, (long long)e.date().millis );
+            return h;
+        case Timestamp:
+            boost::hash_combine( h, e.date().millis );
+            return h;
+        case Bool:
+            boost::hash_combine( h, *e.value() );
+            return h;
+        default:
+            return h;
+        }
+    }
+
+    /** $in / $nin sets at least this large get a hash prefilter. */
+    static const unsigned InHashMinSize = 16;
+
+    /**
+     * Sets up the checks regexMatches() makes instead of, or before, running the regex.
+     * @param usePrefix if a regex that is only a literal prefix should be matched by comparison.
+     */
+    static void initRegexShortcuts( RegexMatcher &rm, bool usePrefix ) {
+        if ( usePrefix ) {
+            bool purePrefix;
+            string prefix = simpleRegex( rm._regex, rm._flags, &purePrefix );
+            if ( purePrefix )
+                rm._prefix = prefix;
+        }
+        rm._literal = regexRequiredLiteral( rm._regex, rm._flags );
+        rm._literalCaseless = strchr( rm._flags, 'i' ) != 0;
+        if ( rm._literalCaseless ) {
+            for( string::iterator i = rm._literal.begin(); i != rm._literal.end(); ++i ) {
+                *i = tolower( *i );
+            }
+        }
+    }
+
     ElementMatcher::ElementMatcher( BSONElement e , int op, bool isNot )
         : _toMatch( e ) , _compareOp( op ), _isNot( isNot ), _subMatcherOnPrimitives(false) {
         if ( op == BSONObj::opMOD ) {
@@ -197,10 +262,7 @@ namespace mongo {
                 rm._regex = ie.regex();
                 rm._flags = ie.regexFlags();
                 rm._isNot = false;
-                bool purePrefix;
-                string prefix = simpleRegex(rm._regex, rm._flags, &purePrefix);
-                if (purePrefix)
-                    rm._prefix = prefix;
+                initRegexShortcuts( rm, true );
             }
             else {
                 uassert( 15882, "$elemMatch not allowed within $in",
@@ -214,6 +276,19 @@ namespace mongo {
             uassert( 13020 , "with $all, can't mix $elemMatch and others" , _myset->size() == 0 && !_myregex.get());
         }
 
+        if ( ( op == BSONObj::opIN || op == BSONObj::NIN ) && _myset->size() >= InHashMinSize ) {
+            _myhashes.reset( new boost::unordered_set<size_t>() );
+            for( set<BSONElement,element_lt>::const_iterator i = _myset->begin(); i != _myset->end(); ++i ) {
+                _myhashes->insert( inSetHash( *i ) );
+            }
+        }
+    }
+
+    int ElementMatcher::inSetCount( const BSONElement &e ) const {
+        if ( _myhashes && _myhashes->count( inSetHash( e ) ) == 0 ) {
+            return 0;
+        }
+        return _myset->count( e );
     }
 
     int ElementMatcher::inverseOfNegativeCompareOp() const {
@@ -264,14 +339,8 @@ namespace mongo {
         rm._regex = regex;
         rm._flags = flags;
         rm._isNot = isNot;
+        initRegexShortcuts( rm, !isNot ); //TODO something smarter
         _regexs.push_back(rm);
-
-        if (!isNot) { //TODO something smarter
-            bool purePrefix;
-            string prefix = simpleRegex(regex, flags, &purePrefix);
-            if (purePrefix)
-                rm._prefix = prefix;
-        }
     }
 
     bool Matcher::addOp( const BSONElement &e, const BSONElement &fe, bool isNot, const char *& regex, const char *&flags ) {
@@ -531,6 +600,7 @@ namespace mongo {
         while ( i.more() ) {
             parseMatchExpressionElement( i.next(), nested );
         }
+        compile();
     }
 
     Matcher::Matcher( const Matcher &docMatcher, const BSONObj &key ) :
@@ -584,14 +654,136 @@ namespace mongo {
         for( list< shared_ptr< Matcher > >::const_iterator i = docMatcher._orMatchers.begin(); i != docMatcher._orMatchers.end(); ++i ) {
             _orMatchers.push_back( shared_ptr< Matcher >( new Matcher( **i, key ) ) );
         }
+        compile();
+    }
+
+    /** Relative cost of evaluating an ElementMatcher, lower values are cheaper or more selective. */
+    static int basicEvaluationRank( const ElementMatcher &bm ) {
+        switch( bm._compareOp ) {
+        case BSONObj::Equality:
+            return 0;
+        case BSONObj::opIN:
+            return 1;
+        case BSONObj::LT:
+        case BSONObj::LTE:
+        case BSONObj::GT:
+        case BSONObj::GTE:
+            return 2;
+        case BSONObj::opTYPE:
+        case BSONObj::opMOD:
+        case BSONObj::opSIZE:
+        case BSONObj::opEXISTS:
+            return 3;
+        case BSONObj::opALL:
+        case BSONObj::opELEM_MATCH:
+            return 5;
+        default:
+            return 4;
+        }
+    }
+
+    struct BasicRankLess {
+        BasicRankLess( const vector<ElementMatcher> &basics ) : _basics( basics ) {}
+        bool operator()( unsigned l, unsigned r ) const {
+            return basicEvaluationRank( _basics[ l ] ) < basicEvaluationRank( _basics[ r ] );
+        }
+        const vector<ElementMatcher> &_basics;
+    };
+
+    void Matcher::compile() {
+        _basicsOrder.clear();
+        _basicsField.clear();
+        _topLevelFields.clear();
+
+        for( unsigned i = 0; i < _basics.size(); ++i ) {
+            _basicsOrder.push_back( i );
+        }
+        stable_sort( _basicsOrder.begin(), _basicsOrder.end(), BasicRankLess( _basics ) );
+
+        // Index key matching locates fields using the key pattern, and $all has its own lookup.
+        for( unsigned i = 0; i < _basics.size(); ++i ) {
+            const ElementMatcher &bm = _basics[ i ];
+            const char *fieldName = bm._toMatch.fieldName();
+            int field = -1;
+            if ( _constrainIndexKey.isEmpty() && bm._compareOp != BSONObj::opALL &&
+                 !strchr( fieldName, '.' ) ) {
+                for( unsigned j = 0; j < _topLevelFields.size(); ++j ) {
+                    if ( strcmp( _topLevelFields[ j ], fieldName ) == 0 ) {
+                        field = j;
+                        break;
+                    }
+                }
+                if ( field < 0 && _topLevelFields.size() < MaxTopLevelFields ) {
+                    field = _topLevelFields.size();
+                    _topLevelFields.push_back( fieldName );
+                }
+            }
+            _basicsField.push_back( field );
+        }
+
+        // A single field is as cheap to find with getField() as with the combined pass.
+        if ( _topLevelFields.size() < 2 ) {
+            _topLevelFields.clear();
+            _basicsField.assign( _basics.size(), -1 );
+        }
+    }
+
+    inline char asciiLower( char c ) {
+        return ( c >= 'A' && c <= 'Z' ) ? c + ( 'a' - 'A' ) : c;
+    }
+
+    /**
+     * @return true if the len bytes at s contain literal, ignoring ascii case if caseless (in
+     * which case literal is lower case).
+     */
+    inline bool containsLiteral( const char *s, size_t len, const string &literal, bool caseless ) {
+        const size_t n = literal.size();
+        if ( n > len )
+            return false;
+        const char *end = s + len - n + 1; // one past the last possible start
+        const char first = literal[ 0 ];
+        if ( !caseless || !isalpha( (unsigned char)first ) ) {
+            // Find candidate positions with memchr, then compare the rest.
+            for( const char *p = s; p < end; ++p ) {
+                p = static_cast<const char *>( memchr( p, first, end - p ) );
+                if ( !p )
+                    return false;
+                if ( caseless ) {
+                    size_t i = 1;
+                    while( i < n && asciiLower( p[ i ] ) == literal[ i ] )
+                        ++i;
+                    if ( i == n )
+                        return true;
+                }
+                else if ( memcmp( p + 1, literal.data() + 1, n - 1 ) == 0 ) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        for( const char *p = s; p < end; ++p ) {
+            size_t i = 0;
+            while( i < n && asciiLower( p[ i ] ) == literal[ i ] )
+                ++i;
+            if ( i == n )
+                return true;
+        }
+        return false;
     }
 
     inline bool regexMatches(const RegexMatcher& rm, const BSONElement& e) {
         switch (e.type()) {
         case String:
         case Symbol:
-            if (rm._prefix.empty())
+            if (rm._prefix.empty()) {
+                // Most non matching values lack the literal, and are rejected without PCRE.
+                if ( !rm._literal.empty() &&
+                     !containsLiteral( e.valuestr(), e.valuestrsize() - 1, rm._literal,
+                                       rm._literalCaseless ) ) {
+                    return false;
+                }
                 return rm._re->PartialMatch(e.valuestr());
+            }
             else
                 return !strncmp(e.valuestr(), rm._prefix.c_str(), rm._prefix.size());
         case RegEx:
@@ -610,7 +802,7 @@ namespace mongo {
 
         if ( op == BSONObj::opIN ) {
             // { $in : [1,2,3] }
-            int count = bm._myset->count(l);
+            int count = bm.inSetCount(l);
             if ( count )
                 return count;
             if ( bm._myregex.get() ) {
@@ -833,6 +1025,12 @@ namespace mongo {
             }
         }
 
+        return matchesElement( e, toMatch, compareOp, em, indexed, details );
+    }
+
+    int Matcher::matchesElement( const BSONElement &e, const BSONElement &toMatch, int compareOp,
+                                 const ElementMatcher &em, bool indexed,
+                                 MatchDetails *details ) const {
         if ( compareOp == BSONObj::opEXISTS ) {
             if( e.eoo() ) {
                 return 0;
@@ -890,6 +1088,20 @@ namespace mongo {
         return -1;
     }
 
+    int Matcher::matchesTopLevel( const BSONElement &e, const ElementMatcher &bm,
+                                  MatchDetails *details ) const {
+        if ( bm.negativeCompareOp() ) {
+            // As inverseMatch(), on the located element.
+            int inverseRet = matchesElement( e, bm._toMatch, bm.inverseOfNegativeCompareOp(), bm,
+                                             false, details );
+            if ( bm.negativeCompareOpContainsNull() ) {
+                return ( inverseRet <= 0 ) ? 1 : 0;
+            }
+            return -inverseRet;
+        }
+        return matchesElement( e, bm._toMatch, bm._compareOp, bm, false, details );
+    }
+
     extern int dump;
 
     /* See if an object matches the query.
@@ -906,12 +1118,37 @@ namespace mongo {
         /* assuming there is usually only one thing to match.  if more this
            could be slow sometimes. */
 
+        // Locate all the top level fields the basics need in a single pass over the document.
+        BSONElement topLevel[ MaxTopLevelFields ];
+        unsigned unlocated = _topLevelFields.size();
+        if ( unlocated ) {
+            BSONObjIterator it( jsobj );
+            while ( unlocated && it.more() ) {
+                BSONElement e = it.next();
+                const char *name = e.fieldName();
+                for( unsigned j = 0; j < _topLevelFields.size(); ++j ) {
+                    if ( topLevel[ j ].eoo() && strcmp( name, _topLevelFields[ j ] ) == 0 ) {
+                        topLevel[ j ] = e;
+                        --unlocated;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // The order of evaluation only affects which elemMatchKey is reported, so basics are
+        // checked cheapest first unless that key is wanted.
+        bool declaredOrder = details && details->needRecord();
+
         // check normal non-regex cases:
-        for ( unsigned i = 0; i < _basics.size(); i++ ) {
+        for ( unsigned n = 0; n < _basics.size(); n++ ) {
+            unsigned i = declaredOrder ? n : _basicsOrder[ n ];
             const ElementMatcher& bm = _basics[i];
             const BSONElement& m = bm._toMatch;
             // -1=mismatch. 0=missing element. 1=match
-            int cmp = matchesDotted(m.fieldName(), m, jsobj, bm._compareOp, bm , false , details );
+            int cmp = _basicsField[ i ] >= 0 ?
+                    matchesTopLevel( topLevel[ _basicsField[ i ] ], bm, details ) :
+                    matchesDotted(m.fieldName(), m, jsobj, bm._compareOp, bm , false , details );
             if ( cmp == 0 && bm._compareOp == BSONObj::opEXISTS ) {
                 // If missing, match cmp is opposite of $exists spec.
                 cmp = -retExistsFound(bm);
@@ -22,6 +22,7 @@
 
 #include "jsobj.h"
 #include "pcrecpp.h"
+#include <boost/unordered_set.hpp>
 
 namespace mongo {
 
@@ -37,9 +38,11 @@ namespace mongo {
         const char *_regex;
         const char *_flags;
         string _prefix;
+        string _literal;        // required in every match, checked before running _re
+        bool _literalCaseless;  // _literal is lower case and compared ignoring ascii case
         shared_ptr< pcrecpp::RE > _re;
         bool _isNot;
-        RegexMatcher() : _isNot() {}
+        RegexMatcher() : _literalCaseless(), _isNot() {}
     };
 
     struct element_lt {
@@ -79,11 +82,16 @@ namespace mongo {
         bool negativeCompareOpContainsNull() const;
         
         void visit( MatcherVisitor& visitor ) const;
+
+        /** @return nonzero if e is one of the $in / $nin / $all values. */
+        int inSetCount( const BSONElement &e ) const;
         
         BSONElement _toMatch;
         int _compareOp;
         bool _isNot;
         shared_ptr< set<BSONElement,element_lt> > _myset;
+        // hashes of the _myset values, built for large sets so most misses skip the set lookup
+        shared_ptr< boost::unordered_set<size_t> > _myhashes;
         shared_ptr< vector<RegexMatcher> > _myregex;
 
         // these are for specific operators
@@ -243,6 +251,20 @@ namespace mongo {
 
         int valuesMatch(const BSONElement& l, const BSONElement& r, int op, const ElementMatcher& bm) const;
 
+        /** Match an already located field value, as matchesDotted() does once it finds e. */
+        int matchesElement( const BSONElement &e, const BSONElement &toMatch, int compareOp,
+                            const ElementMatcher &em, bool indexed, MatchDetails *details ) const;
+        /** Match a top level field value located by the single pass in matches(). */
+        int matchesTopLevel( const BSONElement &e, const ElementMatcher &bm,
+                             MatchDetails *details ) const;
+
+        /**
+         * Precompute how matches() evaluates _basics: the order in which they are checked and
+         * which of them read a top level field that can be located in one pass over the document.
+         * Must be called once _basics is final.
+         */
+        void compile();
+
         bool parseClause( const BSONElement &e );
         void parseExtractedClause( const BSONElement &e, list< shared_ptr< Matcher > > &matchers );
 
@@ -253,6 +275,10 @@ namespace mongo {
         BSONObj _jsobj;                  // the query pattern.  e.g., { name: "joe" }
         BSONObj _constrainIndexKey;
         vector<ElementMatcher> _basics;
+        static const unsigned MaxTopLevelFields = 8;
+        vector<unsigned> _basicsOrder;   // _basics indexes, cheapest and most selective first
+        vector<int> _basicsField;        // index into _topLevelFields per basic, or -1
+        vector<const char *> _topLevelFields;
         bool _haveSize;
         bool _all;
         bool _hasArray;
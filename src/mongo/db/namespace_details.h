@@ -167,6 +167,11 @@ namespace mongo {
         bool capLooped() const { return _isCapped && capFirstNewRecord.isValid();  }
         bool inCapExtent( const DiskLoc &dl ) const;
         void cappedCheckMigrate();
+        /** @return number of capped collection allocations since startup.  tailable cursors using
+            QueryOption_AwaitData wait for this to change rather than polling. */
+        static unsigned long long cappedInsertCount();
+        /** blocks until cappedInsertCount() != lastSeen or millis have elapsed */
+        static void waitForCappedInsert( unsigned long long lastSeen, unsigned millis );
         /**
          * Truncate documents newer than the document at 'end' from the capped
          * collection.  The collection cannot be completely emptied using this
@@ -20,6 +20,7 @@
 
 #include "../client.h"
 #include "../clientcursor.h"
+#include "../btree.h"
 #include "../namespace.h"
 #include "../queryutil.h"
 #include "mongo/client/dbclientinterface.h"
@@ -53,6 +54,9 @@ namespace mongo {
         shared_ptr<Cursor> cursor =
         NamespaceDetailsTransient::getCursor( ns, query, BSONObj(), QueryPlanSelectionPolicy::any(),
                                              &simpleEqualityMatch );
+        // Exact key matches on a btree are counted a bucket at a time.
+        BtreeCursor *btreeCursor =
+                simpleEqualityMatch ? dynamic_cast<BtreeCursor*>( cursor.get() ) : 0;
         ClientCursor::Holder ccPointer;
         ElapsedTracker timeToStartYielding( 256, 20 );
         try {
@@ -76,7 +80,17 @@ namespace mongo {
                 // NOTE In the distant past we used a min/max bounded BtreeCursor with a shallow
                 // equality comparison to check for matches in the simple match case.  That may be
                 // more performant, but I don't think we've measured the performance.
-                if ( simpleEqualityMatch ||
+                if ( btreeCursor ) {
+                    long long n = 1 + btreeCursor->skipEqualKeysInBucket();
+                    long long skipped = std::min( skip, n );
+                    skip -= skipped;
+                    count += n - skipped;
+                    if ( limit > 0 && count >= limit ) {
+                        count = limit;
+                        break;
+                    }
+                }
+                else if ( simpleEqualityMatch ||
                     ( cursor->currentMatches() && !cursor->getsetdup( cursor->currLoc() ) ) ) {
                     
                     if ( skip > 0 ) {
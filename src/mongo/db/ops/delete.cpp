@@ -24,7 +24,70 @@
 #include "mongo/util/stacktrace.h"
 
 namespace mongo {
-    
+
+    /** Matching documents a multi remove collects before deleting them together. */
+    static const unsigned DeleteBatchSize = 128;
+
+    void noteWriteForSharding( const char *ns, const BSONObj& doc, int bytes ); // from s/d_logic.h
+
+    static void logDelete( const char *ns, const DiskLoc& rloc ) {
+        BSONObj doc = BSONObj::make( rloc.rec() );
+        noteWriteForSharding( ns, doc, doc.objsize() );
+
+        BSONElement e;
+        if( doc.getObjectID( e ) ) {
+            BSONObjBuilder b;
+            b.append( e );
+            bool replJustOne = true;
+            logOp( "d", ns, b.done(), 0, &replJustOne );
+        }
+        else {
+            problem() << "deleted object without id, not logging" << endl;
+        }
+    }
+
+    /** Deletes a batch of documents, so each index is updated in a single pass. */
+    static long long deleteBatch( const char *ns, vector<DiskLoc>& batch, set<DiskLoc>& batched,
+                                  bool logop, RemoveSaver *rs ) {
+        for( vector<DiskLoc>::const_iterator i = batch.begin(); i != batch.end(); ++i ) {
+            if ( logop )
+                logDelete( ns, *i );
+            if ( rs )
+                rs->goingToDelete( i->obj() );
+        }
+        theDataFileMgr.deleteRecords( ns, batch );
+        long long n = batch.size();
+        batch.clear();
+        batched.clear();
+        return n;
+    }
+
+    /** Deletes the pending batch before a yield, so none of its documents can change meanwhile. */
+    class DeleteBatchYieldCallback : public ClientCursor::YieldCallback {
+    public:
+        DeleteBatchYieldCallback( const char *ns, ClientCursor *cc, vector<DiskLoc>& batch,
+                                  set<DiskLoc>& batched, bool logop, RemoveSaver *rs,
+                                  long long& nDeleted ) :
+            _ns( ns ), _cc( cc ), _batch( batch ), _batched( batched ), _logop( logop ), _rs( rs ),
+            _nDeleted( nDeleted ) {
+        }
+        virtual void aboutToYield() {
+            if ( _batch.empty() )
+                return;
+            _cc->c()->prepareToTouchEarlierIterate();
+            _nDeleted += deleteBatch( _ns, _batch, _batched, _logop, _rs );
+            _cc->c()->recoverFromTouchingEarlierIterate();
+        }
+    private:
+        const char *_ns;
+        ClientCursor *_cc;
+        vector<DiskLoc>& _batch;
+        set<DiskLoc>& _batched;
+        bool _logop;
+        RemoveSaver *_rs;
+        long long& _nDeleted;
+    };
+
     /* ns:      namespace, e.g. <database>.<collection>
        pattern: the "where" clause / criteria
        justOne: stop after 1 match
@@ -67,6 +130,12 @@ namespace mongo {
 
         bool canYield = !god && !(creal->matcher() && creal->matcher()->docMatcher().atomic());
 
+        // Documents matched but not yet deleted.  They are deleted before any yield, so they
+        // cannot change underneath us.
+        vector<DiskLoc> batch;
+        set<DiskLoc> batched;
+        DeleteBatchYieldCallback flushBeforeYield( ns, cc.get(), batch, batched, logop, rs, nDeleted );
+
         do {
             // TODO: we can generalize this I believe
             //       
@@ -80,7 +149,8 @@ namespace mongo {
                     willNeedRecord = true;
             }
             
-            if ( canYield && ! cc->yieldSometimes( willNeedRecord ? ClientCursor::WillNeed : ClientCursor::MaybeCovered ) ) {
+            if ( canYield && ! cc->yieldSometimes( willNeedRecord ? ClientCursor::WillNeed : ClientCursor::MaybeCovered,
+                                                   0, &flushBeforeYield ) ) {
                 cc.release(); // has already been deleted elsewhere
                 // TODO should we assert or something?
                 break;
@@ -108,45 +178,49 @@ namespace mongo {
                 cc->advance();
             }
             
-            bool foundAllResults = ( justOne || !cc->ok() );
+            if ( !justOne ) {
+                // A multikey scan may return a batched document again.
+                if ( !batched.insert( rloc ).second )
+                    continue;
+                batch.push_back( rloc );
+                if ( batch.size() < DeleteBatchSize && cc->ok() )
+                    continue;
+
+                bool more = cc->ok();
+                if ( more ) {
+                    // NOTE: Saving and restoring a btree cursor's position was historically
+                    // described as slow here.
+                    cc->c()->prepareToTouchEarlierIterate();
+                }
+                nDeleted += deleteBatch( ns, batch, batched, logop, rs );
+                if ( !more )
+                    break;
+                cc->c()->recoverFromTouchingEarlierIterate();
 
-            if ( !foundAllResults ) {
-                // NOTE: Saving and restoring a btree cursor's position was historically described
-                // as slow here.
-                cc->c()->prepareToTouchEarlierIterate();
-            }
+                if( !god )
+                    getDur().commitIfNeeded();
 
-            if ( logop ) {
-                BSONElement e;
-                if( BSONObj::make( rloc.rec() ).getObjectID( e ) ) {
-                    BSONObjBuilder b;
-                    b.append( e );
-                    bool replJustOne = true;
-                    logOp( "d", ns, b.done(), 0, &replJustOne );
-                }
-                else {
-                    problem() << "deleted object without id, not logging" << endl;
-                }
+                if( debug && god && nDeleted == DeleteBatchSize )
+                    log() << "warning high number of deletes with god=true which could use significant memory" << endl;
+                continue;
             }
 
+            if ( logop )
+                logDelete( ns, rloc );
+
             if ( rs )
                 rs->goingToDelete( rloc.obj() /*cc->c->current()*/ );
 
             theDataFileMgr.deleteRecord(ns, rloc.rec(), rloc);
             nDeleted++;
-            if ( foundAllResults ) {
-                break;
-            }
-            cc->c()->recoverFromTouchingEarlierIterate();
-         
-            if( !god ) 
-                getDur().commitIfNeeded();
-
-            if( debug && god && nDeleted == 100 ) 
-                log() << "warning high number of deletes with god=true which could use significant memory" << endl;
+            break;
         }
         while ( cc->ok() );
 
+        // The scan ended on a document that did not match.
+        if ( !batch.empty() )
+            nDeleted += deleteBatch( ns, batch, batched, logop, rs );
+
         if ( cc.get() && ClientCursor::find( id , false ) == 0 ) {
             // TODO: remove this and the id declaration above if this doesn't trigger
             //       if it does, then i'm very confused (ERH 06/2011)
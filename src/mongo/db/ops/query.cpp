@@ -29,6 +29,7 @@
 #include "../../s/d_logic.h"
 #include "../../server.h"
 #include "../queryoptimizercursor.h"
+#include "../stats/counters.h"
 
 namespace mongo {
 
@@ -91,6 +92,7 @@ namespace mongo {
         int resultFlags = ResultFlag_AwaitCapable;
         int start = 0;
         int n = 0;
+        bool covered = false;
 
         if ( unlikely(!cc) ) {
             LOGSOME << "getMore: cursorid not found " << ns << " " << cursorid << endl;
@@ -115,6 +117,10 @@ namespace mongo {
 
             // This manager may be stale, but it's the state of chunking when the cursor was created.
             ShardChunkManagerPtr manager = cc->getChunkManager();
+            // Every document is in a chunk unless the shard holds orphans, or gets some while
+            // yielding.
+            unsigned orphanEpoch = shardingState.orphanEpoch();
+            bool filterOrphans = manager && shardingState.holdsOrphans( ns , manager );
 
             while ( 1 ) {
                 if ( !c->ok() ) {
@@ -143,7 +149,7 @@ namespace mongo {
                 // in some cases (clone collection) there won't be a matcher
                 if ( !c->currentMatches() ) {
                 }
-                else if ( manager && ! manager->belongsToMe( cc ) ){
+                else if ( filterOrphans && ! manager->belongsToMe( cc ) ){
                     LOG(2) << "cursor skipping document in un-owned chunk: " << c->current() << endl;
                 }
                 else {
@@ -154,7 +160,9 @@ namespace mongo {
                         last = c->currLoc();
                         n++;
 
-                        cc->fillQueryResultFromObj( b );
+                        if ( cc->fillQueryResultFromObj( b ) ) {
+                            covered = true;
+                        }
 
                         if ( ( ntoreturn && n >= ntoreturn ) || b.len() > MaxBytesToReturnToClientAtOnce ) {
                             c->advance();
@@ -172,6 +180,9 @@ namespace mongo {
                     cc = 0;
                     break;
                 }
+
+                if ( manager && ! filterOrphans && shardingState.orphanEpoch() != orphanEpoch )
+                    filterOrphans = true;
             }
             
             if ( cc ) {
@@ -188,6 +199,10 @@ namespace mongo {
             }
         }
 
+        if ( covered ) {
+            globalCoveredQueryCounters.gotGetMore();
+        }
+
         QueryResult *qr = (QueryResult *) b.buf();
         qr->len = b.len();
         qr->setOperation(opReply);
@@ -309,13 +324,31 @@ namespace mongo {
         return ret;
     }
 
+    bool ResponseBuildStrategy::fillCovered( const DiskLoc *loc ) {
+        if ( _parsedQuery.returnKey() ) {
+            return false;
+        }
+        const Projection::KeyOnly *keyFieldsOnly = _cursor->keyFieldsOnly();
+        if ( !keyFieldsOnly ) {
+            return false;
+        }
+        BSONObjBuilder b( _buf );
+        _cursor->hydrateCurrKey( *keyFieldsOnly, b );
+        if ( loc ) {
+            b.append( "$diskLoc", loc->toBSONObj() );
+        }
+        b.done();
+        return true;
+    }
+
     OrderedBuildStrategy::OrderedBuildStrategy( const ParsedQuery &parsedQuery,
                                                const shared_ptr<Cursor> &cursor,
                                                BufBuilder &buf,
                                                const QueryPlanSummary &queryPlan ) :
     ResponseBuildStrategy( parsedQuery, cursor, buf, queryPlan ),
     _skip( _parsedQuery.getSkip() ),
-    _bufferedMatches() {
+    _bufferedMatches(),
+    _coveredMatches() {
     }
     
     bool OrderedBuildStrategy::handleMatch( bool &orderedMatch ) {
@@ -329,8 +362,13 @@ namespace mongo {
         }
         // Explain does not obey soft limits, so matches should not be buffered.
         if ( !_parsedQuery.isExplain() ) {
-            fillQueryResultFromObj( _buf, _parsedQuery.getFields(), current( true ),
-                                   ( _parsedQuery.showDiskLoc() ? &loc : 0 ) );
+            const DiskLoc *showLoc = _parsedQuery.showDiskLoc() ? &loc : 0;
+            if ( fillCovered( showLoc ) ) {
+                ++_coveredMatches;
+            }
+            else {
+                fillQueryResultFromObj( _buf, _parsedQuery.getFields(), current( true ), showLoc );
+            }
             ++_bufferedMatches;
         }
         return orderedMatch = true;
@@ -339,9 +377,10 @@ namespace mongo {
     ReorderBuildStrategy::ReorderBuildStrategy( const ParsedQuery &parsedQuery,
                                                const shared_ptr<Cursor> &cursor,
                                                BufBuilder &buf,
-                                               const QueryPlanSummary &queryPlan ) :
+                                               const QueryPlanSummary &queryPlan,
+                                               bool allowSpill ) :
     ResponseBuildStrategy( parsedQuery, cursor, buf, queryPlan ),
-    _scanAndOrder( newScanAndOrder( queryPlan ) ),
+    _scanAndOrder( newScanAndOrder( queryPlan, allowSpill ) ),
     _bufferedMatches() {
     }
 
@@ -361,14 +400,23 @@ namespace mongo {
 
     int ReorderBuildStrategy::rewriteMatches() {
         cc().curop()->debug().scanAndOrder = true;
+        if ( _parsedQuery.isExplain() && _scanAndOrder->spilled() ) {
+            // Explain only reports the number of results, which need not be merged from disk.
+            return _scanAndOrder->nResults();
+        }
         int ret = 0;
         _scanAndOrder->fill( _buf, _parsedQuery.getFields(), ret );
         _bufferedMatches = ret;
         return ret;
     }
+
+    shared_ptr<Cursor> ReorderBuildStrategy::remainingMatches() const {
+        return _scanAndOrder->remainingResults();
+    }
     
     ScanAndOrder *
-    ReorderBuildStrategy::newScanAndOrder( const QueryPlanSummary &queryPlan ) const {
+    ReorderBuildStrategy::newScanAndOrder( const QueryPlanSummary &queryPlan,
+                                          bool allowSpill ) const {
         verify( !_parsedQuery.getOrder().isEmpty() );
         verify( _cursor->ok() );
         const FieldRangeSet *fieldRangeSet = 0;
@@ -383,15 +431,18 @@ namespace mongo {
         return new ScanAndOrder( _parsedQuery.getSkip(),
                                 _parsedQuery.getNumToReturn(),
                                 _parsedQuery.getOrder(),
-                                *fieldRangeSet );
+                                *fieldRangeSet,
+                                allowSpill );
     }
     
+    // The out of order plans do not spill: on a memory assertion they are aborted and the in order
+    // plan is left to run.
     HybridBuildStrategy::HybridBuildStrategy( const ParsedQuery &parsedQuery,
                                              const shared_ptr<QueryOptimizerCursor> &cursor,
                                              BufBuilder &buf ) :
     ResponseBuildStrategy( parsedQuery, cursor, buf, QueryPlanSummary() ),
     _orderedBuild( _parsedQuery, _cursor, _buf, QueryPlanSummary() ),
-    _reorderBuild( _parsedQuery, _cursor, _buf, QueryPlanSummary() ),
+    _reorderBuild( _parsedQuery, _cursor, _buf, QueryPlanSummary(), false ),
     _reorderedMatches() {
     }
     
@@ -444,6 +495,10 @@ namespace mongo {
     void HybridBuildStrategy::finishedFirstBatch() {
         _queryOptimizerCursor->abortOutOfOrderPlans();
     }
+
+    int HybridBuildStrategy::coveredMatches() const {
+        return _reorderedMatches ? 0 : _orderedBuild.coveredMatches();
+    }
     
     QueryResponseBuilder *QueryResponseBuilder::make( const ParsedQuery &parsedQuery,
                                                      const shared_ptr<Cursor> &cursor,
@@ -515,6 +570,9 @@ namespace mongo {
             _buf.decouple();
             return 1;
         }
+        if ( _builder->coveredMatches() > 0 ) {
+            globalCoveredQueryCounters.gotQuery();
+        }
         if ( _buf.len() > 0 ) {
             result.appendData( _buf.buf(), _buf.len() );
             _buf.decouple();
@@ -567,8 +625,10 @@ namespace mongo {
         }
         if ( singlePlan ||
             !queryOptimizerPlans.mayRunInOrderPlan() ) {
+            // Spilled results are returned through getMore, so spill only if it is allowed.
+            bool allowSpill = _parsedQuery.wantMore() && _cursor->supportGetMore();
             return shared_ptr<ResponseBuildStrategy>
-            ( new ReorderBuildStrategy( _parsedQuery, _cursor, _buf, queryPlan ) );
+            ( new ReorderBuildStrategy( _parsedQuery, _cursor, _buf, queryPlan, allowSpill ) );
         }
         return shared_ptr<ResponseBuildStrategy>
         ( new HybridBuildStrategy( _parsedQuery, _queryOptimizerCursor, _buf ) );
@@ -588,7 +648,11 @@ namespace mongo {
             return true;
         }
         // TODO: should make this covered at some point
-        if ( _chunkManager->belongsToMe( _cursor->current() ) ) {
+        BSONObj obj = _cursor->current();
+        // The chunk is needed for the load statistics anyway, so the same lookup filters orphans.
+        int chunk = _chunkManager->filter().find( obj );
+        if ( chunk >= 0 ) {
+            shardingState.noteChunkOp( _parsedQuery.ns(), *_chunkManager, chunk, false, obj.objsize() );
             return true;
         }
         _explain->noteIterate( false, false, true, true );
@@ -706,6 +770,17 @@ namespace mongo {
 
         int nReturned = queryResponseBuilder->handoff( result );
 
+        // Sorted results that did not fit in the first batch are returned from disk by getMore.
+        // Chunk filtering was already applied while sorting.
+        long long nscanned = ( cursor ? cursor->nscanned() : 0LL );
+        ShardChunkManagerPtr chunkManager = queryResponseBuilder->chunkManager();
+        shared_ptr<Cursor> remainingMatches = queryResponseBuilder->remainingMatches();
+        if ( remainingMatches && !pq.isExplain() ) {
+            cursor = remainingMatches;
+            chunkManager.reset();
+            saveClientCursor = true;
+        }
+
         ccPointer.reset();
         long long cursorid = 0;
         if ( saveClientCursor ) {
@@ -740,7 +815,7 @@ namespace mongo {
             }
             
             // Set attributes for getMore.
-            ccPointer->setChunkManager( queryResponseBuilder->chunkManager() );
+            ccPointer->setChunkManager( chunkManager );
             ccPointer->setPos( nReturned );
             ccPointer->pq = pq_shared;
             ccPointer->fields = pq.getFieldPtr();
@@ -760,7 +835,7 @@ namespace mongo {
         int duration = curop.elapsedMillis();
         bool dbprofile = curop.shouldDBProfile( duration );
         if ( dbprofile || duration >= cmdLine.slowMS ) {
-            curop.debug().nscanned = ( cursor ? cursor->nscanned() : 0LL );
+            curop.debug().nscanned = nscanned;
             curop.debug().ntoskip = pq.getSkip();
         }
         curop.debug().nreturned = nReturned;
@@ -869,13 +944,17 @@ namespace mongo {
                 
                 if ( shardingState.needShardChunkManager( ns ) ) {
                     ShardChunkManagerPtr m = shardingState.getShardChunkManager( ns );
-                    if ( m && ! m->belongsToMe( resObject ) ) {
+                    int chunk = m ? m->filter().find( resObject ) : -1;
+                    if ( m && chunk < 0 ) {
                         // I have something this _id
                         // but it doesn't belong to me
                         // so return nothing
                         resObject = BSONObj();
                         found = false;
                     }
+                    else if ( m && found ) {
+                        shardingState.noteChunkOp( ns , *m , chunk , false , resObject.objsize() );
+                    }
                 }
 
                 BufBuilder bb(sizeof(QueryResult)+resObject.objsize()+32);
@@ -145,11 +145,18 @@ namespace mongo {
         virtual int rewriteMatches() { return -1; }
         /** @return the number of matches that have been written to the buffer. */
         virtual int bufferedMatches() const = 0;
+        /**
+         * @return a cursor over matches produced by rewriteMatches() but not written to the
+         * buffer, or an empty pointer if there are none.
+         */
+        virtual shared_ptr<Cursor> remainingMatches() const { return shared_ptr<Cursor>(); }
         /**
          * Callback when enough results have been read for the first batch, with potential handoff
          * to getMore.
          */
         virtual void finishedFirstBatch() {}
+        /** @return the number of buffered matches that were read from an index key alone. */
+        virtual int coveredMatches() const { return 0; }
         /** Reset the buffer. */
         void resetBuf();
     protected:
@@ -158,6 +165,12 @@ namespace mongo {
          * @param allowCovered - enable covered index support.
          */
         BSONObj current( bool allowCovered ) const;
+        /**
+         * Write the current iterate to the buffer straight from its index key, if the cursor
+         * supports a covered index projection.
+         * @return true if written.
+         */
+        bool fillCovered( const DiskLoc *loc );
         const ParsedQuery &_parsedQuery;
         shared_ptr<Cursor> _cursor;
         shared_ptr<QueryOptimizerCursor> _queryOptimizerCursor;
@@ -171,9 +184,11 @@ namespace mongo {
                              BufBuilder &buf, const QueryPlanSummary &queryPlan );
         virtual bool handleMatch( bool &orderedMatch );
         virtual int bufferedMatches() const { return _bufferedMatches; }
+        virtual int coveredMatches() const { return _coveredMatches; }
     private:
         int _skip;
         int _bufferedMatches;
+        int _coveredMatches;
     };
     
     class ScanAndOrder;
@@ -181,17 +196,23 @@ namespace mongo {
     /** Build strategy for a cursor returning out of order results. */
     class ReorderBuildStrategy : public ResponseBuildStrategy {
     public:
+        /**
+         * @param allowSpill - sort results that do not fit in memory on disk, returning them
+         * through remainingMatches(), rather than failing the query.
+         */
         ReorderBuildStrategy( const ParsedQuery &parsedQuery,
                              const shared_ptr<Cursor> &cursor,
                              BufBuilder &buf,
-                             const QueryPlanSummary &queryPlan );
+                             const QueryPlanSummary &queryPlan,
+                             bool allowSpill );
         virtual bool handleMatch( bool &orderedMatch );
         /** Handle a match without performing deduping. */
         void _handleMatchNoDedup();
         virtual int rewriteMatches();
         virtual int bufferedMatches() const { return _bufferedMatches; }
+        virtual shared_ptr<Cursor> remainingMatches() const;
     private:
-        ScanAndOrder *newScanAndOrder( const QueryPlanSummary &queryPlan ) const;
+        ScanAndOrder *newScanAndOrder( const QueryPlanSummary &queryPlan, bool allowSpill ) const;
         shared_ptr<ScanAndOrder> _scanAndOrder;
         int _bufferedMatches;
     };
@@ -222,6 +243,7 @@ namespace mongo {
         virtual int rewriteMatches();
         virtual int bufferedMatches() const;
         virtual void finishedFirstBatch();
+        virtual int coveredMatches() const;
         bool handleReorderMatch();
         DiskLocDupSet _scanAndOrderDups;
         OrderedBuildStrategy _orderedBuild;
@@ -261,6 +283,11 @@ namespace mongo {
          * @return the number of results in the buffer.
          */
         int handoff( Message &result );
+        /**
+         * @return a cursor over sorted results not included by handoff(), which should be
+         * iterated by getMore in place of the query's cursor.
+         */
+        shared_ptr<Cursor> remainingMatches() const { return _builder->remainingMatches(); }
         /** A chunk manager found at the beginning of the query. */
         ShardChunkManagerPtr chunkManager() const { return _chunkManager; }
 
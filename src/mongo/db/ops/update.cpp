@@ -31,6 +31,8 @@
 
 namespace mongo {
 
+    void noteWriteForSharding( const char *ns, const BSONObj& doc, int bytes ); // from s/d_logic.h
+
     void checkNoMods( BSONObj o ) {
         BSONObjIterator i( o );
         while( i.moreWithEOO() ) {
@@ -51,6 +53,14 @@ namespace mongo {
              - not mods is indexed
              - not upsert
     */
+    /**
+     * @return bytes of r past the end of onDisk, which an in place update may grow into.  Capped
+     * collection documents may not grow, so none are available there.
+     */
+    static int inPlaceSlack( const NamespaceDetails* d, Record* r, const BSONObj& onDisk ) {
+        return d->isCapped() ? 0 : r->netLength() - onDisk.objsize();
+    }
+
     static UpdateResult _updateById(bool isOperatorUpdate,
                                     int idIdxNo,
                                     ModSet* mods,
@@ -85,7 +95,9 @@ namespace mongo {
            regular ones at the moment. */
         if ( isOperatorUpdate ) {
             const BSONObj& onDisk = loc.obj();
-            auto_ptr<ModSetState> mss = mods->prepare( onDisk );
+            auto_ptr<ModSetState> mss = mods->prepare( onDisk, inPlaceSlack( d, r, onDisk ) );
+            if ( logop )
+                noteWriteForSharding( ns, onDisk, updateobj.objsize() );
 
             if( mss->canApplyInPlace() ) {
                 mss->applyModsInPlace(true);
@@ -351,7 +363,10 @@ namespace mongo {
                         forceRewrite = true;
                     }
 
-                    auto_ptr<ModSetState> mss = useMods->prepare( onDisk );
+                    auto_ptr<ModSetState> mss = useMods->prepare( onDisk,
+                                                                  inPlaceSlack( d, r, onDisk ) );
+                    if ( logop )
+                        noteWriteForSharding( ns, onDisk, updateobj.objsize() );
 
                     bool willAdvanceCursor = multi && c->ok() && ( modsIsIndexed || ! mss->canApplyInPlace() );
 
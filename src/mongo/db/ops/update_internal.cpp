@@ -350,9 +350,9 @@ namespace mongo {
         return !obj.getField( path ).eoo();
     }
 
-    auto_ptr<ModSetState> ModSet::prepare(const BSONObj& obj) const {
+    auto_ptr<ModSetState> ModSet::prepare(const BSONObj& obj, int slack) const {
         DEBUGUPDATE( "\t start prepare" );
-        auto_ptr<ModSetState> mss( new ModSetState( obj ) );
+        auto_ptr<ModSetState> mss( new ModSetState( obj, slack ) );
 
 
         // Perform this check first, so that we don't leave a partially modified object on uassert.
@@ -401,8 +401,10 @@ namespace mongo {
                 if ( mss->amIInPlacePossible( e.isNumber() ) ) {
                     // check more typing info here
                     if ( m.elt.type() != e.type() ) {
-                        // if i'm incrementing with a double, then the storage has to be a double
-                        mss->amIInPlacePossible( m.elt.type() != NumberDouble );
+                        // if i'm incrementing with a double, then the storage has to be a double,
+                        // which a long can be rewritten as in place
+                        mss->amIInPlacePossible( m.elt.type() != NumberDouble ||
+                                                 e.type() == NumberLong );
                     }
 
                     // check for overflow
@@ -413,17 +415,32 @@ namespace mongo {
                 break;
 
             case Mod::SET:
-                mss->amIInPlacePossible( m.elt.type() == e.type() &&
+                // Numbers of the same width, such as a double and a long, may replace each other.
+                mss->amIInPlacePossible( ( m.elt.type() == e.type() ||
+                                           ( m.elt.isNumber() && e.isNumber() ) ) &&
                                          m.elt.valuesize() == e.valuesize() );
                 break;
 
             case Mod::PUSH:
-            case Mod::PUSH_ALL:
+            case Mod::PUSH_ALL: {
                 uassert( 10141,
                          "Cannot apply $push/$pushAll modifier to non-array",
                          e.type() == Array || e.eoo() );
-                mss->amIInPlacePossible( false );
+                if ( !mss->_inPlacePossible ) {
+                    break;
+                }
+                if ( m.op == Mod::PUSH ) {
+                    BSONObjBuilder b;
+                    b.append( m.elt );
+                    mss->amIInPlacePossible( mss->prepareInPlaceAppend( ms, b.obj() ) );
+                }
+                else {
+                    uassert( 10133 ,  "$pushAll has to be passed an array" , m.elt.type() );
+                    mss->amIInPlacePossible( mss->prepareInPlaceAppend( ms,
+                                                                        m.elt.embeddedObject() ) );
+                }
                 break;
+            }
 
             case Mod::PULL:
             case Mod::PULL_ALL: {
@@ -470,7 +487,20 @@ namespace mongo {
                         BSONElement arrI = i.next();
                         toadd.erase( arrI );
                     }
-                    mss->amIInPlacePossible( toadd.size() == 0 );
+                    if ( toadd.size() == 0 || !mss->_inPlacePossible ) {
+                        break;
+                    }
+                    // Values not yet in the set are appended in the order given.
+                    BSONObjBuilder b;
+                    BSONObjIterator j( m.getEach() );
+                    while( j.more() ) {
+                        BSONElement eachJ = j.next();
+                        if ( toadd.count( eachJ ) ) {
+                            b.append( eachJ );
+                            toadd.erase( eachJ );
+                        }
+                    }
+                    mss->amIInPlacePossible( mss->prepareInPlaceAppend( ms, b.obj() ) );
                 }
                 else {
                     bool found = false;
@@ -481,7 +511,12 @@ namespace mongo {
                             break;
                         }
                     }
-                    mss->amIInPlacePossible( found );
+                    if ( found || !mss->_inPlacePossible ) {
+                        break;
+                    }
+                    BSONObjBuilder b;
+                    b.append( m.elt );
+                    mss->amIInPlacePossible( mss->prepareInPlaceAppend( ms, b.obj() ) );
                 }
                 break;
             }
@@ -572,11 +607,15 @@ namespace mongo {
             }
 
             switch ( m.m->op ) {
+            case Mod::PUSH:
+            case Mod::PUSH_ALL:
+                verify( &m == _append );
+                break;
             case Mod::UNSET:
             case Mod::ADDTOSET:
             case Mod::RENAME_FROM:
             case Mod::RENAME_TO:
-                // this should have been handled by prepare
+                // this should have been handled by prepare, or is an append
                 break;
             case Mod::PULL:
             case Mod::PULL_ALL:
@@ -587,7 +626,16 @@ namespace mongo {
                 break;
                 // [dm] the BSONElementManipulator statements below are for replication (correct?)
             case Mod::INC:
-                if ( isOnDisk )
+                if ( m.old.type() == NumberLong && m.m->elt.type() == NumberDouble ) {
+                    BSONObjBuilder b;
+                    b.append( "", m.m->elt.numberDouble() + m.old.numberDouble() );
+                    BSONObj sum = b.obj();
+                    if ( isOnDisk )
+                        BSONElementManipulator( m.old ).ReplaceTypeAndValue( sum.firstElement() );
+                    else
+                        BSONElementManipulator( m.old ).replaceTypeAndValue( sum.firstElement() );
+                }
+                else if ( isOnDisk )
                     m.m->IncrementMe( m.old );
                 else
                     m.m->incrementMe( m.old );
@@ -604,6 +652,84 @@ namespace mongo {
                 uassert( 13478 ,  "can't apply mod in place - shouldn't have gotten here" , 0 );
             }
         }
+
+        // Other mods do not move or resize anything, so appending may come last.
+        if ( _append ) {
+            applyInPlaceAppend( *_append, isOnDisk );
+        }
+    }
+
+    /**
+     * Collects the objects enclosing the element at 'path', outermost first, ending with the
+     * element's own value.
+     * @return false unless each of these is the last element of the object enclosing it, so the
+     * element's value ends just before the EOOs terminating 'obj'.
+     */
+    static bool tailElementContainers( const BSONObj& obj, const char* path,
+                                       vector<const char*>& containers ) {
+        BSONObj o = obj;
+        while( 1 ) {
+            containers.push_back( o.objdata() );
+            const char* dot = strchr( path, '.' );
+            BSONElement e = dot ? o.getField( string( path, dot - path ) ) : o.getField( path );
+            if ( e.eoo() || e.rawdata() + e.size() != o.objdata() + o.objsize() - 1 ) {
+                return false;
+            }
+            if ( !e.isABSONObj() ) {
+                return false;
+            }
+            o = e.embeddedObject();
+            if ( !dot ) {
+                containers.push_back( o.objdata() );
+                return true;
+            }
+            path = dot + 1;
+        }
+    }
+
+    bool ModSetState::prepareInPlaceAppend( ModState& ms, const BSONObj& elts ) {
+        if ( elts.isEmpty() ) {
+            return true;
+        }
+        vector<const char*> containers;
+        if ( _append || !tailElementContainers( _obj, ms.fieldName(), containers ) ) {
+            return false;
+        }
+        int n = ms.old.embeddedObject().nFields();
+        BSONObjBuilder b;
+        BSONObjIterator i( elts );
+        for( int j = n; i.more(); ++j ) {
+            b.appendAs( i.next(), BSONObjBuilder::numStr( j ) );
+        }
+        BSONObj appended = b.obj();
+        int growth = appended.objsize() - 5;
+        if ( growth > _slack || _obj.objsize() + growth > BSONObjMaxUserSize ) {
+            return false;
+        }
+        ms.inPlaceAppend = appended;
+        ms.pushStartSize = n;
+        _append = &ms;
+        return true;
+    }
+
+    void ModSetState::applyInPlaceAppend( ModState& ms, bool isOnDisk ) {
+        // prepare() only finds slack for on disk objects.
+        verify( isOnDisk );
+        vector<const char*> containers;
+        verify( tailElementContainers( _obj, ms.fieldName(), containers ) );
+        int growth = ms.inPlaceAppend.objsize() - 5;
+
+        // The appended elements overwrite the array's EOO, and the EOOs of the array and of every
+        // enclosing object follow them.
+        const char* arrayEnd = _obj.objdata() + _obj.objsize() - containers.size();
+        int tailSize = growth + containers.size();
+        char* tail = (char*)getDur().writingPtr( const_cast<char*>( arrayEnd ), tailSize );
+        memcpy( tail, ms.inPlaceAppend.objdata() + 4, growth );
+        memset( tail + growth, 0, containers.size() );
+
+        for( vector<const char*>::const_iterator i = containers.begin(); i != containers.end(); ++i ) {
+            getDur().writingInt( *(int*)const_cast<char*>( *i ) ) += growth;
+        }
     }
 
     void ModSetState::_appendNewFromMods( const string& root,
@@ -340,8 +340,10 @@ namespace mongo {
         /**
          * creates a ModSetState suitable for operation on obj
          * doesn't change or modify this ModSet or any underying Mod
+         * @param slack bytes free after obj on disk, which appending to an array at the end of obj
+         * in place may use
          */
-        auto_ptr<ModSetState> prepare( const BSONObj& obj ) const;
+        auto_ptr<ModSetState> prepare( const BSONObj& obj, int slack = 0 ) const;
 
         /**
          * given a query pattern, builds an object suitable for an upsert
@@ -400,6 +402,9 @@ namespace mongo {
 
         bool dontApply;
 
+        /** elements an in place $push, $pushAll or $addToSet appends, named by array index */
+        BSONObj inPlaceAppend;
+
         ModState() {
             fixedOpName = 0;
             fixed = 0;
@@ -474,9 +479,12 @@ namespace mongo {
         ModStateHolder _mods;
         bool _inPlacePossible;
         BSONObj _newFromMods; // keep this data alive, as oplog generation may depend on it
+        int _slack;
+        ModState* _append; // at most one mod may append in place
 
-        ModSetState( const BSONObj& obj )
-            : _obj( obj ) , _mods( LexNumCmp( true ) ) , _inPlacePossible(true) {
+        ModSetState( const BSONObj& obj, int slack )
+            : _obj( obj ) , _mods( LexNumCmp( true ) ) , _inPlacePossible(true) , _slack( slack ) ,
+              _append() {
         }
 
         /**
@@ -488,6 +496,15 @@ namespace mongo {
             return _inPlacePossible;
         }
 
+        /**
+         * Plans appending elts in place to the array ms.old, which is possible only if it is the
+         * last element of the object, and of each object enclosing it, and _slack is big enough.
+         * @return true if elts will be appended in place.
+         */
+        bool prepareInPlaceAppend( ModState& ms, const BSONObj& elts );
+
+        void applyInPlaceAppend( ModState& ms, bool isOnDisk );
+
         ModStateRange modsForRoot( const string& root );
 
         void createNewObjFromMods( const string& root, BSONObjBuilder& b, const BSONObj& obj );
@@ -944,31 +944,74 @@ namespace mongo {
         dropNS(name);
     }
 
+    /* unindex one key of this record. */
+    static void _unindexKey(IndexDetails& id, const BSONObj& obj, const BSONObj& j, const DiskLoc& dl, bool logMissing) {
+        bool ok = false;
+        try {
+            ok = id.idxInterface().unindex(id.head, id, j, dl);
+        }
+        catch (AssertionException& e) {
+            problem() << "Assertion failure: _unindex failed " << id.indexNamespace() << endl;
+            out() << "Assertion failure: _unindex failed: " << e.what() << '\n';
+            out() << "  obj:" << obj.toString() << '\n';
+            out() << "  key:" << j.toString() << '\n';
+            out() << "  dl:" << dl.toString() << endl;
+            sayDbContext();
+        }
+
+        if ( !ok && logMissing ) {
+            log() << "unindex failed (key too big?) " << id.indexNamespace() << " key: " << j << " " << obj["_id"] << endl;
+        }
+    }
+
     /* unindex all keys in index for this record. */
     static void _unindexRecord(IndexDetails& id, BSONObj& obj, const DiskLoc& dl, bool logMissing = true) {
         BSONObjSet keys;
         id.getKeysFromObject(obj, keys);
-        IndexInterface& ii = id.idxInterface();
         for ( BSONObjSet::iterator i=keys.begin(); i != keys.end(); i++ ) {
-            BSONObj j = *i;
+            _unindexKey(id, obj, *i, dl, logMissing);
+        }
+    }
 
-            bool ok = false;
-            try {
-                ok = ii.unindex(id.head, id, j, dl);
-            }
-            catch (AssertionException& e) {
-                problem() << "Assertion failure: _unindex failed " << id.indexNamespace() << endl;
-                out() << "Assertion failure: _unindex failed: " << e.what() << '\n';
-                out() << "  obj:" << obj.toString() << '\n';
-                out() << "  key:" << j.toString() << '\n';
-                out() << "  dl:" << dl.toString() << endl;
-                sayDbContext();
-            }
+    /** A key of one of several records being unindexed together. */
+    struct RecordKey {
+        BSONObj key;
+        DiskLoc loc;
+        int record; // position of the record in the batch
+    };
+
+    /** Orders RecordKeys as the index stores them. */
+    class RecordKeyCmp {
+    public:
+        RecordKeyCmp( IndexDetails& id ) : _ii( id.idxInterface() ), _ordering( Ordering::make( id.keyPattern() ) ) {}
+        bool operator()( const RecordKey& l, const RecordKey& r ) const {
+            int c = _ii.keyCompare( l.key, r.key, _ordering );
+            return c < 0 || ( c == 0 && l.loc < r.loc );
+        }
+    private:
+        IndexInterface& _ii;
+        Ordering _ordering;
+    };
 
-            if ( !ok && logMissing ) {
-                log() << "unindex failed (key too big?) " << id.indexNamespace() << " key: " << j << " " << obj["_id"] << endl;
+    /* unindex all keys in index for these records, in index key order so the btree is walked
+       sequentially rather than once per record. */
+    static void _unindexRecords(IndexDetails& id, const vector<BSONObj>& objs, const vector<DiskLoc>& dls, bool logMissing) {
+        vector<RecordKey> keys;
+        for ( unsigned i = 0; i < objs.size(); ++i ) {
+            BSONObjSet objKeys;
+            id.getKeysFromObject(objs[i], objKeys);
+            for ( BSONObjSet::iterator j = objKeys.begin(); j != objKeys.end(); ++j ) {
+                RecordKey k;
+                k.key = *j;
+                k.loc = dls[i];
+                k.record = i;
+                keys.push_back(k);
             }
         }
+        sort(keys.begin(), keys.end(), RecordKeyCmp(id));
+        for ( vector<RecordKey>::const_iterator i = keys.begin(); i != keys.end(); ++i ) {
+            _unindexKey(id, objs[i->record], i->key, i->loc, logMissing);
+        }
     }
 //zzz
     /* unindex all keys in all indexes for this record. */
@@ -983,6 +1026,19 @@ namespace mongo {
         }
     }
 
+    /* unindex all keys in all indexes for these records. */
+    static void unindexRecords(NamespaceDetails *d, const vector<DiskLoc>& dls) {
+        vector<BSONObj> objs;
+        for ( vector<DiskLoc>::const_iterator i = dls.begin(); i != dls.end(); ++i )
+            objs.push_back(i->obj());
+        int n = d->nIndexes;
+        for ( int i = 0; i < n; i++ )
+            _unindexRecords(d->idx(i), objs, dls, true);
+        if( d->indexBuildInProgress ) { // background index
+            _unindexRecords(d->idx(n), objs, dls, false);
+        }
+    }
+
     /* deletes a record, just the pdfile portion -- no index cleanup, no cursor cleanup, etc.
        caller must check if capped
     */
@@ -1071,6 +1127,32 @@ namespace mongo {
     }
 
 
+    void DataFileMgr::deleteRecords(const char *ns, const vector<DiskLoc>& dls) {
+        NamespaceDetails* d = nsdetails(ns);
+        uassert( 16325 ,  "can't remove from a capped collection" , ! d->isCapped() );
+
+        for ( vector<DiskLoc>::const_iterator i = dls.begin(); i != dls.end(); ++i ) {
+            ClientCursor::aboutToDelete(*i);
+        }
+        // moving a cursor off one record of the batch can put it on another whose cursors were
+        // already moved, e.g. a cursor going the other way, so repeat until none is left on any
+        bool moved = true;
+        while ( moved ) {
+            moved = false;
+            for ( vector<DiskLoc>::const_iterator i = dls.begin(); i != dls.end(); ++i ) {
+                if ( ClientCursor::advanceCursorsAt(*i) )
+                    moved = true;
+            }
+        }
+
+        unindexRecords(d, dls);
+
+        for ( vector<DiskLoc>::const_iterator i = dls.begin(); i != dls.end(); ++i ) {
+            _deleteRecord(d, ns, i->rec(), *i);
+        }
+        NamespaceDetailsTransient::get( ns ).notifyOfWriteOp();
+    }
+
     /** Note: if the object shrinks a lot, we don't free up space, we leave extra at end of the record.
      */
     const DiskLoc DataFileMgr::updateRecord(
@@ -156,6 +156,12 @@ namespace mongo {
 
         void deleteRecord(const char *ns, Record *todelete, const DiskLoc& dl, bool cappedOK = false, bool noWarn = false, bool logOp=false);
 
+        /**
+         * Deletes several records of a non capped collection, as deleteRecord() would each of
+         * them, removing their keys from each index in key order.  The records must be distinct.
+         */
+        void deleteRecords(const char *ns, const vector<DiskLoc>& dls);
+
         /* does not clean up indexes, etc. : just deletes the record in the pdfile. use deleteRecord() to unindex */
         void _deleteRecord(NamespaceDetails *d, const char *ns, Record *todelete, const DiskLoc& dl);
 
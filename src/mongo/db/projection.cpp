@@ -17,6 +17,7 @@
 
 #include "pch.h"
 #include "projection.h"
+#include "key.h"
 #include "../util/mongoutils/str.h"
 
 namespace mongo {
@@ -281,9 +282,13 @@ namespace mongo {
     }
 
     BSONObj Projection::KeyOnly::hydrate( const BSONObj& key ) const {
-        verify( _include.size() == _names.size() );
-
         BSONObjBuilder b( key.objsize() + _stringSize + 16 );
+        hydrate( key, b );
+        return b.obj();
+    }
+
+    void Projection::KeyOnly::hydrate( const BSONObj& key, BSONObjBuilder& b ) const {
+        verify( _include.size() == _names.size() );
 
         BSONObjIterator i(key);
         unsigned n=0;
@@ -295,7 +300,13 @@ namespace mongo {
             }
             n++;
         }
+    }
 
-        return b.obj();
+    void Projection::KeyOnly::hydrate( const KeyBson& key, BSONObjBuilder& b ) const {
+        hydrate( key.toBson(), b );
+    }
+
+    void Projection::KeyOnly::hydrate( const KeyV1& key, BSONObjBuilder& b ) const {
+        key.appendElementsAs( b, _include, _names );
     }
 }
@@ -22,6 +22,9 @@
 
 namespace mongo {
 
+    class KeyBson;
+    class KeyV1;
+
     /**
      * given a document and a projection specification
      * can transform the document
@@ -37,6 +40,14 @@ namespace mongo {
 
             BSONObj hydrate( const BSONObj& key ) const;
 
+            /**
+             * Append the projected fields of an index key to b.  The KeyV1 version reads them
+             * straight from the compact key format, without converting the key to BSON.
+             */
+            void hydrate( const BSONObj& key, BSONObjBuilder& b ) const;
+            void hydrate( const KeyBson& key, BSONObjBuilder& b ) const;
+            void hydrate( const KeyV1& key, BSONObjBuilder& b ) const;
+
             void addNo() { _add( false , "" ); }
             void addYes( const string& name ) { _add( true , name ); }
 
@@ -23,6 +23,7 @@
 #include "cmdline.h"
 #include "../server.h"
 #include "pagefault.h"
+#include "intersectioncursor.h"
 
 //#define DEBUGQO(x) cout << x << endl;
 #define DEBUGQO(x)
@@ -124,7 +125,8 @@ namespace mongo {
         _utility( Helpful ),
         _special( special ),
         _type(0),
-        _startOrEndSpec() {
+        _startOrEndSpec(),
+        _intersectIdxNo( -1 ) {
     }
     
     void QueryPlan::init( const FieldRangeSetPair *originalFrsp,
@@ -267,8 +269,26 @@ doneCheckOrder:
         }
     }
 
+    void QueryPlan::intersectWith( int idxNo, const FieldRangeSetPair &frsp ) {
+        verify( indexed() && !_type && !_startOrEndSpec );
+        verify( idxNo >= 0 && idxNo != _idxNo );
+        _intersectIdxNo = idxNo;
+        _intersectFrv.reset( new FieldRangeVector( frsp.frsForIndex( _d, idxNo ),
+                                                  _d->idx( idxNo ).getSpec(), 1 ) );
+    }
+
     shared_ptr<Cursor> QueryPlan::newCursor( const DiskLoc &startLoc ) const {
 
+        if ( intersected() && _utility != Impossible ) {
+            shared_ptr<Cursor> primary( BtreeCursor::make( _d, _idxNo, *_index, _frv,
+                                                          independentRangesSingleIntervalLimit(),
+                                                          _direction >= 0 ? 1 : -1 ) );
+            shared_ptr<Cursor> secondary( BtreeCursor::make( _d, _intersectIdxNo,
+                                                            _d->idx( _intersectIdxNo ),
+                                                            _intersectFrv, 0, 1 ) );
+            return shared_ptr<Cursor>( new IntersectionCursor( primary, secondary ) );
+        }
+
         if ( _type ) {
             // hopefully safe to use original query in these contexts - don't think we can mix type with $or clause separation yet
             int numWanted = 0;
@@ -332,7 +352,9 @@ doneCheckOrder:
 
         SimpleMutex::scoped_lock lk(NamespaceDetailsTransient::_qcMutex);
         QueryPattern queryPattern = _frs.pattern( _order );
-        CachedQueryPlan queryPlanToCache( indexKey(), nScanned, candidatePlans );
+        CachedQueryPlan queryPlanToCache( indexKey(), nScanned, candidatePlans,
+                                         intersected() ?
+                                         _d->idx( _intersectIdxNo ).keyPattern() : BSONObj() );
         NamespaceDetailsTransient &nsdt = NamespaceDetailsTransient::get_inlock( ns() );
         nsdt.registerCachedQueryPlanForPattern( queryPattern, queryPlanToCache );
     }
@@ -462,11 +484,14 @@ doneCheckOrder:
     }
 
     string QueryPlan::toString() const {
-        return BSON(
-                    "index" << indexKey() <<
-                    "frv" << ( _frv ? _frv->toString() : "" ) <<
-                    "order" << _order
-                    ).jsonString();
+        BSONObjBuilder b;
+        b << "index" << indexKey();
+        if ( intersected() ) {
+            b << "intersect" << _d->idx( _intersectIdxNo ).keyPattern();
+        }
+        b << "frv" << ( _frv ? _frv->toString() : "" );
+        b << "order" << _order;
+        return b.obj().jsonString();
     }
     
     shared_ptr<CoveredIndexMatcher> QueryPlan::matcher() const {
@@ -580,9 +605,65 @@ doneCheckOrder:
             ++i ) {
             _qps.addCandidatePlan( *i );
         }        
+
+        if ( cmdLine.indexIntersection ) {
+            shared_ptr<QueryPlan> p = intersectionPlan( d, plans );
+            if ( p ) {
+                _qps.addCandidatePlan( p );
+            }
+        }
         
         _qps.addCandidatePlan( newPlan( d, -1 ) );
     }
+
+    /**
+     * @return a plan intersecting two of the candidate index plans, for queries with selective
+     * predicates on separately indexed fields, or none.  The secondary index must lead with a
+     * constrained field the primary index lacks, so the intersection can exclude documents the
+     * primary scan alone would have to fetch.  The intersection competes with the single index
+     * plans.
+     */
+    shared_ptr<QueryPlan> QueryPlanGenerator::intersectionPlan
+            ( NamespaceDetails *d, const vector<shared_ptr<QueryPlan> > &candidates ) const {
+        for( unsigned i = 0; i < candidates.size(); ++i ) {
+            const QueryPlan &primary = *candidates[ i ];
+            // Preserve the primary's order, if it provides the requested one.
+            if ( primary.scanAndOrderRequired() && !_qps.order().isEmpty() ) {
+                continue;
+            }
+            BSONObj primaryKey = primary.indexKey();
+            for( unsigned j = 0; j < candidates.size(); ++j ) {
+                const QueryPlan &secondary = *candidates[ j ];
+                if ( i == j ) {
+                    continue;
+                }
+                const char *field = secondary.indexKey().firstElementFieldName();
+                if ( secondary.multikeyFrs().range( field ).universal() ||
+                    primaryKey.hasField( field ) ) {
+                    continue;
+                }
+                shared_ptr<QueryPlan> p = newPlan( d, primary.idxNo() );
+                p->intersectWith( secondary.idxNo(), _qps.frsp() );
+                return p;
+            }
+        }
+        return shared_ptr<QueryPlan>();
+    }
+
+    /** @return true if addFallbackPlans() would add an intersection plan. */
+    bool QueryPlanGenerator::intersectionPlanPossible( NamespaceDetails *d ) const {
+        vector<shared_ptr<QueryPlan> > plans;
+        for( int i = 0; i < d->nIndexes; ++i ) {
+            if ( !QueryUtilIndexed::indexUseful( _qps.frsp(), d, i, _qps.order() ) ) {
+                continue;
+            }
+            shared_ptr<QueryPlan> p = newPlan( d, i );
+            if ( p->utility() == QueryPlan::Helpful && p->special().empty() ) {
+                plans.push_back( p );
+            }
+        }
+        return intersectionPlan( d, plans ).get() != 0;
+    }
     
     bool QueryPlanGenerator::addShortCircuitPlan( NamespaceDetails *d ) {
         return
@@ -692,6 +773,31 @@ doneCheckOrder:
             return false;
         }
 
+        BSONObj intersectKey = best.intersectKey();
+        if ( intersectKey.isEmpty() ) {
+            // A single index was recorded.  While intersections are enabled, race it against an
+            // intersection again rather than replaying it, so the intersection gets its chance.
+            if ( cmdLine.indexIntersection && intersectionPlanPossible( d ) ) {
+                return false;
+            }
+        }
+        else {
+            // A recorded intersection is only replayed while intersections are enabled.
+            int intersectIdxNo = -1;
+            NamespaceDetails::IndexIterator j = d->ii();
+            while( j.more() ) {
+                int k = j.pos();
+                if ( j.next().keyPattern().woCompare( intersectKey ) == 0 ) {
+                    intersectIdxNo = k;
+                }
+            }
+            if ( !cmdLine.indexIntersection || !p->indexed() || intersectIdxNo < 0 ||
+                intersectIdxNo == p->idxNo() ) {
+                return false;
+            }
+            p->intersectWith( intersectIdxNo, _qps.frsp() );
+        }
+
         _qps.setCachedPlan( p, best );
         return true;
     }
@@ -827,7 +933,8 @@ doneCheckOrder:
     void QueryPlanSet::addCandidatePlan( const QueryPlanPtr &plan ) {
         // If _plans is nonempty, the new plan may be supplementing a recorded plan at the first
         // position of _plans.  It must not duplicate the first plan.
-        if ( nPlans() > 0 && plan->indexKey() == firstPlan()->indexKey() ) {
+        if ( nPlans() > 0 && plan->indexKey() == firstPlan()->indexKey() &&
+            plan->intersected() == firstPlan()->intersected() ) {
             return;
         }
         _plans.push_back( plan );
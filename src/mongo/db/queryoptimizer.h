@@ -78,6 +78,14 @@ namespace mongo {
         bool willScanTable() const { return _idxNo < 0 && ( _utility != Impossible ); }
         /** @return 'special' attribute of the plan, which was either set explicitly or generated from the index. */
         const string &special() const { return _special; }
+
+        /**
+         * Restrict the documents scanned by this plan to those within the 'frsp' bounds of index
+         * 'idxNo' as well.  Cursors for the plan are then IntersectionCursors.
+         */
+        void intersectWith( int idxNo, const FieldRangeSetPair &frsp );
+        /** @return true if this plan intersects the results of two index scans. */
+        bool intersected() const { return _intersectIdxNo >= 0; }
                 
         /** @return a new cursor based on this QueryPlan's index and FieldRangeSet. */
         shared_ptr<Cursor> newCursor( const DiskLoc &startLoc = DiskLoc() ) const;
@@ -152,6 +160,8 @@ namespace mongo {
         bool _startOrEndSpec;
         shared_ptr<Projection::KeyOnly> _keyFieldsOnly;
         mutable shared_ptr<CoveredIndexMatcher> _matcher; // Lazy initialization.
+        int _intersectIdxNo; // -1 unless intersectWith() was called
+        shared_ptr<FieldRangeVector> _intersectFrv;
     };
 
     std::ostream &operator<< ( std::ostream &out, const QueryPlan::Utility &utility );
@@ -326,6 +336,9 @@ namespace mongo {
         bool addSpecialPlan( NamespaceDetails *d );
         void addStandardPlans( NamespaceDetails *d );
         bool addCachedPlan( NamespaceDetails *d );
+        shared_ptr<QueryPlan> intersectionPlan( NamespaceDetails *d,
+                                               const vector<shared_ptr<QueryPlan> > &candidates ) const;
+        bool intersectionPlanPossible( NamespaceDetails *d ) const;
         shared_ptr<QueryPlan> newPlan( NamespaceDetails *d,
                                       int idxNo,
                                       const BSONObj &min = BSONObj(),
@@ -655,6 +668,9 @@ namespace mongo {
         virtual DiskLoc currLoc() { return _c->currLoc(); }
         virtual bool advance();
         virtual BSONObj currKey() const { return _c->currKey(); }
+        virtual void hydrateCurrKey( const Projection::KeyOnly &keyOnly, BSONObjBuilder &b ) const {
+            _c->hydrateCurrKey( keyOnly, b );
+        }
         virtual DiskLoc refLoc() { return _c->refLoc(); }
         virtual void noteLocation() { _c->noteLocation(); }
         virtual void checkLocation() { _c->checkLocation(); }
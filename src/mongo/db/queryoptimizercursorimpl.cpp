@@ -186,6 +186,10 @@ namespace mongo {
         }
         DiskLoc currLoc() const { return _c ? _c->currLoc() : DiskLoc(); }
         BSONObj currKey() const { return _c ? _c->currKey() : BSONObj(); }
+        void hydrateCurrKey( const Projection::KeyOnly &keyOnly, BSONObjBuilder &b ) const {
+            verify( _c );
+            _c->hydrateCurrKey( keyOnly, b );
+        }
         bool currentMatches( MatchDetails *details ) {
             if ( !_c || !_c->ok() ) {
                 _matchCounter.setMatch( false );
@@ -373,6 +377,15 @@ namespace mongo {
             assertOk();
             return _currOp->currKey();
         }
+
+        virtual void hydrateCurrKey( const Projection::KeyOnly &keyOnly, BSONObjBuilder &b ) const {
+            if ( _takeover ) {
+                _takeover->hydrateCurrKey( keyOnly, b );
+                return;
+            }
+            assertOk();
+            _currOp->hydrateCurrKey( keyOnly, b );
+        }
         
         /**
          * When return value isNull(), our cursor will be ignored for deletions by the ClientCursor
@@ -107,8 +107,10 @@ namespace mongo {
     }
     
     CachedQueryPlan::CachedQueryPlan( const BSONObj &indexKey, long long nScanned,
-                                     CandidatePlanCharacter planCharacter ) :
+                                     CandidatePlanCharacter planCharacter,
+                                     const BSONObj &intersectKey ) :
     _indexKey( indexKey ),
+    _intersectKey( intersectKey ),
     _nScanned( nScanned ),
     _planCharacter( planCharacter ) {
     }
@@ -83,12 +83,16 @@ namespace mongo {
         _nScanned() {
         }
         CachedQueryPlan( const BSONObj &indexKey, long long nScanned,
-                        CandidatePlanCharacter planCharacter );
+                        CandidatePlanCharacter planCharacter,
+                        const BSONObj &intersectKey = BSONObj() );
         BSONObj indexKey() const { return _indexKey; }
+        /** @return the key of the index intersected with indexKey(), or empty if none. */
+        BSONObj intersectKey() const { return _intersectKey; }
         long long nScanned() const { return _nScanned; }
         CandidatePlanCharacter planCharacter() const { return _planCharacter; }
     private:
         BSONObj _indexKey;
+        BSONObj _intersectKey;
         long long _nScanned;
         CandidatePlanCharacter _planCharacter;
     };
@@ -161,6 +161,228 @@ namespace mongo {
         return regex;
     }
 
+    /**
+     * @return true if c can be part of a literal prefix or required literal.  Multibyte characters
+     * are excluded, as are k and s when ignoring case: PCRE's utf8 case folding also maps them to
+     * non ascii characters (KELVIN SIGN, LATIN SMALL LETTER LONG S).
+     */
+    static bool literalRegexByte( char c, bool caseless ) {
+        return !( c & 0x80 ) && !( caseless && strchr( "kKsS", c ) );
+    }
+
+    /** Case insensitive prefixes are expanded into at most 2^MaxFoldedLetters case variants. */
+    static const int MaxFoldedLetters = 4;
+
+    bool simpleCaseInsensitiveRegexPrefixes( const char *regex, const char *flags,
+                                             vector<string> &prefixes ) {
+        string otherFlags;
+        bool caseless = false;
+        for( const char *f = flags; *f; ++f ) {
+            if ( *f == 'i' )
+                caseless = true;
+            else
+                otherFlags += *f;
+        }
+        if ( !caseless )
+            return false;
+
+        string prefix = simpleRegex( regex, otherFlags.c_str() );
+        size_t len = 0;
+        int letters = 0;
+        while( len < prefix.size() && literalRegexByte( prefix[ len ], true ) ) {
+            if ( isalpha( prefix[ len ] ) && ++letters > MaxFoldedLetters )
+                break;
+            ++len;
+        }
+        if ( len == 0 )
+            return false;
+
+        prefixes.clear();
+        prefixes.push_back( prefix.substr( 0, len ) );
+        for( size_t i = 0; i < len; ++i ) {
+            if ( !isalpha( prefix[ i ] ) )
+                continue;
+            size_t n = prefixes.size();
+            for( size_t j = 0; j < n; ++j ) {
+                prefixes[ j ][ i ] = toupper( prefix[ i ] );
+                prefixes.push_back( prefixes[ j ] );
+                prefixes.back()[ i ] = tolower( prefix[ i ] );
+            }
+        }
+        sort( prefixes.begin(), prefixes.end() );
+        return true;
+    }
+
+    inline bool simpleCaseInsensitiveRegexPrefixes( const BSONElement &e,
+                                                    vector<string> &prefixes ) {
+        switch(e.type()) {
+        case RegEx:
+            return simpleCaseInsensitiveRegexPrefixes( e.regex(), e.regexFlags(), prefixes );
+        case Object: {
+            BSONObj o = e.embeddedObject();
+            return simpleCaseInsensitiveRegexPrefixes( o["$regex"].valuestrsafe(),
+                                                       o["$options"].valuestrsafe(), prefixes );
+        }
+        default: verify(false); return false;
+        }
+    }
+
+    /** Appends the run to best if it is longer, and clears it. */
+    static void endLiteralRun( string &run, string &best ) {
+        if ( run.size() > best.size() )
+            best = run;
+        run.clear();
+    }
+
+    /** @return the position after the \Q...\E quoted text starting at p. */
+    static const char *skipRegexQuote( const char *p ) {
+        while( *p && !( p[ 0 ] == '\\' && p[ 1 ] == 'E' ) )
+            ++p;
+        return *p ? p + 2 : p;
+    }
+
+    /** @return the position after the character class whose contents start at p. */
+    static const char *skipRegexClass( const char *p ) {
+        if ( *p == '^' )
+            ++p;
+        if ( *p == ']' )
+            ++p;
+        while( *p && *p != ']' ) {
+            if ( p[ 0 ] == '\\' && p[ 1 ] == 'Q' )
+                p = skipRegexQuote( p + 2 );
+            else if ( p[ 0 ] == '\\' && p[ 1 ] )
+                p += 2;
+            else
+                ++p;
+        }
+        return *p ? p + 1 : p;
+    }
+
+    string regexRequiredLiteral( const char *regex, const char *flags ) {
+        // Whitespace and comments in extended mode are not worth analysing.
+        if ( strchr( flags, 'x' ) )
+            return "";
+        bool caseless = strchr( flags, 'i' );
+
+        string best;
+        string run;
+        const char *p = regex;
+        while( *p ) {
+            char c = *p++;
+            bool literal = false;
+            if ( c == '|' ) {
+                // Top level alternation, nothing is required.
+                return "";
+            }
+            else if ( c == '\\' ) {
+                char n = *p;
+                if ( n == 0 )
+                    break;
+                ++p;
+                if ( n == 'Q' ) {
+                    // A following quantifier applies to the last quoted character only.
+                    const char *q = p;
+                    while( *q && !( q[ 0 ] == '\\' && q[ 1 ] == 'E' ) )
+                        ++q;
+                    if ( q == p )
+                        return "";
+                    for( ; p < q - 1; ++p ) {
+                        if ( literalRegexByte( *p, caseless ) )
+                            run += *p;
+                        else
+                            endLiteralRun( run, best );
+                    }
+                    c = *p;
+                    p = *q ? q + 2 : q;
+                    literal = literalRegexByte( c, caseless );
+                }
+                else if ( n == 'c' ) {
+                    // Control character escape, \cX.
+                    if ( *p )
+                        ++p;
+                }
+                else if ( strchr( "xpPgkNo0123456789", n ) ) {
+                    // Escapes taking arguments: hex, octal, properties, back references.
+                    while( isalnum( (unsigned char)*p ) || ( *p && strchr( "{}<>'-_", *p ) ) )
+                        ++p;
+                }
+                else {
+                    // An escaped non alphanumeric character matches itself; other escaped
+                    // alphanumerics are classes or anchors.
+                    c = n;
+                    literal = literalRegexByte( n, caseless ) && !isalnum( n );
+                }
+            }
+            else if ( c == '[' ) {
+                p = skipRegexClass( p );
+            }
+            else if ( c == '(' ) {
+                // Option settings such as (?i) change how what follows matches.
+                if ( p[ 0 ] == '?' && !strchr( ":=!<>#|", p[ 1 ] ) )
+                    return "";
+                int depth = 1;
+                while( *p && depth ) {
+                    if ( p[ 0 ] == '\\' && p[ 1 ] == 'Q' ) {
+                        p = skipRegexQuote( p + 2 );
+                        continue;
+                    }
+                    if ( p[ 0 ] == '\\' && p[ 1 ] ) {
+                        p += 2;
+                        continue;
+                    }
+                    if ( *p == '[' ) {
+                        p = skipRegexClass( p + 1 );
+                        continue;
+                    }
+                    if ( *p == '(' ) {
+                        if ( p[ 1 ] == '?' && !strchr( ":=!<>#|", p[ 2 ] ) )
+                            return "";
+                        ++depth;
+                    }
+                    else if ( *p == ')' ) {
+                        --depth;
+                    }
+                    ++p;
+                }
+            }
+            else {
+                // Metacharacters and anchors are not literal.
+                literal = !strchr( "^$.*+?{)", c ) && literalRegexByte( c, caseless );
+            }
+
+            // Quantifiers following the atom.
+            if ( *p == '*' || *p == '?' || *p == '{' ) {
+                // The atom is optional.
+                endLiteralRun( run, best );
+                if ( *p == '{' ) {
+                    while( *p && *p != '}' )
+                        ++p;
+                }
+                if ( *p )
+                    ++p;
+                if ( *p == '?' || *p == '+' )
+                    ++p;
+                continue;
+            }
+            if ( *p == '+' ) {
+                // The atom is required, but what follows need not be adjacent to it.
+                if ( literal )
+                    run += c;
+                endLiteralRun( run, best );
+                ++p;
+                if ( *p == '?' || *p == '+' )
+                    ++p;
+                continue;
+            }
+            if ( literal )
+                run += c;
+            else
+                endLiteralRun( run, best );
+        }
+        endLiteralRun( run, best );
+        return best;
+    }
+
 
     FieldRange::FieldRange( const BSONElement &e, bool singleKey, bool isNot, bool optimize ) :
     _singleKey( singleKey ),
@@ -254,11 +476,28 @@ namespace mongo {
             uassert( 13454, "invalid regular expression operator", op == BSONObj::Equality || op == BSONObj::opREGEX );
             if ( !isNot ) { // no optimization for negated regex - we could consider creating 2 intervals comprising all nonmatching prefixes
                 const string r = simpleRegex(e);
+                vector<string> caseVariants;
                 if ( r.size() ) {
                     lower = addObj( BSON( "" << r ) ).firstElement();
                     upper = addObj( BSON( "" << simpleRegexEnd( r ) ) ).firstElement();
                     upperInclusive = false;
                 }
+                else if ( simpleCaseInsensitiveRegexPrefixes( e, caseVariants ) ) {
+                    // One interval per case variant of the prefix, in ascending order.
+                    for( vector<string>::const_iterator i = caseVariants.begin();
+                        i != caseVariants.end(); ++i ) {
+                        FieldInterval interval;
+                        interval._lower._bound = addObj( BSON( "" << *i ) ).firstElement();
+                        interval._lower._inclusive = true;
+                        interval._upper._bound =
+                                addObj( BSON( "" << simpleRegexEnd( *i ) ) ).firstElement();
+                        interval._upper._inclusive = false;
+                        if ( i == caseVariants.begin() )
+                            _intervals[ 0 ] = interval;
+                        else
+                            _intervals.push_back( interval );
+                    }
+                }
                 else {
                     BSONObjBuilder b1(32), b2(32);
                     b1.appendMinForType( "" , String );
@@ -1688,6 +1927,31 @@ namespace mongo {
                 verify( simpleRegex("^\\Qas\\Q[df\\E", "", NULL) == "as\\Q[df" );
                 verify( simpleRegex("^\\Qas\\E\\\\E\\Q$df\\E", "", NULL) == "as\\E$df" ); // quoted string containing \E
             }
+            {
+                vector<string> v;
+                verify( simpleCaseInsensitiveRegexPrefixes("^a1b", "i", v) );
+                verify( v.size() == 4 && v[0] == "A1B" && v[1] == "A1b" && v[3] == "a1b" );
+                verify( simpleCaseInsensitiveRegexPrefixes("^abcdef", "i", v) );
+                verify( v.size() == 16 && v[0] == "ABCD" );
+                verify( !simpleCaseInsensitiveRegexPrefixes("^ab", "", v) );
+                verify( !simpleCaseInsensitiveRegexPrefixes("^ab", "x", v) );
+                verify( !simpleCaseInsensitiveRegexPrefixes("^sa", "i", v) );
+            }
+            {
+                verify( regexRequiredLiteral("error", "") == "error" );
+                verify( regexRequiredLiteral("^abc.*defg", "") == "defg" );
+                verify( regexRequiredLiteral("ab?cd", "") == "cd" );
+                verify( regexRequiredLiteral("abc+d", "") == "abc" );
+                verify( regexRequiredLiteral("a\\.b", "") == "a.b" );
+                verify( regexRequiredLiteral("(a|b)xyz", "") == "xyz" );
+                verify( regexRequiredLiteral("[abc]de[^]]fgh", "") == "fgh" );
+                verify( regexRequiredLiteral("\\Qa.b\\E*c", "") == "a." );
+                verify( regexRequiredLiteral("mask", "i") == "ma" );
+                verify( regexRequiredLiteral("foo|bar", "") == "" );
+                verify( regexRequiredLiteral("(?i)abc", "") == "" );
+                verify( regexRequiredLiteral("\\x41bcd", "") == "" );
+                verify( regexRequiredLiteral("abc", "x") == "" );
+            }
 
         }
     } simple_regex_unittest;
@@ -777,6 +777,20 @@ namespace mongo {
     /** returns the upper bound of a query that matches prefix */
     string simpleRegexEnd( string prefix );
 
+    /**
+       for a case insensitive regex that starts with '^' and a literal ascii prefix, fills
+       prefixes with the sorted case variants of (the start of) that prefix.  every match of the
+       regex starts with one of them.  returns false if the regex has no such prefix.
+    */
+    bool simpleCaseInsensitiveRegexPrefixes( const char *regex, const char *flags,
+                                             vector<string> &prefixes );
+
+    /**
+       returns the longest literal string that every match of the regex must contain, or "" if
+       none is found.  with the 'i' flag the literal is to be compared ignoring ascii case.
+    */
+    string regexRequiredLiteral( const char *regex, const char *flags );
+
     long long applySkipLimit( long long num , const BSONObj& cmd );
     
     bool isSimpleIdQuery( const BSONObj& query );
@@ -20,11 +20,88 @@
 
 #include "pch.h"
 #include "scanandorder.h"
+#include "extsort.h"
 
 namespace mongo {
 
     const unsigned ScanAndOrder::MaxScanAndOrderBytes = 32 * 1024 * 1024;
 
+    /**
+     * Iterates the remaining results of a ScanAndOrder that spilled to disk, merging its sorted
+     * runs.  Results are stored as the sort key's elements, the insertion sequence number and
+     * then the document.
+     */
+    class ScanAndOrderSpillCursor : public Cursor {
+    public:
+        ScanAndOrderSpillCursor( const shared_ptr<BSONObjExternalSorter> &sorter, int nKeyFields,
+                                int limit ) :
+            _sorter( sorter ),
+            _it( sorter->iterator() ),
+            _nKeyFields( nKeyFields ),
+            _remaining( limit ),
+            _ok(),
+            _nscanned() {
+            advance();
+        }
+        virtual bool ok() { return _ok; }
+        virtual Record* _current() {
+            // results were copied out of their records when added, which may since have changed
+            massert( 16332, "spilled sort results are not backed by a Record", false );
+            return 0;
+        }
+        virtual BSONObj current() { return _obj; }
+        virtual DiskLoc currLoc() { return _loc; }
+        virtual bool advance() {
+            _ok = _remaining > 0 && _it->more();
+            if ( !_ok ) {
+                _obj = BSONObj();
+                _loc = DiskLoc();
+                return false;
+            }
+            --_remaining;
+            ++_nscanned;
+            BSONObjExternalSorter::Data d = _it->next();
+            BSONObjIterator i( d.first );
+            for( int j = 0; j < _nKeyFields + 1; ++j ) {
+                i.next();
+            }
+            _obj = i.next().embeddedObject();
+            _loc = d.second;
+            return true;
+        }
+        /** Results are copies, so there is nothing to invalidate on a delete. */
+        virtual DiskLoc refLoc() { return DiskLoc(); }
+        virtual bool supportGetMore() { return true; }
+        virtual bool supportYields() { return false; }
+        virtual string toString() { return "ScanAndOrderSpillCursor"; }
+        virtual bool getsetdup( DiskLoc loc ) { return false; }
+        virtual bool isMultiKey() const { return false; }
+        virtual bool modifiedKeys() const { return false; }
+        virtual long long nscanned() { return _nscanned; }
+    private:
+        shared_ptr<BSONObjExternalSorter> _sorter;
+        auto_ptr<BSONObjExternalSorter::Iterator> _it;
+        int _nKeyFields;
+        int _remaining;
+        bool _ok;
+        BSONObj _obj;
+        DiskLoc _loc;
+        long long _nscanned;
+    };
+
+    ScanAndOrder::ScanAndOrder(int startFrom, int limit, const BSONObj &order,
+                               const FieldRangeSet &frs, bool allowSpill) :
+        _seq(),
+        _startFrom(startFrom),
+        _batchSize(limit),
+        _order(order, frs),
+        _approxSize(),
+        _allowSpill(allowSpill),
+        _showDiskLoc(),
+        _nAdded() {
+        _limit = limit > 0 ? limit + _startFrom : 0x7fffffff;
+    }
+
     void ScanAndOrder::add(const BSONObj& o, const DiskLoc* loc) {
         verify( o.isValid() );
         BSONObj k;
@@ -43,27 +120,35 @@ namespace mongo {
         if ( k.isEmpty() ) {
             return;   
         }
+        ++_nAdded;
+        if ( loc ) {
+            _showDiskLoc = true;
+        }
+        if ( _sorter ) {
+            _addToSorter(k, o, loc, _seq++);
+            return;
+        }
         if ( (int) _best.size() < _limit ) {
             _add(k, o, loc);
             return;
         }
-        BestMap::iterator i;
-        verify( _best.end() != _best.begin() );
-        i = _best.end();
-        i--;
-        _addIfBetter(k, o, i, loc);
+        verify( !_best.empty() );
+        _addIfBetter(k, o, loc);
     }
 
-
-    void ScanAndOrder::fill(BufBuilder& b, const Projection *filter, int& nout ) const {
+    void ScanAndOrder::fill(BufBuilder& b, const Projection *filter, int& nout ) {
+        if ( _sorter ) {
+            _fillSpilled(b, filter, nout);
+            return;
+        }
+        sort_heap( _best.begin(), _best.end(), EntryCmp( _order._spec.keyPattern ) );
         int n = 0;
         int nFilled = 0;
-        for ( BestMap::const_iterator i = _best.begin(); i != _best.end(); i++ ) {
+        for ( vector<Entry>::const_iterator i = _best.begin(); i != _best.end(); i++ ) {
             n++;
             if ( n <= _startFrom )
                 continue;
-            const BSONObj& o = i->second;
-            fillQueryResultFromObj(b, filter, o);
+            fillQueryResultFromObj(b, filter, i->_obj, _showDiskLoc ? &i->_loc : 0);
             nFilled++;
             if ( nFilled >= _limit )
                 break;
@@ -71,30 +156,93 @@ namespace mongo {
         nout = nFilled;
     }
 
+    int ScanAndOrder::nResults() const {
+        long long n = min( _nAdded, (long long)_limit ) - _startFrom;
+        return n > 0 ? (int)n : 0;
+    }
+
     void ScanAndOrder::_add(const BSONObj& k, const BSONObj& o, const DiskLoc* loc) {
-        BSONObj docToReturn = o;
+        int size = k.objsize() + o.objsize();
+        if ( _allowSpill && _approxSize + size >= MaxScanAndOrderBytes ) {
+            _spill();
+            _addToSorter(k, o, loc, _seq++);
+            return;
+        }
+        _validateAndUpdateApproxSize( size );
+        Entry e;
+        e._key = k.getOwned();
+        e._obj = o.getOwned();
         if ( loc ) {
-            BSONObjBuilder b;
-            b.appendElements(o);
-            b.append("$diskLoc", loc->toBSONObj());
-            docToReturn = b.obj();
+            e._loc = *loc;
         }
-        _validateAndUpdateApproxSize( k.objsize() + docToReturn.objsize() );
-        _best.insert(make_pair(k.getOwned(),docToReturn.getOwned()));
+        e._seq = _seq++;
+        _best.push_back(e);
+        push_heap( _best.begin(), _best.end(), EntryCmp( _order._spec.keyPattern ) );
     }
     
-    void ScanAndOrder::_addIfBetter(const BSONObj& k, const BSONObj& o, const BestMap::iterator& i,
-                                    const DiskLoc* loc) {
-        const BSONObj& worstBestKey = i->first;
-        int cmp = worstBestKey.woCompare(k, _order._spec.keyPattern);
+    void ScanAndOrder::_addIfBetter(const BSONObj& k, const BSONObj& o, const DiskLoc* loc) {
+        const Entry &worstBest = _best.front();
+        int cmp = worstBest._key.woCompare(k, _order._spec.keyPattern);
         if ( cmp > 0 ) {
             // k is better, 'upgrade'
-            _validateAndUpdateApproxSize( -i->first.objsize() + -i->second.objsize() );
-            _best.erase(i);
+            _validateAndUpdateApproxSize( -worstBest._key.objsize() + -worstBest._obj.objsize() );
+            pop_heap( _best.begin(), _best.end(), EntryCmp( _order._spec.keyPattern ) );
+            _best.pop_back();
             _add(k, o, loc);
         }
     }
 
+    void ScanAndOrder::_spill() {
+        log() << "scanAndOrder spilling " << _best.size() << " results to disk" << endl;
+        _sorter.reset( new BSONObjExternalSorter( *IndexDetails::iis[ 1 ],
+                                                  _order._spec.keyPattern,
+                                                  MaxScanAndOrderBytes ) );
+        _sorter->hintNumObjects( _best.size() + 1000 );
+        for( vector<Entry>::const_iterator i = _best.begin(); i != _best.end(); ++i ) {
+            _addToSorter( i->_key, i->_obj, &i->_loc, i->_seq );
+        }
+        _best.clear();
+        _approxSize = 0;
+    }
+
+    void ScanAndOrder::_addToSorter(const BSONObj& k, const BSONObj& o, const DiskLoc* loc,
+                                    long long seq) {
+        // The sorter orders by its keys alone, so the document rides along as a trailing element.
+        // The sequence number before it breaks ties in insertion order, as in memory.
+        int size = k.objsize() + o.objsize() + 32;
+        uassert( 16333, str::stream() << "sort key and document too large to sort on disk: "
+                 << size << " bytes",
+                 size <= BSONObjMaxInternalSize );
+        BSONObjBuilder b( size );
+        b.appendElements( k );
+        b.append( "", seq );
+        b.append( "", o );
+        _sorter->add( b.obj(), loc ? *loc : DiskLoc() );
+    }
+
+    void ScanAndOrder::_fillSpilled(BufBuilder& b, const Projection *filter, int& nout) {
+        _sorter->sort();
+        shared_ptr<Cursor> c( new ScanAndOrderSpillCursor( _sorter,
+                                                           _order._spec.keyPattern.nFields(),
+                                                           _limit ) );
+        for( int i = 0; i < _startFrom && c->ok(); ++i ) {
+            c->advance();
+        }
+        // The first batch is limited as ParsedQuery::enoughForFirstBatch() limits it.
+        int maxFilled = _batchSize > 0 ? _batchSize : 101;
+        int maxBytes = _batchSize > 0 ? MaxBytesToReturnToClientAtOnce : 1024 * 1024;
+        int nFilled = 0;
+        for( ; c->ok() && nFilled < maxFilled && b.len() <= maxBytes; c->advance() ) {
+            DiskLoc loc = c->currLoc();
+            fillQueryResultFromObj(b, filter, c->current(), _showDiskLoc ? &loc : 0);
+            nFilled++;
+        }
+        nout = nFilled;
+        if ( c->ok() ) {
+            _remaining = c;
+        }
+    }
+
     void ScanAndOrder::_validateAndUpdateApproxSize( const int approxSizeDelta ) {
         // note : adjust when bson return limit adjusts. note this limit should be a bit higher.
         int newApproxSize = _approxSize + approxSizeDelta;
@@ -23,6 +23,7 @@
 #include "indexkey.h"
 #include "queryutil.h"
 #include "projection.h"
+#include "cursor.h"
 
 namespace mongo {
 
@@ -72,28 +73,50 @@ namespace mongo {
         }
     }
 
-    typedef multimap<BSONObj,BSONObj,BSONObjCmp> BestMap;
+    class BSONObjExternalSorter;
+
+    /**
+     * Sorts query results that are not read in order from an index.
+     *
+     * When the number of results wanted is known, only that many of the best results seen so far
+     * are kept, in a heap with the worst of them on top.  Otherwise every result is kept.
+     *
+     * If spilling is allowed, results which would not fit in MaxScanAndOrderBytes are instead
+     * written to disk as sorted runs using a BSONObjExternalSorter.  The runs are then merged
+     * lazily: fill() returns a first batch and remainingResults() a Cursor over the rest, to be
+     * handed to getMore.
+     */
     class ScanAndOrder {
     public:
         static const unsigned MaxScanAndOrderBytes;
 
-        ScanAndOrder(int startFrom, int limit, const BSONObj &order, const FieldRangeSet &frs) :
-            _best( BSONObjCmp( order ) ),
-            _startFrom(startFrom), _order(order, frs) {
-            _limit = limit > 0 ? limit + _startFrom : 0x7fffffff;
-            _approxSize = 0;
-        }
+        ScanAndOrder(int startFrom, int limit, const BSONObj &order, const FieldRangeSet &frs,
+                     bool allowSpill = false);
 
+        /** @return the number of results held in memory. */
         int size() const { return _best.size(); }
 
         /**
          * @throw ScanAndOrderMemoryLimitExceededAssertionCode if adding would grow memory usage
-         * to ScanAndOrder::MaxScanAndOrderBytes.
+         * to ScanAndOrder::MaxScanAndOrderBytes and spilling is not allowed.
          */
         void add(const BSONObj &o, const DiskLoc* loc);
 
-        /* scanning complete. stick the query result in b for n objects. */
-        void fill(BufBuilder& b, const Projection *filter, int& nout ) const;
+        /**
+         * Scanning complete.  Stick the query result in b for n objects.  If results were spilled
+         * to disk, only a first batch is filled, limited like any other first batch.  May only
+         * be called once.
+         */
+        void fill(BufBuilder& b, const Projection *filter, int& nout );
+
+        /** @return true if results have been written to disk. */
+        bool spilled() const { return _sorter.get() != 0; }
+
+        /** @return the total number of results, including any not yet filled. */
+        int nResults() const;
+
+        /** @return the results following those filled, or an empty pointer if there are none. */
+        shared_ptr<Cursor> remainingResults() const { return _remaining; }
 
     /** Functions for testing. */
     protected:
@@ -102,10 +125,36 @@ namespace mongo {
 
     private:
 
+        struct Entry {
+            BSONObj _key;
+            BSONObj _obj;
+            DiskLoc _loc;
+            long long _seq; // insertion order, so equal keys are returned in the order added
+        };
+
+        /** Orders entries by key and then insertion order. */
+        class EntryCmp {
+        public:
+            EntryCmp( const BSONObj &pattern ) : _pattern( pattern ) {}
+            bool operator()( const Entry &l, const Entry &r ) const {
+                int cmp = l._key.woCompare( r._key, _pattern );
+                return cmp < 0 || ( cmp == 0 && l._seq < r._seq );
+            }
+        private:
+            const BSONObj &_pattern;
+        };
+
         void _add(const BSONObj& k, const BSONObj& o, const DiskLoc* loc);
 
-        void _addIfBetter(const BSONObj& k, const BSONObj& o, const BestMap::iterator& i,
-                          const DiskLoc* loc);
+        void _addIfBetter(const BSONObj& k, const BSONObj& o, const DiskLoc* loc);
+
+        /** Moves the results held in memory to a new external sorter. */
+        void _spill();
+
+        /** @throw 16333 if k and o together are too large to be stored */
+        void _addToSorter(const BSONObj& k, const BSONObj& o, const DiskLoc* loc, long long seq);
+
+        void _fillSpilled(BufBuilder& b, const Projection *filter, int& nout);
 
         /**
          * @throw ScanAndOrderMemoryLimitExceededAssertionCode if approxSize would grow too high,
@@ -113,12 +162,18 @@ namespace mongo {
          */
         void _validateAndUpdateApproxSize( const int approxSizeDelta );
 
-        BestMap _best; // key -> full object
+        vector<Entry> _best; // heap, worst result on top
+        long long _seq;
         int _startFrom;
+        int _batchSize; // as requested, 0 for the default first batch
         int _limit;   // max to send back.
         KeyType _order;
         unsigned _approxSize;
-
+        bool _allowSpill;
+        bool _showDiskLoc;
+        long long _nAdded;
+        shared_ptr<BSONObjExternalSorter> _sorter;
+        shared_ptr<Cursor> _remaining;
     };
 
 } // namespace mongo
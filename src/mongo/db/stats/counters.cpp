@@ -77,6 +77,11 @@ namespace mongo {
         return b.obj();
     }
 
+    void CoveredQueryCounters::append( BSONObjBuilder& b ) {
+        b.append( "query" , _query.get() );
+        b.append( "getmore" , _getmore.get() );
+    }
+
     IndexCounters::IndexCounters() {
         _memSupported = ProcessInfo().blockCheckSupported();
 
@@ -187,6 +192,7 @@ namespace mongo {
 
     OpCounters globalOpCounters;
     OpCounters replOpCounters;
+    CoveredQueryCounters globalCoveredQueryCounters;
     IndexCounters globalIndexCounters;
     FlushCounters globalFlushCounters;
     NetworkCounter networkCounter;
@@ -61,6 +61,21 @@ namespace mongo {
     extern OpCounters globalOpCounters;
     extern OpCounters replOpCounters;
 
+    /** Counts query and getMore replies built from index keys alone, without loading documents. */
+    class CoveredQueryCounters {
+    public:
+        void gotQuery() { _query++; }
+        void gotGetMore() { _getmore++; }
+
+        void append( BSONObjBuilder& b );
+
+    private:
+        AtomicUInt _query;
+        AtomicUInt _getmore;
+    };
+
+    extern CoveredQueryCounters globalCoveredQueryCounters;
+
 
     class IndexCounters {
     public:
@@ -19,19 +19,14 @@
 #include "pch.h"
 #include "dbtests.h"
 
-// TODO SERVER-1822
-//#include "../s/config.h" // for ShardFields
-//#include "../s/balancer_policy.h"
+#include "../s/config.h" // for ShardFields
+#include "../s/balancer_policy.h"
 
 namespace BalancerPolicyTests {
 
-//
-// TODO SERVER-1822
-//
-#if 0
-
     typedef mongo::ShardFields sf;  // fields from 'shards' colleciton
     typedef mongo::LimitsFields lf; // fields from the balancer's limits map
+    typedef mongo::ChunkLoadFields clf; // fields of the load of a chunk
 
     class SizeMaxedShardTest {
     public:
@@ -179,10 +174,124 @@ namespace BalancerPolicyTests {
         }
     };
 
-//
-// TODO SERVER-1822
-//
-#endif // #if 0
+    /** a chunk over [min, max) of 'x' that saw 'ops' reads of 100 bytes each */
+    static BSONObj loadedChunk( int min, int max, long long ops ) {
+        return BSON( "min" << BSON( "x" << min ) << "max" << BSON( "x" << max ) <<
+                     clf::reads( ops ) << clf::writes( 0LL ) << clf::bytes( ops * 100 ) );
+    }
+
+    static BalancerPolicy::ShardToLimitsMap noLimits() {
+        BalancerPolicy::ShardToLimitsMap limitsMap;
+        limitsMap["shard0"] = BSON( sf::maxSize(0LL) << lf::currSize(0LL) << sf::draining(false) );
+        limitsMap["shard1"] = BSON( sf::maxSize(0LL) << lf::currSize(0LL) << sf::draining(false) );
+        return limitsMap;
+    }
+
+    class ChunkOpsTest {
+    public:
+        void run() {
+            ASSERT_EQUALS( -1 , BalancerPolicy::chunkOps( BSON( "min" << BSON( "x" << 1 ) ) ) );
+            ASSERT_EQUALS( 5 , BalancerPolicy::chunkOps( BSON( clf::reads(2LL) << clf::writes(3LL) ) ) );
+            ASSERT_EQUALS( 0 , BalancerPolicy::chunkOps( loadedChunk( 0, 1, 0 ) ) );
+        }
+    };
+
+    class BalanceLoadTest {
+    public:
+        void run() {
+            // same number of chunks, but two hot ones on shard0
+            BalancerPolicy::ShardToChunksMap chunkMap;
+            vector<BSONObj>& chunks0 = chunkMap["shard0"];
+            chunks0.push_back( loadedChunk( 0, 10, 10 ) );
+            chunks0.push_back( loadedChunk( 10, 20, 2000 ) );
+            chunks0.push_back( loadedChunk( 20, 30, 2000 ) );
+            chunks0.push_back( loadedChunk( 30, 40, 10 ) );
+            vector<BSONObj>& chunks1 = chunkMap["shard1"];
+            for ( int i = 40; i < 80; i += 10 )
+                chunks1.push_back( loadedChunk( i, i + 10, 100 ) );
+
+            BalancerPolicy::ChunkInfo* c = BalancerPolicy::balance( "ns", noLimits(), chunkMap, 0 );
+            ASSERT( c );
+            ASSERT_EQUALS( c->from , "shard0" );
+            ASSERT_EQUALS( c->to , "shard1" );
+            ASSERT_EQUALS( 2000 , BalancerPolicy::chunkOps( c->chunk ) );
+            delete c;
+        }
+    };
+
+    class BalanceEvenLoadTest {
+    public:
+        void run() {
+            BalancerPolicy::ShardToChunksMap chunkMap;
+            for ( int i = 0; i < 80; i += 10 )
+                chunkMap[ i < 40 ? "shard0" : "shard1" ].push_back( loadedChunk( i, i + 10, 500 + i ) );
+
+            ASSERT( ! BalancerPolicy::balance( "ns", noLimits(), chunkMap, 0 ) );
+        }
+    };
+
+    class BalanceLittleLoadTest {
+    public:
+        void run() {
+            // too few operations to go by
+            BalancerPolicy::ShardToChunksMap chunkMap;
+            chunkMap["shard0"].push_back( loadedChunk( 0, 10, 400 ) );
+            chunkMap["shard0"].push_back( loadedChunk( 10, 20, 400 ) );
+            chunkMap["shard1"].push_back( loadedChunk( 20, 30, 0 ) );
+            chunkMap["shard1"].push_back( loadedChunk( 30, 40, 0 ) );
+
+            ASSERT( ! BalancerPolicy::balance( "ns", noLimits(), chunkMap, 0 ) );
+        }
+    };
+
+    class BalanceSingleHotChunkTest {
+    public:
+        void run() {
+            // moving the only hot chunk would just move the hot spot
+            BalancerPolicy::ShardToChunksMap chunkMap;
+            chunkMap["shard0"].push_back( loadedChunk( 0, 10, 10000 ) );
+            chunkMap["shard0"].push_back( loadedChunk( 10, 20, 10 ) );
+            chunkMap["shard1"].push_back( loadedChunk( 20, 30, 10 ) );
+            chunkMap["shard1"].push_back( loadedChunk( 30, 40, 10 ) );
+
+            ASSERT( ! BalancerPolicy::balance( "ns", noLimits(), chunkMap, 0 ) );
+        }
+    };
+
+    class BalanceLoadMoreChunksTest {
+    public:
+        void run() {
+            // the idle shard already holds more chunks
+            BalancerPolicy::ShardToChunksMap chunkMap;
+            chunkMap["shard0"].push_back( loadedChunk( 0, 10, 3000 ) );
+            chunkMap["shard0"].push_back( loadedChunk( 10, 20, 3000 ) );
+            for ( int i = 20; i < 50; i += 10 )
+                chunkMap["shard1"].push_back( loadedChunk( i, i + 10, 10 ) );
+
+            ASSERT( ! BalancerPolicy::balance( "ns", noLimits(), chunkMap, 1 ) );
+        }
+    };
+
+    class PickIdlestChunkTest {
+    public:
+        void run() {
+            // when evening out chunk counts, the idlest chunk moves
+            BalancerPolicy::ShardToChunksMap chunkMap;
+            vector<BSONObj>& chunks0 = chunkMap["shard0"];
+            chunks0.push_back( loadedChunk( 0, 10, 300 ) );
+            chunks0.push_back( loadedChunk( 10, 20, 200 ) );
+            chunks0.push_back( loadedChunk( 20, 30, 5 ) );
+            chunks0.push_back( loadedChunk( 30, 40, 100 ) );
+            chunkMap["shard1"];
+
+            BalancerPolicy::ChunkInfo* c = BalancerPolicy::balance( "ns", noLimits(), chunkMap, 0 );
+            ASSERT( c );
+            ASSERT_EQUALS( c->from , "shard0" );
+            ASSERT_EQUALS( c->to , "shard1" );
+            ASSERT_EQUALS( 20 , c->chunk["min"].Obj()["x"].numberInt() );
+            delete c;
+        }
+    };
 
     class All : public Suite {
     public:
@@ -190,13 +299,19 @@ namespace BalancerPolicyTests {
         }
 
         void setupTests() {
-            // TODO SERVER-1822
-            // add< SizeMaxedShardTest >();
-            // add< DrainingShardTest >();
-            // add< BalanceNormalTest >();
-            // add< BalanceDrainingTest >();
-            // add< BalanceEndedDrainingTest >();
-            // add< BalanceImpasseTest >();
+            add< SizeMaxedShardTest >();
+            add< DrainingShardTest >();
+            add< BalanceNormalTest >();
+            add< BalanceDrainingTest >();
+            add< BalanceEndedDrainingTest >();
+            add< BalanceImpasseTest >();
+            add< ChunkOpsTest >();
+            add< BalanceLoadTest >();
+            add< BalanceEvenLoadTest >();
+            add< BalanceLittleLoadTest >();
+            add< BalanceSingleHotChunkTest >();
+            add< BalanceLoadMoreChunksTest >();
+            add< PickIdlestChunkTest >();
         }
     } allTests;
 
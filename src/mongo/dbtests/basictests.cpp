@@ -25,6 +25,7 @@
 #include "../util/text.h"
 #include "../util/queue.h"
 #include "../util/paths.h"
+#include "../util/persistent_map.h"
 #include "../util/stringutils.h"
 #include "../util/compress.h"
 #include "../db/db.h"
@@ -605,6 +606,55 @@ namespace BasicTests {
         }
     };
 
+    class PersistentMapTest {
+    public:
+        typedef PersistentMap<int,int> IntMap;
+
+        void run() {
+            IntMap a;
+            map<int,int> expected;
+            for( int i = 0; i < 1000; i++ ) {
+                int k = ( i * 7919 ) % 1000;
+                ASSERT( a.insert( make_pair( k, i ) ) );
+                expected[ k ] = i;
+            }
+            ASSERT( ! a.insert( make_pair( 0, -1 ) ) );
+
+            // modifying a copy leaves the original alone
+            IntMap b = a;
+            b.erase( b.lower_bound( 100 ), b.lower_bound( 200 ) );
+            b.set( 5, -5 );
+            ASSERT_EQUALS( 1u, b.erase( 999 ) );
+            ASSERT_EQUALS( 0u, b.erase( 999 ) );
+            assertSame( expected, a );
+
+            map<int,int> expectedB( expected );
+            expectedB.erase( expectedB.lower_bound( 100 ), expectedB.lower_bound( 200 ) );
+            expectedB[ 5 ] = -5;
+            expectedB.erase( 999 );
+            assertSame( expectedB, b );
+
+            ASSERT( b.find( 150 ) == b.end() );
+            ASSERT_EQUALS( 200, b.upper_bound( 99 )->first );
+            ASSERT_EQUALS( 99, (--b.lower_bound( 200 ))->first );
+            ASSERT_EQUALS( 998, (--b.end())->first );
+        }
+
+        void assertSame( const map<int,int>& expected, const IntMap& m ) {
+            ASSERT_EQUALS( expected.size(), m.size() );
+            map<int,int>::const_iterator e = expected.begin();
+            for( IntMap::const_iterator i = m.begin(); i != m.end(); ++i, ++e ) {
+                ASSERT_EQUALS( e->first, i->first );
+                ASSERT_EQUALS( e->second, i->second );
+            }
+            map<int,int>::const_reverse_iterator r = expected.rbegin();
+            for( IntMap::const_iterator i = m.end(); i != m.begin(); ++r ) {
+                --i;
+                ASSERT_EQUALS( r->first, i->first );
+            }
+        }
+    };
+
     class StrTests {
     public:
 
@@ -756,6 +806,7 @@ namespace BasicTests {
             add< IsValidUTF8Test >();
 
             add< QueueTest >();
+            add< PersistentMapTest >();
 
             add< StrTests >();
 
@@ -29,6 +29,8 @@ namespace mongo {
     public:
         void setShardKey( const BSONObj &keyPattern ) {
             const_cast<ShardKeyPattern&>(_key) = ShardKeyPattern( keyPattern );
+            const_cast<ChunkCollectionInfoPtr&>(_coll).reset(
+                    new ChunkCollectionInfo( "", _key, 1 ) );
         }
         void setSingleChunkForShards( const vector<BSONObj> &splitPoints ) {
             ChunkMap &chunkMap = const_cast<ChunkMap&>( _chunkMap );
@@ -46,7 +48,7 @@ namespace mongo {
                 
                 ChunkPtr chunk( new Chunk( this, mySplitPoints[ i-1 ], mySplitPoints[ i ],
                                           shard ) );
-                chunkMap[ mySplitPoints[ i ] ] = chunk;
+                chunkMap.set( mySplitPoints[ i ], chunk );
             }
             
             chunkRanges.reloadAll( chunkMap );
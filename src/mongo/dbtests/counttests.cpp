@@ -132,6 +132,27 @@ namespace CountTests {
         }
     };
 
+    /** Exact key matches are counted a btree bucket at a time, honoring skip and limit. */
+    class IndexedEquality : public Base {
+    public:
+        void run() {
+            for( int i = 0; i < 3000; ++i ) {
+                insert( BSON( "a" << i % 3 ) );
+            }
+            string err;
+            ASSERT_EQUALS( 1000, runCount( ns(), countCommand( BSON( "a" << 1 ) ), err ) );
+            ASSERT_EQUALS( 1000, runCount( ns(), countCommand( BSON( "a" << 1.0 ) ), err ) );
+            ASSERT_EQUALS( 0, runCount( ns(), countCommand( BSON( "a" << 5 ) ), err ) );
+            ASSERT_EQUALS( 1, runCount( ns(), BSON( "query" << BSON( "a" << 2 ) << "skip" << 999 ),
+                                       err ) );
+            ASSERT_EQUALS( 500, runCount( ns(), BSON( "query" << BSON( "a" << 2 ) << "skip" << 10 <<
+                                                      "limit" << 500 ), err ) );
+            ASSERT_EQUALS( 990, runCount( ns(), BSON( "query" << BSON( "a" << 0 ) << "skip" << 10 <<
+                                                      "limit" << 995 ), err ) );
+            ASSERT_EQUALS( "", err );
+        }
+    };
+
     /** Set a value or await an expected value. */
     class PendingValue {
     public:
@@ -195,9 +216,9 @@ namespace CountTests {
     public:
         void run() {
             // Insert enough documents that counting them will exceed the iteration threshold
-            // to trigger a yield.
+            // to trigger a yield.  Distinct values, as equal keys are counted a bucket at a time.
             for( int i = 0; i < 1000; ++i ) {
-                insert( BSON( "a" << 1 ) );
+                insert( BSON( "a" << i ) );
             }
             
             // Call runCount() under a read lock.
@@ -207,7 +228,7 @@ namespace CountTests {
             int numYieldsBeforeCount = numYields();
             
             string err;
-            ASSERT_EQUALS( 1000, runCount( ns(), countCommand( BSON( "a" << 1 ) ), err ) );
+            ASSERT_EQUALS( 1000, runCount( ns(), countCommand( BSON( "a" << GTE << 0 ) ), err ) );
             ASSERT_EQUALS( "", err );
 
             int numYieldsAfterCount = numYields();
@@ -236,6 +257,7 @@ namespace CountTests {
             add<Fields>();
             add<QueryFields>();
             add<IndexedRegex>();
+            add<IndexedEquality>();
             add<Yield>();
         }
     } myall;
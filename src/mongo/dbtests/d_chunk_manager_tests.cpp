@@ -444,6 +444,126 @@ namespace {
         }
     };
 
+    class FilterTests {
+    public:
+        void run() {
+            BSONObj collection = BSON( "_id"     << "x.y" <<
+                                       "dropped" << false <<
+                                       "key"     << BSON( "a" << 1 ) <<
+                                       "unique"  << false );
+
+            // every other range of 10 belongs to the shard: [0->10) , [20->30) , ... , [180->190)
+            BSONArrayBuilder b;
+            for ( int i = 0; i < 200; i += 20 ) {
+                b.append( BSON( "_id" << "x.y-a_" + BSONObjBuilder::numStr( i ) <<
+                                "ns"  << "x.y" <<
+                                "min" << BSON( "a" << i ) <<
+                                "max" << BSON( "a" << i + 10 ) ) );
+            }
+            BSONArray chunks = b.arr();
+
+            ShardChunkManager s ( collection , chunks );
+            const ShardChunkFilter& filter = s.filter();
+            ASSERT_EQUALS( filter.numChunks() , 10u );
+
+            for ( int i = -5; i < 205; i++ ) {
+                BSONObj doc = BSON( "_id" << i << "a" << i );
+                int chunk = filter.find( doc );
+                if ( i >= 0 && i < 190 && i % 20 < 10 ) {
+                    ASSERT_EQUALS( chunk , i / 20 );
+                    ASSERT_EQUALS( filter.chunkMin( chunk )["a"].numberInt() , i - i % 20 );
+                }
+                else {
+                    ASSERT_EQUALS( chunk , -1 );
+                }
+                ASSERT_EQUALS( s.belongsToMe( doc ) , chunk >= 0 );
+                ASSERT_EQUALS( filter.findKey( BSON( "a" << i ) ) , chunk );
+            }
+
+            // a missing shard key field counts as null, which sorts before numbers
+            ASSERT_EQUALS( filter.find( BSON( "b" << 5 ) ) , -1 );
+        }
+    };
+
+    class FilterCompoundTests {
+    public:
+        void run() {
+            BSONObj collection = BSON( "_id"     << "test.foo" <<
+                                       "dropped" << false <<
+                                       "key"     << BSON( "a.x" << 1 << "b" << 1 ) <<
+                                       "unique"  << false );
+
+            // [{MinKey, MinKey}->{10, 5}) , <gap> , [{20, MinKey}->{MaxKey, MaxKey})
+            BSONArray chunks = BSON_ARRAY( BSON( "_id" << "test.foo-a.x_MinKeyb_MinKey" <<
+                                                 "ns"  << "test.foo" <<
+                                                 "min" << BSON( "a.x" << MINKEY << "b" << MINKEY ) <<
+                                                 "max" << BSON( "a.x" << 10 << "b" << 5 ) ) <<
+                                           BSON( "_id" << "test.foo-a.x_20b_MinKey" <<
+                                                 "ns"  << "test.foo" <<
+                                                 "min" << BSON( "a.x" << 20 << "b" << MINKEY ) <<
+                                                 "max" << BSON( "a.x" << MAXKEY << "b" << MAXKEY ) ) );
+
+            ShardChunkManager s ( collection , chunks );
+
+            ASSERT( s.belongsToMe( BSON( "a" << BSON( "x" << 10 ) << "b" << 4 ) ) );
+            ASSERT( ! s.belongsToMe( BSON( "a" << BSON( "x" << 10 ) << "b" << 5 ) ) );
+            ASSERT( ! s.belongsToMe( BSON( "b" << 0 << "a" << BSON( "x" << 15 ) ) ) );
+            ASSERT( s.belongsToMe( BSON( "b" << 0 << "a" << BSON( "x" << 20 ) ) ) );
+            // no a.x is null, which is below 10
+            ASSERT( s.belongsToMe( BSON( "b" << 0 ) ) );
+
+            vector< pair<BSONObj,BSONObj> > gaps;
+            s.getGaps( &gaps );
+            ASSERT_EQUALS( gaps.size() , 1u );
+            ASSERT_EQUALS( gaps[0].first , BSON( "a.x" << 10 << "b" << 5 ) );
+            ASSERT_EQUALS( gaps[0].second , BSON( "a.x" << 20 << "b" << MINKEY ) );
+        }
+    };
+
+    class GapsTests {
+    public:
+        void run() {
+            BSONObj collection = BSON( "_id"     << "x.y" <<
+                                       "dropped" << false <<
+                                       "key"     << BSON( "a" << 1 ) <<
+                                       "unique"  << false );
+
+            // <gap> , [10->20) , [20->30) , <gap> , [40->50) , <gap>
+            BSONArray chunks = BSON_ARRAY( BSON( "_id" << "x.y-a_10" <<
+                                                 "ns"  << "x.y" <<
+                                                 "min" << BSON( "a" << 10 ) <<
+                                                 "max" << BSON( "a" << 20 ) ) <<
+                                           BSON( "_id" << "x.y-a_20" <<
+                                                 "ns"  << "x.y" <<
+                                                 "min" << BSON( "a" << 20 ) <<
+                                                 "max" << BSON( "a" << 30 ) ) <<
+                                           BSON( "_id" << "x.y-a_40" <<
+                                                 "ns"  << "x.y" <<
+                                                 "min" << BSON( "a" << 40 ) <<
+                                                 "max" << BSON( "a" << 50 ) ) );
+
+            ShardChunkManager s ( collection , chunks );
+
+            vector< pair<BSONObj,BSONObj> > gaps;
+            s.getGaps( &gaps );
+            ASSERT_EQUALS( gaps.size() , 3u );
+            ASSERT_EQUALS( gaps[0].first , BSON( "a" << MINKEY ) );
+            ASSERT_EQUALS( gaps[0].second , BSON( "a" << 10 ) );
+            ASSERT_EQUALS( gaps[1].first , BSON( "a" << 30 ) );
+            ASSERT_EQUALS( gaps[1].second , BSON( "a" << 40 ) );
+            ASSERT_EQUALS( gaps[2].first , BSON( "a" << 50 ) );
+            ASSERT_EQUALS( gaps[2].second , BSON( "a" << MAXKEY ) );
+
+            // no gaps once the whole key space is covered
+            ShardChunkVersion v( 1 , 0 , OID() );
+            ShardChunkManagerPtr low( s.clonePlus( BSON( "a" << MINKEY ) , BSON( "a" << 10 ) , v ) );
+            ShardChunkManagerPtr mid( low->clonePlus( BSON( "a" << 30 ) , BSON( "a" << 40 ) , v ) );
+            ShardChunkManagerPtr all( mid->clonePlus( BSON( "a" << 50 ) , BSON( "a" << MAXKEY ) , v ) );
+            all->getGaps( &gaps );
+            ASSERT( gaps.empty() );
+        }
+    };
+
     class ShardChunkManagerSuite : public Suite {
     public:
         ShardChunkManagerSuite() : Suite ( "shard_chunk_manager" ) {}
@@ -462,6 +582,9 @@ namespace {
             add< CloneSplitExceptionTests >();
             add< EmptyShardTests >();
             add< LastChunkTests >();
+            add< FilterTests >();
+            add< FilterCompoundTests >();
+            add< GapsTests >();
         }
     } shardChunkManagerSuite;
 
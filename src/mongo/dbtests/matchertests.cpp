@@ -112,6 +112,55 @@ namespace MatcherTests {
         }
     };
 
+    /** Large $in and $nin sets are checked with a hash prefilter. */
+    class LargeIn {
+    public:
+        void run() {
+            BSONArrayBuilder values;
+            for( int i = 0; i < 100; i += 2 ) {
+                values << i;
+            }
+            values << "str" << -0.0 << BSON( "x" << 1 );
+            values.appendNull();
+            BSONArray arr = values.arr();
+            Matcher in( BSON( "a" << BSON( "$in" << arr ) ) );
+            ASSERT( in.matches( BSON( "a" << 4 ) ) );
+            ASSERT( in.matches( BSON( "a" << 4.0 ) ) );
+            ASSERT( in.matches( BSON( "a" << 4LL ) ) );
+            ASSERT( in.matches( BSON( "a" << 0 ) ) );
+            ASSERT( in.matches( BSON( "a" << "str" ) ) );
+            ASSERT( in.matches( BSON( "a" << BSON( "x" << 1.0 ) ) ) );
+            ASSERT( in.matches( BSONObj() ) );
+            ASSERT( in.matches( BSON( "a" << BSON_ARRAY( 3 << 5 << 8 ) ) ) );
+            ASSERT( !in.matches( BSON( "a" << 5 ) ) );
+            ASSERT( !in.matches( BSON( "a" << 4.5 ) ) );
+            ASSERT( !in.matches( BSON( "a" << "st" ) ) );
+            ASSERT( !in.matches( BSON( "a" << BSON( "x" << 2 ) ) ) );
+
+            Matcher nin( BSON( "a" << BSON( "$nin" << arr ) ) );
+            ASSERT( nin.matches( BSON( "a" << 5 ) ) );
+            ASSERT( !nin.matches( BSON( "a" << 6.0 ) ) );
+            ASSERT( !nin.matches( BSONObj() ) );
+        }
+    };
+
+    /** Several top level fields, located in one pass over the document. */
+    class TopLevelFields {
+    public:
+        void run() {
+            Matcher m( fromjson( "{a:1,b:{$gt:2,$lt:5},c:{$ne:3},d:{$exists:false},'e.f':4}" ) );
+            ASSERT( m.matches( fromjson( "{e:{f:4},c:4,b:3,a:1}" ) ) );
+            ASSERT( m.matches( fromjson( "{a:[0,1],b:4,e:[{f:4}]}" ) ) );
+            ASSERT( !m.matches( fromjson( "{a:1,b:3,c:3,e:{f:4}}" ) ) );
+            ASSERT( !m.matches( fromjson( "{a:1,b:5,e:{f:4}}" ) ) );
+            ASSERT( !m.matches( fromjson( "{a:1,b:3,d:null,e:{f:4}}" ) ) );
+            ASSERT( !m.matches( fromjson( "{b:3,e:{f:4}}" ) ) );
+            // The first of duplicate fields is matched, as with getField().
+            ASSERT( m.matches( fromjson( "{a:1,a:2,b:3,e:{f:4}}" ) ) );
+            ASSERT( !m.matches( fromjson( "{a:2,a:1,b:3,e:{f:4}}" ) ) );
+        }
+    };
+
     class MixedNumericEmbedded {
     public:
         void run() {
@@ -363,6 +412,8 @@ namespace MatcherTests {
             add<MixedNumericEqual>();
             add<MixedNumericGt>();
             add<MixedNumericIN>();
+            add<LargeIn>();
+            add<TopLevelFields>();
             add<Size>();
             add<MixedNumericEmbedded>();
             add<ElemMatchKey>();
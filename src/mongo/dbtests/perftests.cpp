@@ -38,6 +38,7 @@
 #include "../util/checksum.h"
 #include "../util/version.h"
 #include "../db/key.h"
+#include "../db/matcher.h"
 #include "../util/compress.h"
 #include "../util/concurrency/qlock.h"
 #include <boost/filesystem/operations.hpp>
@@ -460,6 +461,52 @@ namespace PerfTests {
         }
     };
 
+    /** Matcher throughput on a document with several fields, a few of which the query reads. */
+    class MatcherBase : public NonDurTest {
+    public:
+        int n;
+        bo doc;
+        scoped_ptr<Matcher> m;
+        MatcherBase() {
+            n = 0;
+            doc = BSON( "_id" << OID() << "name" << "a string a string" << "x" << 3 <<
+                        "yaaaaaa" << 3.00009 << "obj" << BSON( "q" << false << "t" << 7 ) <<
+                        "tags" << BSON_ARRAY( "red" << "green" << "blue" ) << "zz" << 17 );
+        }
+        void timed() {
+            if( m->matches( doc ) )
+                n++;
+        }
+    };
+
+    class MatcherEq : public MatcherBase {
+    public:
+        string name() { return "Matcher-eq"; }
+        MatcherEq() { m.reset( new Matcher( BSON( "x" << 3 ) ) ); }
+    };
+
+    class MatcherMultiField : public MatcherBase {
+    public:
+        string name() { return "Matcher-multifield"; }
+        MatcherMultiField() {
+            m.reset( new Matcher( fromjson( "{zz:{$gt:10},x:3,name:{$ne:'b'},tags:'green',"
+                                            "'obj.t':7}" ) ) );
+        }
+    };
+
+    class MatcherLargeIn : public MatcherBase {
+    public:
+        string name() { return "Matcher-in100"; }
+        MatcherLargeIn() {
+            BSONArrayBuilder values;
+            for( int i = 100; i < 300; i += 2 ) {
+                values << i;
+            }
+            values << 17;
+            m.reset( new Matcher( BSON( "zz" << BSON( "$in" << values.arr() ) ) ) );
+        }
+    };
+
     class KeyTest : public B {
     public:
         KeyV1Owned a,b,c;
@@ -1151,6 +1198,9 @@ namespace PerfTests {
                 add< BSONIter >();
                 add< BSONGetFields1 >();
                 add< BSONGetFields2 >();
+                add< MatcherEq >();
+                add< MatcherMultiField >();
+                add< MatcherLargeIn >();
                 //add< TaskQueueTest >();
                 add< InsertDup >();
                 add< Insert1 >();
@@ -1352,6 +1352,142 @@ namespace QueryOptimizerTests {
             }
         };
         
+        /** With --indexIntersection, a plan intersecting two index scans is a candidate. */
+        class IndexIntersection : public Base {
+        public:
+            IndexIntersection() : _old( cmdLine.indexIntersection ) {
+                cmdLine.indexIntersection = true;
+            }
+            ~IndexIntersection() {
+                cmdLine.indexIntersection = _old;
+            }
+            void run() {
+                Helpers::ensureIndex( ns(), BSON( "a" << 1 ), false, "a_1" );
+                Helpers::ensureIndex( ns(), BSON( "b" << 1 ), false, "b_1" );
+                for( int i = 0; i < 20; ++i ) {
+                    client().insert( ns(), BSON( "a" << i % 2 << "b" << i % 5 ) );
+                }
+                
+                BSONObj query = BSON( "a" << 1 << "b" << 3 );
+                shared_ptr<QueryPlanSet> qps = makeQps( query, BSONObj() );
+                // {a:1}, {b:1}, their intersection and the unindexed plan.
+                ASSERT_EQUALS( 4, qps->nPlans() );
+                
+                FieldRangeSetPair frsp( ns(), query );
+                scoped_ptr<QueryPlan> plan( QueryPlan::make( nsd(), nsd()->findIndexByName( "a_1" ), frsp,
+                                                            &frsp, query, BSONObj() ) );
+                plan->intersectWith( nsd()->findIndexByName( "b_1" ), frsp );
+                shared_ptr<Cursor> c = plan->newCursor();
+                ASSERT_EQUALS( 0U, c->toString().find( "IntersectionCursor" ) );
+                int count = 0;
+                for( ; c->ok(); c->advance(), ++count ) {
+                    ASSERT_EQUALS( 1, c->current()[ "a" ].number() );
+                    ASSERT_EQUALS( 3, c->current()[ "b" ].number() );
+                }
+                // Documents 3 and 13 match; the {a:1} scan alone would return ten.
+                ASSERT_EQUALS( 2, count );
+            }
+        private:
+            bool _old;
+        };
+
+        /** A winning intersection is recorded in the query cache and replayed on later runs. */
+        class IndexIntersectionCached : public Base {
+        public:
+            IndexIntersectionCached() : _old( cmdLine.indexIntersection ) {
+                cmdLine.indexIntersection = true;
+            }
+            ~IndexIntersectionCached() {
+                cmdLine.indexIntersection = _old;
+            }
+            void run() {
+                Helpers::ensureIndex( ns(), BSON( "a" << 1 ), false, "a_1" );
+                Helpers::ensureIndex( ns(), BSON( "b" << 1 ), false, "b_1" );
+                for( int i = 0; i < 20; ++i ) {
+                    client().insert( ns(), BSON( "a" << i % 2 << "b" << i % 5 ) );
+                }
+
+                BSONObj query = BSON( "a" << 1 << "b" << 3 );
+                FieldRangeSetPair frsp( ns(), query );
+                scoped_ptr<QueryPlan> plan( QueryPlan::make( nsd(), nsd()->findIndexByName( "a_1" ), frsp,
+                                                            &frsp, query, BSONObj() ) );
+                plan->intersectWith( nsd()->findIndexByName( "b_1" ), frsp );
+                // As the winner of the plan race would.
+                plan->registerSelf( 5, CandidatePlanCharacter( true, false ) );
+
+                CachedQueryPlan cached = NamespaceDetailsTransient::get( ns() ).
+                        cachedQueryPlanForPattern( makePattern( query, BSONObj() ) );
+                ASSERT_EQUALS( BSON( "a" << 1 ), cached.indexKey() );
+                ASSERT_EQUALS( BSON( "b" << 1 ), cached.intersectKey() );
+
+                // Run the same query twice; both runs replay the intersection.
+                for( int run = 0; run < 2; ++run ) {
+                    shared_ptr<QueryPlanSet> qps = makeQps( query, BSONObj() );
+                    ASSERT_EQUALS( 1, qps->nPlans() );
+                    ASSERT( qps->usingCachedPlan() );
+                    ASSERT( qps->firstPlan()->intersected() );
+                    ASSERT_EQUALS( 2U, client().count( ns(), query ) );
+                }
+
+                // A recorded single index is raced against the intersection again.
+                NamespaceDetailsTransient::get( ns() ).registerCachedQueryPlanForPattern
+                        ( makePattern( query, BSONObj() ),
+                         CachedQueryPlan( BSON( "a" << 1 ), 5, CandidatePlanCharacter( true, false ) ) );
+                {
+                    shared_ptr<QueryPlanSet> qps = makeQps( query, BSONObj() );
+                    ASSERT_EQUALS( 4, qps->nPlans() );
+                    ASSERT( !qps->usingCachedPlan() );
+                }
+
+                // With intersections disabled the single index is replayed.
+                cmdLine.indexIntersection = false;
+                {
+                    shared_ptr<QueryPlanSet> qps = makeQps( query, BSONObj() );
+                    ASSERT_EQUALS( 1, qps->nPlans() );
+                    ASSERT( qps->usingCachedPlan() );
+                    ASSERT( !qps->firstPlan()->intersected() );
+                }
+            }
+        private:
+            bool _old;
+        };
+
+        /**
+         * A secondary scan longer than IntersectionCursor::BuildStep is collected across advances
+         * and survives yields; filtering starts once it is exhausted.
+         */
+        class IndexIntersectionYield : public Base {
+        public:
+            void run() {
+                Helpers::ensureIndex( ns(), BSON( "a" << 1 ), false, "a_1" );
+                Helpers::ensureIndex( ns(), BSON( "b" << 1 ), false, "b_1" );
+                for( int i = 0; i < 300; ++i ) {
+                    client().insert( ns(), BSON( "a" << i % 2 << "b" << i % 3 ) );
+                }
+
+                BSONObj query = BSON( "a" << 1 << "b" << 0 );
+                FieldRangeSetPair frsp( ns(), query );
+                scoped_ptr<QueryPlan> plan( QueryPlan::make( nsd(), nsd()->findIndexByName( "a_1" ), frsp,
+                                                            &frsp, query, BSONObj() ) );
+                plan->intersectWith( nsd()->findIndexByName( "b_1" ), frsp );
+                shared_ptr<Cursor> c = plan->newCursor();
+                ASSERT( c->supportYields() );
+                int count = 0;
+                int matches = 0;
+                for( ; c->ok(); c->advance(), ++count ) {
+                    if ( c->current()[ "b" ].number() == 0 ) {
+                        ++matches;
+                    }
+                    c->prepareToYield();
+                    c->recoverFromYield();
+                }
+                ASSERT_EQUALS( 50, matches );
+                // The {b:0} scan of 100 keys takes two steps to collect, so only the first
+                // iterate of the 150 {a:1} iterates goes unfiltered.
+                ASSERT( count <= 51 );
+            }
+        };
+        
     } // namespace QueryPlanSetTests
 
     class Base {
@@ -1605,6 +1741,9 @@ namespace QueryOptimizerTests {
             add<QueryPlanSetTests::PossiblePlans>();
             add<QueryPlanSetTests::AvoidUnhelpfulRecordedPlan>();
             add<QueryPlanSetTests::AvoidDisallowedRecordedPlan>();
+            add<QueryPlanSetTests::IndexIntersection>();
+            add<QueryPlanSetTests::IndexIntersectionCached>();
+            add<QueryPlanSetTests::IndexIntersectionYield>();
             add<MultiPlanScannerTests::ToString>();
             add<MultiPlanScannerTests::PossiblePlans>();
             add<BestGuess>();
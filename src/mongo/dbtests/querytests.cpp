@@ -1494,8 +1494,9 @@ namespace QueryTests {
         
         class TestableScanAndOrder : public ScanAndOrder {
         public:
-            TestableScanAndOrder(int startFrom, int limit, BSONObj order, const FieldRangeSet &frs)
-            : ScanAndOrder( startFrom, limit, order, frs ) {
+            TestableScanAndOrder(int startFrom, int limit, BSONObj order, const FieldRangeSet &frs,
+                                 bool allowSpill = false)
+            : ScanAndOrder( startFrom, limit, order, frs, allowSpill ) {
             }
             unsigned approxSize() const { return ScanAndOrder::approxSize(); }
         };
@@ -1503,7 +1504,7 @@ namespace QueryTests {
         
         class Base {
         protected:
-            void assertNumFilled( int expected, const Testable &t ) {
+            void assertNumFilled( int expected, Testable &t ) {
                 ASSERT_EQUALS( expected, t.size() );
                 BufBuilder bb;
                 int nout;
@@ -1554,6 +1555,120 @@ namespace QueryTests {
                 assertNumFilled( 1, t );
             }
         };
+
+        /** The best results are kept in order when there are more than the limit. */
+        class TopK : public Base {
+        public:
+            void run() {
+                FieldRangeSet frs( "n/a", BSONObj(), true );
+                Testable t( 1, 3, BSON( "a" << -1 ), frs );
+                for( int i = 0; i < 100; ++i ) {
+                    t.add( BSON( "a" << ( i * 37 ) % 100 << "b" << i ), 0 );
+                }
+                // Equal keys are returned in the order added.
+                t.add( BSON( "a" << 97 << "b" << 100 ), 0 );
+                ASSERT_EQUALS( 4, t.size() );
+                BufBuilder bb;
+                int nout;
+                t.fill( bb, 0, nout );
+                ASSERT_EQUALS( 3, nout );
+                BSONObj first( bb.buf() );
+                BSONObj second( bb.buf() + first.objsize() );
+                BSONObj third( bb.buf() + first.objsize() + second.objsize() );
+                ASSERT_EQUALS( BSON( "a" << 98 << "b" << 54 ), first );
+                ASSERT_EQUALS( BSON( "a" << 97 << "b" << 81 ), second );
+                ASSERT_EQUALS( BSON( "a" << 97 << "b" << 100 ), third );
+            }
+        };
+
+        /** Results exceeding the memory limit are sorted on disk and returned by a cursor. */
+        class Spill : public Base {
+        public:
+            void run() {
+                FieldRangeSet frs( "n/a", BSONObj(), true );
+                Testable t( 2, 0, BSON( "a" << 1 ), frs, true );
+                string big( 1024 * 1024, 'x' );
+                // More than MaxScanAndOrderBytes, and prime so the values of 'a' are distinct.
+                const int n = 43;
+                for( int i = 0; i < n; ++i ) {
+                    DiskLoc loc( 0, i );
+                    t.add( BSON( "a" << ( i * 7 ) % n << "big" << big ), &loc );
+                }
+                ASSERT( t.spilled() );
+                ASSERT_EQUALS( n - 2, t.nResults() );
+                BufBuilder bb;
+                int nout;
+                t.fill( bb, 0, nout );
+                ASSERT( nout > 0 );
+                ASSERT( nout < n - 2 );
+                int expected = 2;
+                for( const char *p = bb.buf(); p < bb.buf() + bb.len(); ++expected ) {
+                    BSONObj o( p );
+                    ASSERT_EQUALS( expected, o[ "a" ].number() );
+                    ASSERT( !o[ "$diskLoc" ].eoo() );
+                    p += o.objsize();
+                }
+                boost::shared_ptr<Cursor> c = t.remainingResults();
+                ASSERT( c.get() );
+                for( ; c->ok(); c->advance(), ++expected ) {
+                    ASSERT_EQUALS( expected, c->current()[ "a" ].number() );
+                    // 37 is the inverse of 7 modulo 43.
+                    ASSERT( DiskLoc( 0, ( expected * 37 ) % n ) == c->currLoc() );
+                }
+                ASSERT_EQUALS( n, expected );
+            }
+        };
+
+        /** Spilled results with equal keys are returned in the order added. */
+        class SpillTies : public Base {
+        public:
+            void run() {
+                FieldRangeSet frs( "n/a", BSONObj(), true );
+                Testable t( 0, 0, BSON( "a" << 1 ), frs, true );
+                string big( 1024 * 1024, 'x' );
+                const int n = 40;
+                for( int i = 0; i < n; ++i ) {
+                    t.add( BSON( "a" << i % 2 << "b" << i << "big" << big ), 0 );
+                }
+                ASSERT( t.spilled() );
+                BufBuilder bb;
+                int nout;
+                t.fill( bb, 0, nout );
+                vector<int> order;
+                for( const char *p = bb.buf(); p < bb.buf() + bb.len(); ) {
+                    BSONObj o( p );
+                    order.push_back( o[ "b" ].numberInt() );
+                    p += o.objsize();
+                }
+                ASSERT_EQUALS( nout, (int)order.size() );
+                boost::shared_ptr<Cursor> c = t.remainingResults();
+                ASSERT( c.get() );
+                for( ; c->ok(); c->advance() ) {
+                    order.push_back( c->current()[ "b" ].numberInt() );
+                }
+                ASSERT_EQUALS( n, (int)order.size() );
+                for( int i = 0; i < n; ++i ) {
+                    ASSERT_EQUALS( i < n / 2 ? i * 2 : ( i - n / 2 ) * 2 + 1, order[ i ] );
+                }
+            }
+        };
+
+        /** A result whose sort key and document can't be stored together is refused. */
+        class SpillTooLarge : public Base {
+        public:
+            void run() {
+                FieldRangeSet frs( "n/a", BSONObj(), true );
+                Testable t( 0, 0, BSON( "a" << 1 ), frs, true );
+                string big( 1024 * 1024, 'x' );
+                for( int i = 0; i < 40; ++i ) {
+                    t.add( BSON( "a" << i << "big" << big ), 0 );
+                }
+                ASSERT( t.spilled() );
+                // The key repeats the 9MB value of 'a', so the two are larger than any object.
+                string huge( 9 * 1024 * 1024, 'y' );
+                ASSERT_THROWS( t.add( BSON( "a" << huge ), 0 ), UserException );
+            }
+        };
         
     } // namespace ScanAndOrderTests
 
@@ -1626,6 +1741,10 @@ namespace QueryTests {
             
             add< ScanAndOrderTests::Unlimited >();
             add< ScanAndOrderTests::LimitOne >();
+            add< ScanAndOrderTests::TopK >();
+            add< ScanAndOrderTests::Spill >();
+            add< ScanAndOrderTests::SpillTies >();
+            add< ScanAndOrderTests::SpillTooLarge >();
         }
     } myall;
 
@@ -191,6 +191,30 @@ namespace QueryUtilTests {
             BSONObj o1_, o2_;
         };
 
+        class RegexCaseInsensitive : public RegexBase {
+        public:
+            RegexCaseInsensitive() : o1_( BSON( "" << "A1B" ) ), o2_( BSON( "" << "A1C" ) ) {}
+            virtual BSONObj query() {
+                BSONObjBuilder b;
+                b.appendRegex( "a", "^a1b", "i" );
+                return b.obj();
+            }
+            virtual BSONElement lower() { return o1_.firstElement(); }
+            virtual BSONElement upper() { return o2_.firstElement(); }
+            virtual bool upperInclusive() { return false; }
+            void run() {
+                RegexBase::run();
+                // One interval per case variant, then the regex itself.
+                FieldRangeSet s( "ns", query(), true );
+                const vector<FieldInterval> &intervals = s.range( "a" ).intervals();
+                ASSERT_EQUALS( 5U, intervals.size() );
+                ASSERT_EQUALS( string( "a1b" ), intervals[ 3 ]._lower._bound.String() );
+                ASSERT_EQUALS( string( "a1c" ), intervals[ 3 ]._upper._bound.String() );
+                ASSERT_EQUALS( RegEx, intervals[ 4 ]._lower._bound.type() );
+            }
+            BSONObj o1_, o2_;
+        };
+
         class UnhelpfulRegex : public RegexBase {
         public:
             UnhelpfulRegex() {
@@ -2090,6 +2114,7 @@ namespace QueryUtilTests {
             add<FieldRangeTests::EqGteInvalid>();
             add<FieldRangeTests::Regex>();
             add<FieldRangeTests::RegexObj>();
+            add<FieldRangeTests::RegexCaseInsensitive>();
             add<FieldRangeTests::UnhelpfulRegex>();
             add<FieldRangeTests::In>();
             add<FieldRangeTests::And>();
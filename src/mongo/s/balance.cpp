@@ -18,6 +18,8 @@
 
 #include "pch.h"
 
+#include <boost/thread/thread.hpp>
+
 #include "../db/jsobj.h"
 #include "../db/cmdline.h"
 
@@ -43,65 +45,118 @@ namespace mongo {
     int Balancer::_moveChunks( const vector<CandidateChunkPtr>* candidateChunks ) {
         int movedCount = 0;
 
-        for ( vector<CandidateChunkPtr>::const_iterator it = candidateChunks->begin(); it != candidateChunks->end(); ++it ) {
-            const CandidateChunk& chunkInfo = *it->get();
-
-            DBConfigPtr cfg = grid.getDBConfig( chunkInfo.ns );
-            verify( cfg );
-
-            ChunkManagerPtr cm = cfg->getChunkManager( chunkInfo.ns );
-            verify( cm );
-
-            const BSONObj& chunkToMove = chunkInfo.chunk;
-            ChunkPtr c = cm->findChunk( chunkToMove["min"].Obj() );
-            if ( c->getMin().woCompare( chunkToMove["min"].Obj() ) || c->getMax().woCompare( chunkToMove["max"].Obj() ) ) {
-                // likely a split happened somewhere
-                cm = cfg->getChunkManager( chunkInfo.ns , true /* reload */);
-                verify( cm );
-
-                c = cm->findChunk( chunkToMove["min"].Obj() );
-                if ( c->getMin().woCompare( chunkToMove["min"].Obj() ) || c->getMax().woCompare( chunkToMove["max"].Obj() ) ) {
-                    log() << "chunk mismatch after reload, ignoring will retry issue cm: "
-                          << c->getMin() << " min: " << chunkToMove["min"].Obj() << endl;
+        // A shard takes part in one migration at a time, as donor or as recipient, and so does a
+        // collection, but migrations between disjoint pairs of shards can run side by side.  Each
+        // pass starts every pending candidate whose shards and collection are free and waits for
+        // all of them.
+        vector<CandidateChunkPtr> pending( *candidateChunks );
+        while ( ! pending.empty() ) {
+            vector<CandidateChunkPtr> wave;
+            vector<CandidateChunkPtr> later;
+            set<string> busyShards;
+            set<string> busyCollections;
+            for ( vector<CandidateChunkPtr>::const_iterator it = pending.begin(); it != pending.end(); ++it ) {
+                const CandidateChunk& chunkInfo = *it->get();
+                if ( busyShards.count( chunkInfo.from ) || busyShards.count( chunkInfo.to ) ||
+                        busyCollections.count( chunkInfo.ns ) ) {
+                    later.push_back( *it );
                     continue;
                 }
+                busyShards.insert( chunkInfo.from );
+                busyShards.insert( chunkInfo.to );
+                busyCollections.insert( chunkInfo.ns );
+                wave.push_back( *it );
             }
+            pending.swap( later );
 
-            BSONObj res;
-            if ( c->moveAndCommit( Shard::make( chunkInfo.to ) , Chunk::MaxChunkSize , res ) ) {
-                movedCount++;
+            if ( wave.size() == 1 ) {
+                movedCount += _moveChunk( *wave[0] );
                 continue;
             }
 
-            // the move requires acquiring the collection metadata's lock, which can fail
-            log() << "balancer move failed: " << res << " from: " << chunkInfo.from << " to: " << chunkInfo.to
-                  << " chunk: " << chunkToMove << endl;
-
-            if ( res["chunkTooBig"].trueValue() ) {
-                // reload just to be safe
-                cm = cfg->getChunkManager( chunkInfo.ns );
-                verify( cm );
-                c = cm->findChunk( chunkToMove["min"].Obj() );
-                
-                log() << "forcing a split because migrate failed for size reasons" << endl;
-                
-                res = BSONObj();
-                c->singleSplit( true , res );
-                log() << "forced split results: " << res << endl;
-                
-                if ( ! res["ok"].trueValue() ) {
-                    log() << "marking chunk as jumbo: " << c->toString() << endl;
-                    c->markAsJumbo();
-                    // we increment moveCount so we do another round right away
-                    movedCount++;
-                }
+            LOG(1) << "starting " << wave.size() << " concurrent migrations" << endl;
 
+            vector<int> moved( wave.size(), 0 );
+            vector< shared_ptr<boost::thread> > threads;
+            for ( unsigned i = 0; i < wave.size(); i++ ) {
+                threads.push_back( shared_ptr<boost::thread>( new boost::thread(
+                        boost::bind( &Balancer::_moveChunkThread, this, wave[i], &moved[i] ) ) ) );
+            }
+            for ( unsigned i = 0; i < threads.size(); i++ ) {
+                threads[i]->join();
+                movedCount += moved[i];
             }
         }
 
         return movedCount;
     }
 
+    void Balancer::_moveChunkThread( CandidateChunkPtr chunkInfo, int* moved ) {
+        setThreadName( "BalancerMove" );
+        try {
+            *moved = _moveChunk( *chunkInfo );
+        }
+        catch ( std::exception& e ) {
+            log() << "caught exception while moving " << chunkInfo->chunk << " of " << chunkInfo->ns
+                  << causedBy( e ) << endl;
+        }
+    }
+
+    int Balancer::_moveChunk( const CandidateChunk& chunkInfo ) {
+        DBConfigPtr cfg = grid.getDBConfig( chunkInfo.ns );
+        verify( cfg );
+
+        ChunkManagerPtr cm = cfg->getChunkManager( chunkInfo.ns );
+        verify( cm );
+
+        const BSONObj& chunkToMove = chunkInfo.chunk;
+        ChunkPtr c = cm->findChunk( chunkToMove["min"].Obj() );
+        if ( c->getMin().woCompare( chunkToMove["min"].Obj() ) || c->getMax().woCompare( chunkToMove["max"].Obj() ) ) {
+            // likely a split happened somewhere
+            cm = cfg->getChunkManager( chunkInfo.ns , true /* reload */);
+            verify( cm );
+
+            c = cm->findChunk( chunkToMove["min"].Obj() );
+            if ( c->getMin().woCompare( chunkToMove["min"].Obj() ) || c->getMax().woCompare( chunkToMove["max"].Obj() ) ) {
+                log() << "chunk mismatch after reload, ignoring will retry issue cm: "
+                      << c->getMin() << " min: " << chunkToMove["min"].Obj() << endl;
+                return 0;
+            }
+        }
+
+        BSONObj res;
+        if ( c->moveAndCommit( Shard::make( chunkInfo.to ) , Chunk::MaxChunkSize , res ) ) {
+            return 1;
+        }
+
+        // the move requires acquiring the collection metadata's lock, which can fail
+        log() << "balancer move failed: " << res << " from: " << chunkInfo.from << " to: " << chunkInfo.to
+              << " chunk: " << chunkToMove << endl;
+
+        if ( res["chunkTooBig"].trueValue() ) {
+            // reload just to be safe
+            cm = cfg->getChunkManager( chunkInfo.ns );
+            verify( cm );
+            c = cm->findChunk( chunkToMove["min"].Obj() );
+            
+            log() << "forcing a split because migrate failed for size reasons" << endl;
+            
+            res = BSONObj();
+            c->singleSplit( true , res );
+            log() << "forced split results: " << res << endl;
+            
+            if ( ! res["ok"].trueValue() ) {
+                log() << "marking chunk as jumbo: " << c->toString() << endl;
+                c->markAsJumbo();
+                // we count it as moved so we do another round right away
+                return 1;
+            }
+
+        }
+
+        return 0;
+    }
+
     void Balancer::_ping( DBClientBase& conn, bool waiting ) {
         WriteConcern w = conn.getWriteConcern();
         conn.setWriteConcern( W_NONE );
@@ -224,6 +279,8 @@ namespace mongo {
                 continue;
             }
 
+            _addChunkLoads( ns , &shardToChunksMap );
+
             for ( vector<Shard>::iterator i=allShards.begin(); i!=allShards.end(); ++i ) {
                 // this just makes sure there is an entry in shardToChunksMap for every shard
                 Shard s = *i;
@@ -235,6 +292,46 @@ namespace mongo {
         }
     }
 
+    void Balancer::_addChunkLoads( const string& ns, map< string,vector<BSONObj> >* shardToChunksMap ) {
+        for ( map< string,vector<BSONObj> >::iterator i = shardToChunksMap->begin(); i != shardToChunksMap->end(); ++i ) {
+            vector<BSONObj>& chunks = i->second;
+
+            BSONObj res;
+            try {
+                scoped_ptr<ScopedDbConnection> conn(
+                        ScopedDbConnection::getScopedDbConnection( Shard::make( i->first ).getConnString() ) );
+                bool ok = conn->get()->runCommand( "admin" , BSON( "getChunkLoad" << ns ) , res );
+                conn->done();
+                if ( ! ok ) {
+                    LOG(1) << "couldn't get chunk load of " << ns << " from " << i->first << ": " << res << endl;
+                    continue;
+                }
+            }
+            catch ( DBException& e ) {
+                LOG(1) << "couldn't get chunk load of " << ns << " from " << i->first << ": " << e.what() << endl;
+                continue;
+            }
+
+            map<BSONObj,BSONObj,BSONObjCmp> loads;
+            BSONForEach( load , res.getObjectField( "chunks" ) ) {
+                loads[ load.Obj()["min"].Obj() ] = load.Obj();
+            }
+
+            // chunks without an entry saw no operations lately
+            for ( vector<BSONObj>::iterator c = chunks.begin(); c != chunks.end(); ++c ) {
+                map<BSONObj,BSONObj,BSONObjCmp>::const_iterator load = loads.find( (*c)["min"].Obj() );
+                BSONObj l = load == loads.end() ? BSONObj() : load->second;
+
+                BSONObjBuilder b;
+                b.appendElements( *c );
+                b << ChunkLoadFields::reads( l[ ChunkLoadFields::reads.name() ].numberLong() )
+                  << ChunkLoadFields::writes( l[ ChunkLoadFields::writes.name() ].numberLong() )
+                  << ChunkLoadFields::bytes( l[ ChunkLoadFields::bytes.name() ].numberLong() );
+                *c = b.obj();
+            }
+        }
+    }
+
     bool Balancer::_init() {
         try {
 
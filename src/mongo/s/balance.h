@@ -79,13 +79,33 @@ namespace mongo {
         void _doBalanceRound( DBClientBase& conn, vector<CandidateChunkPtr>* candidateChunks );
 
         /**
-         * Issues chunk migration request, one at a time.
+         * Adds the recent load each shard reports for its chunks of a collection, see
+         * ChunkLoadFields. Chunks of shards that can't report it are left as they are.
+         *
+         * @param ns is the collection
+         * @param shardToChunksMap (IN/OUT) the chunks of each shard, in the format of config.chunks
+         */
+        void _addChunkLoads( const string& ns, map< string,vector<BSONObj> >* shardToChunksMap );
+
+        /**
+         * Issues chunk migration requests, concurrently for chunks moving between disjoint pairs of
+         * shards.
          *
          * @param candidateChunks possible chunks to move
          * @return number of chunks effectively moved
          */
         int _moveChunks( const vector<CandidateChunkPtr>* candidateChunks );
 
+        /**
+         * Issues one chunk migration request, splitting the chunk if it is too big to move.
+         *
+         * @return 1 if the chunk moved or needs another round right away, 0 otherwise
+         */
+        int _moveChunk( const CandidateChunk& chunkInfo );
+
+        /** _moveChunk for a thread of its own, sets *moved to the result */
+        void _moveChunkThread( CandidateChunkPtr chunkInfo, int* moved );
+
         /**
          * Marks this balancer as being live on the config server(s).
          *
@@ -30,6 +30,11 @@ namespace mongo {
     BSONField<long long> LimitsFields::currSize( "currSize" );
     BSONField<bool> LimitsFields::hasOpsQueued( "hasOpsQueued" );
 
+    // chunk load fields
+    BSONField<long long> ChunkLoadFields::reads( "reads" );
+    BSONField<long long> ChunkLoadFields::writes( "writes" );
+    BSONField<long long> ChunkLoadFields::bytes( "bytes" );
+
     BalancerPolicy::ChunkInfo* BalancerPolicy::balance( const string& ns,
             const ShardToLimitsMap& shardToLimitsMap,
             const ShardToChunksMap& shardToChunksMap,
@@ -122,8 +127,8 @@ namespace mongo {
 
         }
         else {
-            // Everything is balanced here!
-            return NULL;
+            // The chunk counts are balanced here, but their load may not be.
+            return balanceByLoad( ns, shardToLimitsMap, shardToChunksMap );
         }
 
         const vector<BSONObj>& chunksFrom = shardToChunksMap.find( from )->second;
@@ -134,10 +139,109 @@ namespace mongo {
         return new ChunkInfo( ns, to, from, chunkToMove );
     }
 
+    BalancerPolicy::ChunkInfo* BalancerPolicy::balanceByLoad( const string& ns,
+            const ShardToLimitsMap& shardToLimitsMap,
+            const ShardToChunksMap& shardToChunksMap ) {
+        long long totalOps = 0;
+        long long totalBytes = 0;
+        for ( ShardToChunksIter i = shardToChunksMap.begin(); i != shardToChunksMap.end(); ++i ) {
+            for ( vector<BSONObj>::const_iterator c = i->second.begin(); c != i->second.end(); ++c ) {
+                totalOps += max( chunkOps( *c ), 0LL );
+                totalBytes += (*c)[ ChunkLoadFields::bytes.name() ].numberLong();
+            }
+        }
+        if ( totalOps < MinLoadOps )
+            return NULL;
+
+        // A chunk's load is its share of the operations plus its share of the bytes, so the
+        // collection's load adds up to 2.
+        map<string,double> shardLoads;
+        for ( ShardToChunksIter i = shardToChunksMap.begin(); i != shardToChunksMap.end(); ++i ) {
+            double& load = shardLoads[ i->first ];
+            load = 0;
+            for ( vector<BSONObj>::const_iterator c = i->second.begin(); c != i->second.end(); ++c ) {
+                load += chunkLoad( *c, totalOps, totalBytes );
+            }
+        }
+
+        pair<string,double> min( "", numeric_limits<double>::max() );
+        pair<string,double> max( "", -1 );
+        for ( map<string,double>::const_iterator i = shardLoads.begin(); i != shardLoads.end(); ++i ) {
+            BSONObj shardLimits;
+            ShardToLimitsIter it = shardToLimitsMap.find( i->first );
+            if ( it != shardToLimitsMap.end() ) shardLimits = it->second;
+
+            if ( i->second > max.second )
+                max = *i;
+            if ( i->second < min.second &&
+                 ! isSizeMaxed( shardLimits ) && ! isDraining( shardLimits ) && ! hasOpsQueued( shardLimits ) )
+                min = *i;
+        }
+
+        if ( min.first.empty() || min.first == max.first )
+            return NULL;
+
+        BSONObj maxLimits;
+        ShardToLimitsIter it = shardToLimitsMap.find( max.first );
+        if ( it != shardToLimitsMap.end() ) maxLimits = it->second;
+        if ( hasOpsQueued( maxLimits ) )
+            return NULL;
+
+        // Leave imbalances under half the load of an average shard alone.
+        const double gap = max.second - min.second;
+        const double threshold = 1.0 / shardLoads.size();
+        if ( gap < threshold )
+            return NULL;
+
+        const vector<BSONObj>& chunksFrom = shardToChunksMap.find( max.first )->second;
+        const vector<BSONObj>& chunksTo = shardToChunksMap.find( min.first )->second;
+        if ( chunksTo.size() > chunksFrom.size() ) {
+            LOG(1) << "won't even out load from " << max.first << " to " << min.first
+                   << " because it has more chunks" << endl;
+            return NULL;
+        }
+
+        // Moving a chunk carrying load l leaves a gap of |gap - 2l|, which is smallest for l near
+        // gap / 2. A move must close a fair part of the gap to be worth it: a shard whose load comes
+        // from a single chunk needs that chunk split, not moved.
+        BSONObj chunkToMove;
+        double best = gap - threshold / 2;
+        for ( vector<BSONObj>::const_iterator c = chunksFrom.begin(); c != chunksFrom.end(); ++c ) {
+            double remaining = fabs( gap - 2 * chunkLoad( *c, totalOps, totalBytes ) );
+            if ( remaining < best ) {
+                best = remaining;
+                chunkToMove = *c;
+            }
+        }
+        if ( chunkToMove.isEmpty() )
+            return NULL;
+
+        LOG(1) << "collection : " << ns << endl;
+        LOG(1) << "donor      : load " << max.second << " on " << max.first << endl;
+        LOG(1) << "receiver   : load " << min.second << " on " << min.first << endl;
+        log() << "chose [" << max.first << "] to [" << min.first << "] " << chunkToMove
+              << " to even out load" << endl;
+
+        return new ChunkInfo( ns, min.first, max.first, chunkToMove );
+    }
+
     BSONObj BalancerPolicy::pickChunk( const vector<BSONObj>& from, const vector<BSONObj>& to ) {
         // It is possible for a donor ('from') shard to have less chunks than a receiver one ('to')
         // if the donor is in draining mode.
 
+        // With load information, move the idlest chunk so that balanceByLoad need not move it back.
+        BSONObj idlest;
+        long long idlestOps = numeric_limits<long long>::max();
+        for ( vector<BSONObj>::const_iterator c = from.begin(); c != from.end(); ++c ) {
+            long long ops = chunkOps( *c );
+            if ( ops >= 0 && ops < idlestOps ) {
+                idlest = *c;
+                idlestOps = ops;
+            }
+        }
+        if ( ! idlest.isEmpty() )
+            return idlest;
+
         if ( to.size() == 0 )
             return from[0];
 
@@ -150,6 +254,21 @@ namespace mongo {
         return from[0];
     }
 
+    long long BalancerPolicy::chunkOps( const BSONObj& chunk ) {
+        BSONElement reads = chunk[ ChunkLoadFields::reads.name() ];
+        BSONElement writes = chunk[ ChunkLoadFields::writes.name() ];
+        if ( reads.eoo() && writes.eoo() )
+            return -1;
+        return reads.numberLong() + writes.numberLong();
+    }
+
+    double BalancerPolicy::chunkLoad( const BSONObj& chunk, long long totalOps, long long totalBytes ) {
+        double load = (double)max( chunkOps( chunk ), 0LL ) / totalOps;
+        if ( totalBytes > 0 )
+            load += (double)chunk[ ChunkLoadFields::bytes.name() ].numberLong() / totalBytes;
+        return load;
+    }
+
     bool BalancerPolicy::isSizeMaxed( BSONObj limits ) {
         // If there's no limit information for the shard, assume it can be a chunk receiver
         // (i.e., there's not bound on space utilization)
@@ -45,10 +45,34 @@ namespace mongo {
         static ChunkInfo* balance( const string& ns, const ShardToLimitsMap& shardToLimitsMap,
                                    const ShardToChunksMap& shardToChunksMap, int balancedLastTime );
 
+        /**
+         * Returns a suggested chunk to move so as to even out the load of a collection's shards, or NULL
+         * if the load is even enough or there is too little of it to tell. Used by balance() once the
+         * chunk counts are even.
+         *
+         * The load of a chunk is its share of the collection's operations plus its share of the bytes
+         * those read or wrote, taken from the ChunkLoadFields of the chunks in 'shardToChunksMap'. The
+         * chosen chunk carries about half the load gap between the busiest shard and the idlest one
+         * that can receive chunks. A shard never receives a chunk while it holds more chunks than the
+         * donor, and balance() evens counts out by moving the idlest chunks, so the two policies don't
+         * undo each other's moves.
+         */
+        static ChunkInfo* balanceByLoad( const string& ns, const ShardToLimitsMap& shardToLimitsMap,
+                                         const ShardToChunksMap& shardToChunksMap );
+
         // below exposed for testing purposes only -- treat it as private --
 
         static BSONObj pickChunk( const vector<BSONObj>& from, const vector<BSONObj>& to );
 
+        /**
+         * Returns the operations, reads plus writes, counted against 'chunk' in its ChunkLoadFields, or
+         * -1 if it has no load information.
+         */
+        static long long chunkOps( const BSONObj& chunk );
+
+        // too few operations to tell a hot chunk from noise, over all the chunks of a collection
+        static const long long MinLoadOps = 1000;
+
         /**
          * Returns true if a shard cannot receive any new chunks bacause it reache 'shardLimits'.
          * Expects the optional fields "maxSize", can in size in MB, and "usedSize", currently used size
@@ -72,6 +96,9 @@ namespace mongo {
         typedef ShardToChunksMap::const_iterator ShardToChunksIter;
         typedef ShardToLimitsMap::const_iterator ShardToLimitsIter;
 
+        /** the share of the operations plus the share of the bytes of a chunk, see balanceByLoad */
+        static double chunkLoad( const BSONObj& chunk, long long totalOps, long long totalBytes );
+
     };
 
     struct BalancerPolicy::ChunkInfo {
@@ -93,6 +120,16 @@ namespace mongo {
         static BSONField<bool> hasOpsQueued;  // writeback queue is not empty?
     };
 
+    /**
+     * Field names of the recent load of a chunk, as reported by getChunkLoad and added to the chunks
+     * handed to the policy.
+     */
+    struct ChunkLoadFields {
+        static BSONField<long long> reads;  // documents read
+        static BSONField<long long> writes; // documents written
+        static BSONField<long long> bytes;  // size of the above
+    };
+
 }  // namespace mongo
 
 #endif  // S_BALANCER_POLICY_HEADER
@@ -53,7 +53,7 @@ namespace mongo {
     
 
     Chunk::Chunk(const ChunkManager * manager, BSONObj from)
-        : _manager(manager), _lastmod(0, OID()), _dataWritten(mkDataWritten())
+        : _coll(manager->_coll), _lastmod(0, OID()), _dataWritten(mkDataWritten())
     {
         string ns = from.getStringField( "ns" );
         _shard.reset( from.getStringField( "shard" ) );
@@ -67,7 +67,7 @@ namespace mongo {
         _jumbo = from["jumbo"].trueValue();
 
         uassert( 10170 ,  "Chunk needs a ns" , ! ns.empty() );
-        uassert( 13327 ,  "Chunk ns must match server ns" , ns == _manager->getns() );
+        uassert( 13327 ,  "Chunk ns must match server ns" , ns == _coll->ns );
 
         uassert( 10171 ,  "Chunk needs a server" , _shard.ok() );
 
@@ -76,7 +76,7 @@ namespace mongo {
     }
 
     Chunk::Chunk(const ChunkManager * info , const BSONObj& min, const BSONObj& max, const Shard& shard, ShardChunkVersion lastmod)
-        : _manager(info), _min(min), _max(max), _shard(shard), _lastmod(lastmod), _jumbo(false), _dataWritten(mkDataWritten())
+        : _coll(info->_coll), _min(min), _max(max), _shard(shard), _lastmod(lastmod), _jumbo(false), _dataWritten(mkDataWritten())
     {}
 
     long Chunk::mkDataWritten() {
@@ -84,44 +84,44 @@ namespace mongo {
     }
 
     string Chunk::getns() const {
-        verify( _manager );
-        return _manager->getns();
+        verify( _coll );
+        return _coll->ns;
     }
 
     bool Chunk::contains( const BSONObj& obj ) const {
         return
-            _manager->getShardKey().compare( getMin() , obj ) <= 0 &&
-            _manager->getShardKey().compare( obj , getMax() ) < 0;
+            _coll->key.compare( getMin() , obj ) <= 0 &&
+            _coll->key.compare( obj , getMax() ) < 0;
     }
 
     bool ChunkRange::contains(const BSONObj& obj) const {
         // same as Chunk method
         return
-            _manager->getShardKey().compare( getMin() , obj ) <= 0 &&
-            _manager->getShardKey().compare( obj , getMax() ) < 0;
+            _coll->key.compare( getMin() , obj ) <= 0 &&
+            _coll->key.compare( obj , getMax() ) < 0;
     }
 
     bool Chunk::minIsInf() const {
-        return _manager->getShardKey().globalMin().woCompare( getMin() ) == 0;
+        return _coll->key.globalMin().woCompare( getMin() ) == 0;
     }
 
     bool Chunk::maxIsInf() const {
-        return _manager->getShardKey().globalMax().woCompare( getMax() ) == 0;
+        return _coll->key.globalMax().woCompare( getMax() ) == 0;
     }
 
     BSONObj Chunk::_getExtremeKey( int sort ) const {
         // We need to use a sharded connection here b/c there could be data left from stale migrations outside
         // our chunk ranges.
-        ShardConnection conn( getShard().getConnString() , _manager->getns() );
+        ShardConnection conn( getShard().getConnString() , getns() );
         Query q;
         if ( sort == 1 ) {
-            q.sort( _manager->getShardKey().key() );
+            q.sort( _coll->key.key() );
         }
         else {
             // need to invert shard key pattern to sort backwards
             // TODO: make a helper in ShardKeyPattern?
 
-            BSONObj k = _manager->getShardKey().key();
+            BSONObj k = _coll->key.key();
             BSONObjBuilder r;
 
             BSONObjIterator i(k);
@@ -137,7 +137,7 @@ namespace mongo {
         // find the extreme key
         BSONObj end;
         try {
-            end = conn->findOne( _manager->getns() , q );
+            end = conn->findOne( getns() , q );
             conn.done();
         }
         catch( StaleConfigException& ){
@@ -150,7 +150,7 @@ namespace mongo {
         if ( end.isEmpty() )
             return BSONObj();
 
-        return _manager->getShardKey().extractKey( end );
+        return _coll->key.extractKey( end );
     }
 
     void Chunk::pickMedianKey( BSONObj& medianKey ) const {
@@ -159,11 +159,12 @@ namespace mongo {
                 ScopedDbConnection::getScopedDbConnection( getShard().getConnString() ) );
         BSONObj result;
         BSONObjBuilder cmd;
-        cmd.append( "splitVector" , _manager->getns() );
-        cmd.append( "keyPattern" , _manager->getShardKey().key() );
+        cmd.append( "splitVector" , getns() );
+        cmd.append( "keyPattern" , _coll->key.key() );
         cmd.append( "min" , getMin() );
         cmd.append( "max" , getMax() );
         cmd.appendBool( "force" , true );
+        cmd.appendBool( "estimate" , true );
         BSONObj cmdObj = cmd.obj();
 
         if ( ! conn->get()->runCommand( "admin" , cmdObj , result )) {
@@ -187,13 +188,14 @@ namespace mongo {
                 ScopedDbConnection::getScopedDbConnection( getShard().getConnString() ) );
         BSONObj result;
         BSONObjBuilder cmd;
-        cmd.append( "splitVector" , _manager->getns() );
-        cmd.append( "keyPattern" , _manager->getShardKey().key() );
+        cmd.append( "splitVector" , getns() );
+        cmd.append( "keyPattern" , _coll->key.key() );
         cmd.append( "min" , getMin() );
         cmd.append( "max" , getMax() );
         cmd.append( "maxChunkSizeBytes" , chunkSize );
         cmd.append( "maxSplitPoints" , maxPoints );
         cmd.append( "maxChunkObjects" , maxObjs );
+        cmd.appendBool( "estimate" , true );
         BSONObj cmdObj = cmd.obj();
 
         if ( ! conn->get()->runCommand( "admin" , cmdObj , result )) {
@@ -219,7 +221,7 @@ namespace mongo {
         if ( ! force ) {
             vector<BSONObj> candidates;
             const int maxPoints = 2;
-            pickSplitVector( candidates , getManager()->getCurrentDesiredChunkSize() , maxPoints , MaxObjectPerChunk );
+            pickSplitVector( candidates , ChunkManager::getDesiredChunkSize( _coll->numChunks.get() ) , maxPoints , MaxObjectPerChunk );
             if ( candidates.size() <= 1 ) {
                 // no split points means there isn't enough data to split on
                 // 1 split point means we have between half the chunk size to full chunk size
@@ -275,7 +277,7 @@ namespace mongo {
     bool Chunk::multiSplit( const vector<BSONObj>& m , BSONObj& res ) const {
         const size_t maxSplitPoints = 8192;
 
-        uassert( 10165 , "can't split as shard doesn't have a manager" , _manager );
+        uassert( 10165 , "can't split as shard doesn't have a manager" , _coll );
         uassert( 13332 , "need a split key to split chunk" , !m.empty() );
         uassert( 13333 , "can't split a chunk in that many parts", m.size() < maxSplitPoints );
         uassert( 13003 , "can't split a chunk with only one distinct value" , _min.woCompare(_max) );
@@ -284,8 +286,8 @@ namespace mongo {
                 ScopedDbConnection::getScopedDbConnection( getShard().getConnString() ) );
 
         BSONObjBuilder cmd;
-        cmd.append( "splitChunk" , _manager->getns() );
-        cmd.append( "keyPattern" , _manager->getShardKey().key() );
+        cmd.append( "splitChunk" , getns() );
+        cmd.append( "keyPattern" , _coll->key.key() );
         cmd.append( "min" , getMin() );
         cmd.append( "max" , getMax() );
         cmd.append( "from" , getShard().getName() );
@@ -299,7 +301,9 @@ namespace mongo {
             conn->done();
 
             // Mark the minor version for *eventual* reload
-            _manager->markMinorForReload( this->_lastmod );
+            ChunkManagerPtr manager = currentManager();
+            if ( manager )
+                manager->markMinorForReload( this->_lastmod );
 
             return false;
         }
@@ -307,7 +311,7 @@ namespace mongo {
         conn->done();
         
         // force reload of config
-        _manager->reload();
+        reload();
 
         return true;
     }
@@ -315,7 +319,7 @@ namespace mongo {
     bool Chunk::moveAndCommit( const Shard& to , long long chunkSize /* bytes */, BSONObj& res ) const {
         uassert( 10167 ,  "can't move shard to its current location!" , getShard() != to );
 
-        log() << "moving chunk ns: " << _manager->getns() << " moving ( " << toString() << ") " << _shard.toString() << " -> " << to.toString() << endl;
+        log() << "moving chunk ns: " << getns() << " moving ( " << toString() << ") " << _shard.toString() << " -> " << to.toString() << endl;
 
         Shard from = _shard;
 
@@ -323,7 +327,7 @@ namespace mongo {
                 ScopedDbConnection::getScopedDbConnection( from.getConnString() ) );
 
         bool worked = fromconn->get()->runCommand( "admin" ,
-                                                   BSON( "moveChunk" << _manager->getns() <<
+                                                   BSON( "moveChunk" << getns() <<
                                                          "from" << from.getAddress().toString() <<
                                                          "to" << to.getAddress().toString() <<
                                                          // NEEDED FOR 2.0 COMPATIBILITY
@@ -345,7 +349,7 @@ namespace mongo {
         // if succeeded, needs to reload to pick up the new location
         // if failed, mongos may be stale
         // reload is excessive here as the failure could be simply because collection metadata is taken
-        _manager->reload();
+        reload();
 
         return worked;
     }
@@ -355,7 +359,7 @@ namespace mongo {
 
         try {
             _dataWritten += dataWritten;
-            int splitThreshold = getManager()->getCurrentDesiredChunkSize();
+            int splitThreshold = ChunkManager::getDesiredChunkSize( _coll->numChunks.get() );
             if ( minIsInf() || maxIsInf() ) {
                 splitThreshold = (int) ((double)splitThreshold * .9);
             }
@@ -363,11 +367,11 @@ namespace mongo {
             if ( _dataWritten < splitThreshold / ChunkManager::SplitHeuristics::splitTestFactor )
                 return false;
             
-            if ( ! getManager()->_splitHeuristics._splitTickets.tryAcquire() ) {
-                LOG(1) << "won't auto split becaue not enough tickets: " << getManager()->getns() << endl;
+            if ( ! _coll->splitTickets.tryAcquire() ) {
+                LOG(1) << "won't auto split becaue not enough tickets: " << getns() << endl;
                 return false;
             }
-            TicketHolderReleaser releaser( &(getManager()->_splitHeuristics._splitTickets) );
+            TicketHolderReleaser releaser( &_coll->splitTickets );
 
             // this is a bit ugly
             // we need it so that mongos blocks for the writes to actually be committed
@@ -393,9 +397,9 @@ namespace mongo {
                 _dataWritten = 0; // we're splitting, so should wait a bit
             }
 
-            bool shouldBalance = grid.shouldBalance( _manager->getns() );
+            bool shouldBalance = grid.shouldBalance( getns() );
 
-            log() << "autosplitted " << _manager->getns() << " shard: " << toString()
+            log() << "autosplitted " << getns() << " shard: " << toString()
                   << " on: " << splitPoint << " (splitThreshold " << splitThreshold << ")"
 #ifdef _DEBUG
                   << " size: " << getPhysicalSize() // slow - but can be useful when debugging
@@ -419,7 +423,7 @@ namespace mongo {
                     return true; // we did split even if we didn't migrate
                 }
 
-                ChunkManagerPtr cm = _manager->reload(false/*just reloaded in mulitsplit*/);
+                ChunkManagerPtr cm = reload(false/*just reloaded in mulitsplit*/);
                 ChunkPtr toMove = cm->findChunk(min);
 
                 if ( ! (toMove->getMin() == min && toMove->getMax() == max) ){
@@ -435,7 +439,7 @@ namespace mongo {
                          toMove->moveAndCommit( newLocation , MaxChunkSize , res ) );
                 
                 // update our config
-                _manager->reload();
+                reload();
             }
 
             return true;
@@ -443,7 +447,7 @@ namespace mongo {
         }
         catch ( DBException& e ) {
             // if the collection lock is taken (e.g. we're migrating), it is fine for the split to fail.
-            warning() << "could not autosplit collection " << _manager->getns() << causedBy( e ) << endl;
+            warning() << "could not autosplit collection " << getns() << causedBy( e ) << endl;
             return false;
         }
     }
@@ -454,8 +458,8 @@ namespace mongo {
 
         BSONObj result;
         uassert( 10169 ,  "datasize failed!" , conn->get()->runCommand( "admin" ,
-                 BSON( "datasize" << _manager->getns()
-                       << "keyPattern" << _manager->getShardKey().key()
+                 BSON( "datasize" << getns()
+                       << "keyPattern" << _coll->key.key()
                        << "min" << getMin()
                        << "max" << getMax()
                        << "maxSize" << ( MaxChunkSize + 1 )
@@ -475,14 +479,14 @@ namespace mongo {
 
     bool Chunk::operator==( const Chunk& s ) const {
         return
-            _manager->getShardKey().compare( _min , s._min ) == 0 &&
-            _manager->getShardKey().compare( _max , s._max ) == 0
+            _coll->key.compare( _min , s._min ) == 0 &&
+            _coll->key.compare( _max , s._max ) == 0
             ;
     }
 
     void Chunk::serialize(BSONObjBuilder& to,ShardChunkVersion myLastMod) {
 
-        to.append( "_id" , genID( _manager->getns() , _min ) );
+        to.append( "_id" , genID( getns() , _min ) );
 
         if ( myLastMod.isSet() ) {
             myLastMod.addToBSON( to, "lastmod" );
@@ -494,7 +498,7 @@ namespace mongo {
             verify(0);
         }
 
-        to << "ns" << _manager->getns();
+        to << "ns" << getns();
         to << "min" << _min;
         to << "max" << _max;
         to << "shard" << _shard.getName();
@@ -515,12 +519,20 @@ namespace mongo {
 
     string Chunk::toString() const {
         stringstream ss;
-        ss << "ns:" << _manager->getns() << " at: " << _shard.toString() << " lastmod: " << _lastmod.toString() << " min: " << _min << " max: " << _max;
+        ss << "ns:" << getns() << " at: " << _shard.toString() << " lastmod: " << _lastmod.toString() << " min: " << _min << " max: " << _max;
         return ss.str();
     }
 
     ShardKeyPattern Chunk::skey() const {
-        return _manager->getShardKey();
+        return _coll->key;
+    }
+
+    ChunkManagerPtr Chunk::currentManager() const {
+        return grid.getDBConfig( getns() )->getChunkManagerIfExists( getns() );
+    }
+
+    ChunkManagerPtr Chunk::reload( bool force ) const {
+        return grid.getDBConfig( getns() )->getChunkManager( getns(), force );
     }
 
     void Chunk::markAsJumbo() const {
@@ -577,6 +589,7 @@ namespace mongo {
         _ns( ns ),
         _key( pattern ),
         _unique( unique ),
+        _coll( new ChunkCollectionInfo( _ns, _key, SplitHeuristics::maxParallelSplits ) ),
         _chunkRanges(),
         _mutex("ChunkManager"),
         _sequenceNumber(++NextSequenceNumber)
@@ -592,6 +605,7 @@ namespace mongo {
         _ns( collDoc["_id"].type() == String ? collDoc["_id"].String() : "" ),
         _key( collDoc["key"].type() == Object ? collDoc["key"].Obj().getOwned() : BSONObj() ),
         _unique( collDoc["unique"].trueValue() ),
+        _coll( new ChunkCollectionInfo( _ns, _key, SplitHeuristics::maxParallelSplits ) ),
         _chunkRanges(),
         _mutex("ChunkManager"),
         // The shard versioning mechanism hinges on keeping track of the number of times we reloaded ChunkManager's.
@@ -614,6 +628,7 @@ namespace mongo {
         _ns( oldManager->getns() ),
         _key( oldManager->getShardKey() ),
         _unique( oldManager->isUnique() ),
+        _coll( oldManager->_coll ),
         _chunkRanges(),
         _mutex("ChunkManager"),
         _sequenceNumber(++NextSequenceNumber)
@@ -632,9 +647,15 @@ namespace mongo {
             ChunkMap chunkMap;
             set<Shard> shards;
             ShardVersionMap shardVersions;
+            vector< pair<BSONObj,BSONObj> > changed;
             Timer t;
 
-            bool success = _load( config, chunkMap, shards, shardVersions, _oldManager );
+            bool success = _load( config, chunkMap, shards, shardVersions, _oldManager, changed );
+
+            // Whether chunkMap is the old manager's map with the changed chunks applied, so that
+            // only the neighbourhood of the changes needs validating and re-ranging
+            bool incremental = success && _oldManager && _oldManager->getVersion().isSet() &&
+                               ! chunkMap.empty();
 
             if( success ){
                 {
@@ -648,14 +669,28 @@ namespace mongo {
                 }
 
                 // TODO: Merge into diff code above, so we validate in one place
-                if (_isValid(chunkMap)) {
+                if ( incremental ? _isValid( chunkMap, changed ) : _isValid( chunkMap ) ) {
                     // These variables are const for thread-safety. Since the
                     // constructor can only be called from one thread, we don't have
                     // to worry about that here.
                     const_cast<ChunkMap&>(_chunkMap).swap(chunkMap);
                     const_cast<set<Shard>&>(_shards).swap(shards);
                     const_cast<ShardVersionMap&>(_shardVersions).swap(shardVersions);
-                    const_cast<ChunkRangeManager&>(_chunkRanges).reloadAll(_chunkMap);
+
+                    ChunkRangeManager& chunkRanges = const_cast<ChunkRangeManager&>(_chunkRanges);
+                    if ( incremental ) {
+                        chunkRanges = _oldManager->_chunkRanges;
+                        for( vector< pair<BSONObj,BSONObj> >::const_iterator i = changed.begin();
+                             i != changed.end(); ++i ) {
+                            chunkRanges.reloadRange( _chunkMap, i->first, i->second );
+                        }
+                        DEV chunkRanges.assertValid( _chunkMap );
+                    }
+                    else {
+                        chunkRanges.reloadAll( _chunkMap );
+                    }
+
+                    _coll->numChunks.set( _chunkMap.size() );
 
                     // Once we load data, clear reference to old manager
                     _oldManager.reset();
@@ -685,9 +720,10 @@ namespace mongo {
      *
      * The mongos adapter here tracks all shards, and stores ranges by (max, Chunk) in the map.
      */
-    class CMConfigDiffTracker : public ConfigDiffTracker<ChunkPtr,Shard> {
+    class CMConfigDiffTracker : public ConfigDiffTracker<ChunkPtr,Shard,ChunkMap> {
     public:
-        CMConfigDiffTracker( ChunkManager* manager ) : _manager( manager ) {}
+        CMConfigDiffTracker( ChunkManager* manager, vector< pair<BSONObj,BSONObj> >* changed )
+            : _manager( manager ), _changed( changed ) {}
 
         virtual bool isTracked( const BSONObj& chunkDoc ) const {
             // Mongos tracks all shards
@@ -702,6 +738,7 @@ namespace mongo {
 
         virtual pair<BSONObj,ChunkPtr> rangeFor( const BSONObj& chunkDoc, const BSONObj& min, const BSONObj& max ) const {
             ChunkPtr c( new Chunk( _manager, chunkDoc ) );
+            _changed->push_back( make_pair( min, max ) );
             return make_pair( max, c );
         }
 
@@ -714,6 +751,7 @@ namespace mongo {
         }
 
         ChunkManager* _manager;
+        vector< pair<BSONObj,BSONObj> >* _changed;
 
     };
 
@@ -721,7 +759,8 @@ namespace mongo {
                               ChunkMap& chunkMap,
                               set<Shard>& shards,
                               ShardVersionMap& shardVersions,
-                              ChunkManagerPtr oldManager)
+                              ChunkManagerPtr oldManager,
+                              vector< pair<BSONObj,BSONObj> >& changed)
     {
 
         // Reset the max version, but not the epoch, when we aren't loading from the oldManager
@@ -737,33 +776,20 @@ namespace mongo {
             // Load a copy of the old versions
             shardVersions = oldManager->_shardVersions;
 
-            // Load a copy of the chunk map, replacing the chunk manager with our own
-            const ChunkMap& oldChunkMap = oldManager->getChunkMap();
-
-            // Could be v.expensive
-            // TODO: If chunks were immutable and didn't reference the manager, we could do more
-            // interesting things here
-            for( ChunkMap::const_iterator it = oldChunkMap.begin(); it != oldChunkMap.end(); it++ ){
-
-                ChunkPtr oldC = it->second;
-                ChunkPtr c( new Chunk( this, oldC->getMin(),
-                                             oldC->getMax(),
-                                             oldC->getShard(),
-                                             oldC->getLastmod() ) );
-
-                chunkMap.insert( make_pair( oldC->getMax(), c ) );
-            }
+            // Chunks don't reference their manager, so the old chunk map is shared as is and
+            // the diff below only copies the parts of it that change
+            chunkMap = oldManager->_chunkMap;
 
             // Also get any minor versions stored for reload
             oldManager->getMarkedMinorVersions( minorVersions );
 
             LOG(2) << "loading chunk manager for collection " << _ns
                    << " using old chunk manager w/ version " << _version.toString()
-                   << " and " << oldChunkMap.size() << " chunks" << endl;
+                   << " and " << chunkMap.size() << " chunks" << endl;
         }
 
         // Attach a diff tracker for the versioned chunk data
-        CMConfigDiffTracker differ( this );
+        CMConfigDiffTracker differ( this, &changed );
         differ.attach( _ns, chunkMap, _version, shardVersions );
 
         // Diff tracker should *always* find at least one chunk if collection exists
@@ -877,8 +903,47 @@ namespace mongo {
         ENSURE(allOfType(MinKey, chunkMap.begin()->second->getMin()));
         ENSURE(allOfType(MaxKey, boost::prior(chunkMap.end())->second->getMax()));
 
+        return _isContiguous(chunkMap.begin(), chunkMap.end());
+
+#undef ENSURE
+    }
+
+    bool ChunkManager::_isValid(const ChunkMap& chunkMap, const vector< pair<BSONObj,BSONObj> >& changed) {
+#define ENSURE(x) do { if(!(x)) { log() << "ChunkManager::_isValid failed: " #x << endl; return false; } } while(0)
+
+        if (chunkMap.empty())
+            return true;
+
+        // Check endpoints
+        ENSURE(allOfType(MinKey, chunkMap.begin()->second->getMin()));
+        ENSURE(allOfType(MaxKey, boost::prior(chunkMap.end())->second->getMax()));
+
+        // A gap or overlap left by the diff always borders a changed chunk, so it is enough to
+        // check each changed span together with the chunk on either side of it
+        for (vector< pair<BSONObj,BSONObj> >::const_iterator i = changed.begin(); i != changed.end(); ++i) {
+            ChunkMap::const_iterator begin = chunkMap.upper_bound(i->first);
+            if (begin != chunkMap.begin())
+                --begin;
+            ChunkMap::const_iterator end = chunkMap.lower_bound(i->second);
+            for (int n = 0; n < 2 && end != chunkMap.end(); ++n)
+                ++end;
+            if (!_isContiguous(begin, end))
+                return false;
+        }
+
+        return true;
+
+#undef ENSURE
+    }
+
+    bool ChunkManager::_isContiguous(ChunkMap::const_iterator begin, ChunkMap::const_iterator end) {
+#define ENSURE(x) do { if(!(x)) { log() << "ChunkManager::_isValid failed: " #x << endl; return false; } } while(0)
+
+        if (begin == end)
+            return true;
+
         // Make sure there are no gaps or overlaps
-        for (ChunkMap::const_iterator it=boost::next(chunkMap.begin()), end=chunkMap.end(); it != end; ++it) {
+        for (ChunkMap::const_iterator it=boost::next(begin); it != end; ++it) {
             ChunkMap::const_iterator last = boost::prior(it);
 
             if (!(it->second->getMin() == last->second->getMax())) {
@@ -1130,6 +1195,120 @@ namespace mongo {
         }
     }
 
+    /** @return true if an $in value matches exactly the documents equal to it */
+    static bool pointInValue( const BSONElement& e ) {
+        switch( e.type() ) {
+        case Array:
+        case RegEx:
+            return false;
+        case Object:
+            // could be read as operators once placed in a query of its own
+            return e.embeddedObject().isEmpty() || e.embeddedObject().firstElementFieldName()[0] != '$';
+        default:
+            return true;
+        }
+    }
+
+    void ChunkManager::narrowQueryForShards( const BSONObj& query , const set<Shard>& shards ,
+                                             map<Shard,BSONObj>& narrowed ) const {
+        if ( shards.size() < 2 )
+            return;
+
+        const char* keyField = _key.key().firstElementFieldName();
+
+        // per shard, the elements to use in place of the top level ones that can be narrowed
+        map< Shard, map<string,BSONObj> > replacements;
+
+        BSONForEach( e , query ) {
+            if ( str::equals( e.fieldName() , keyField ) && e.type() == Object ) {
+                BSONObj ops = e.embeddedObject();
+                BSONElement in = ops["$in"];
+                if ( in.type() != Array )
+                    continue;
+
+                map< Shard, vector<BSONElement> > values;
+                bool pointsOnly = true;
+                BSONForEach( v , in.embeddedObject() ) {
+                    if ( ! pointInValue( v ) ) {
+                        pointsOnly = false;
+                        break;
+                    }
+                    BSONObjBuilder pb;
+                    pb.appendAs( v , keyField );
+                    set<Shard> owners;
+                    getShardsForQuery( owners , pb.obj() );
+                    for ( set<Shard>::const_iterator i = owners.begin(); i != owners.end(); ++i )
+                        values[ *i ].push_back( v );
+                }
+                if ( ! pointsOnly )
+                    continue;
+
+                int n = in.embeddedObject().nFields();
+                for ( set<Shard>::const_iterator s = shards.begin(); s != shards.end(); ++s ) {
+                    const vector<BSONElement>& mine = values[ *s ];
+                    if ( (int)mine.size() == n )
+                        continue;
+
+                    BSONObjBuilder b;
+                    BSONObjBuilder sub( b.subobjStart( keyField ) );
+                    BSONForEach( op , ops ) {
+                        if ( ! str::equals( op.fieldName() , "$in" ) ) {
+                            sub.append( op );
+                            continue;
+                        }
+                        BSONArrayBuilder arr( sub.subarrayStart( "$in" ) );
+                        for ( unsigned j = 0; j < mine.size(); j++ )
+                            arr.append( mine[ j ] );
+                        arr.done();
+                    }
+                    sub.done();
+                    replacements[ *s ][ keyField ] = b.obj();
+                }
+            }
+            else if ( str::equals( e.fieldName() , "$or" ) && e.type() == Array ) {
+                map< Shard, vector<BSONObj> > clauses;
+                int n = 0;
+                BSONForEach( clause , e.embeddedObject() ) {
+                    if ( clause.type() != Object )
+                        break;
+                    ++n;
+                    set<Shard> owners;
+                    getShardsForQuery( owners , clause.embeddedObject() );
+                    for ( set<Shard>::const_iterator i = owners.begin(); i != owners.end(); ++i )
+                        clauses[ *i ].push_back( clause.embeddedObject() );
+                }
+                if ( n != e.embeddedObject().nFields() )
+                    continue;
+
+                for ( set<Shard>::const_iterator s = shards.begin(); s != shards.end(); ++s ) {
+                    const vector<BSONObj>& mine = clauses[ *s ];
+                    // $or must not be empty
+                    if ( (int)mine.size() == n || mine.empty() )
+                        continue;
+
+                    BSONObjBuilder b;
+                    BSONArrayBuilder arr( b.subarrayStart( "$or" ) );
+                    for ( unsigned j = 0; j < mine.size(); j++ )
+                        arr.append( mine[ j ] );
+                    arr.done();
+                    replacements[ *s ][ "$or" ] = b.obj();
+                }
+            }
+        }
+
+        for ( map< Shard, map<string,BSONObj> >::const_iterator s = replacements.begin(); s != replacements.end(); ++s ) {
+            BSONObjBuilder b;
+            BSONForEach( e , query ) {
+                map<string,BSONObj>::const_iterator r = s->second.find( e.fieldName() );
+                if ( r != s->second.end() )
+                    b.appendElements( r->second );
+                else
+                    b.append( e );
+            }
+            narrowed[ s->first ] = b.obj();
+        }
+    }
+
     void ChunkManager::getShardsForRange(set<Shard>& shards, const BSONObj& min, const BSONObj& max, bool fullKeyReq ) const {
 
         if( fullKeyReq ){
@@ -1262,7 +1441,7 @@ namespace mongo {
         return ss.str();
     }
 
-    void ChunkRangeManager::assertValid() const {
+    void ChunkRangeManager::assertValid(const ChunkMap& chunks) const {
         if (_ranges.empty())
             return;
 
@@ -1288,7 +1467,6 @@ namespace mongo {
             }
 
             // Make sure we match the original chunks
-            const ChunkMap chunks = _ranges.begin()->second->getManager()->_chunkMap;
             for ( ChunkMap::const_iterator i=chunks.begin(); i!=chunks.end(); ++i ) {
                 const ChunkPtr chunk = i->second;
 
@@ -1318,7 +1496,39 @@ namespace mongo {
         _ranges.clear();
         _insertRange(chunks.begin(), chunks.end());
 
-        DEV assertValid();
+        DEV assertValid(chunks);
+    }
+
+    void ChunkRangeManager::reloadRange(const ChunkMap& chunks, const BSONObj& min, const BSONObj& max) {
+        // Ranges merge neighboring chunks on the same shard, so the ranges on either side of the
+        // changed chunks may need to merge with them, or may have been merged with them before
+        ChunkRangeMap::const_iterator low = _ranges.upper_bound(min);
+        if (low == _ranges.end()) {
+            reloadAll(chunks);
+            return;
+        }
+        if (low != _ranges.begin())
+            --low;
+
+        ChunkRangeMap::const_iterator high = _ranges.lower_bound(max);
+        for (int n = 0; n < 2 && high != _ranges.end(); ++n)
+            ++high;
+
+        BSONObj regionMin = low->second->getMin();
+        BSONObj regionMax = boost::prior(high)->second->getMax();
+
+        // The chunks replacing the region must start and end on its bounds
+        ChunkMap::const_iterator begin = chunks.upper_bound(regionMin);
+        ChunkMap::const_iterator end = chunks.upper_bound(regionMax);
+        if (begin == end ||
+                !(begin->second->getMin() == regionMin) ||
+                !(boost::prior(end)->second->getMax() == regionMax)) {
+            reloadAll(chunks);
+            return;
+        }
+
+        _ranges.erase(low, high);
+        _insertRange(begin, end);
     }
 
     void ChunkRangeManager::_insertRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end) {
@@ -1329,18 +1539,16 @@ namespace mongo {
                 ++begin;
 
             shared_ptr<ChunkRange> cr (new ChunkRange(first, begin));
-            _ranges[cr->getMax()] = cr;
+            _ranges.set(cr->getMax(), cr);
         }
     }
 
-    int ChunkManager::getCurrentDesiredChunkSize() const {
+    int ChunkManager::getDesiredChunkSize( int nc ) {
         // split faster in early chunks helps spread out an initial load better
         const int minChunkSize = 1 << 20;  // 1 MBytes
 
         int splitThreshold = Chunk::MaxChunkSize;
 
-        int nc = numChunks();
-
         if ( nc <= 1 ) {
             return 1024;
         }
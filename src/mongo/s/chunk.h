@@ -27,6 +27,7 @@
 #include "shard.h"
 #include "util.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/persistent_map.h"
 
 namespace mongo {
 
@@ -39,11 +40,35 @@ namespace mongo {
     typedef shared_ptr<const Chunk> ChunkPtr;
 
     // key is max for each Chunk or ChunkRange
-    typedef map<BSONObj,ChunkPtr,BSONObjCmp> ChunkMap;
-    typedef map<BSONObj,shared_ptr<ChunkRange>,BSONObjCmp> ChunkRangeMap;
+    // copies share structure, so a reloaded ChunkManager starts from its predecessor's maps in
+    // O(1) and only pays for the chunks that changed
+    typedef PersistentMap<BSONObj,ChunkPtr,BSONObjCmp> ChunkMap;
+    typedef PersistentMap<BSONObj,shared_ptr<ChunkRange>,BSONObjCmp> ChunkRangeMap;
 
     typedef shared_ptr<const ChunkManager> ChunkManagerPtr;
 
+    /**
+     * What every version of a sharded collection's ChunkManager, and every Chunk in it, has in
+     * common.  Chunks point here rather than at a ChunkManager so that a reloaded manager can
+     * keep the unchanged Chunk objects of the manager it was based on.
+     */
+    class ChunkCollectionInfo : boost::noncopyable {
+    public:
+        ChunkCollectionInfo( const string& ns, const ShardKeyPattern& key, int maxParallelSplits )
+            : ns( ns ), key( key ), splitTickets( maxParallelSplits ) {}
+
+        const string ns;
+        const ShardKeyPattern key;
+
+        // number of chunks in the most recently loaded manager, sizes auto-splits
+        AtomicUInt numChunks;
+
+        // limits the auto-splits of the collection in progress at once
+        TicketHolder splitTickets;
+    };
+
+    typedef shared_ptr<ChunkCollectionInfo> ChunkCollectionInfoPtr;
+
     /**
        config.chunks
        { ns : "alleyinsider.fs.chunks" , min : {} , max : {} , server : "localhost:30001" }
@@ -189,14 +214,13 @@ namespace mongo {
         string getns() const;
         const char * getNS() { return "config.chunks"; }
         Shard getShard() const { return _shard; }
-        const ChunkManager* getManager() const { return _manager; }
-        
+        const ChunkCollectionInfoPtr& getCollectionInfo() const { return _coll; }
 
     private:
 
         // main shard info
-        
-        const ChunkManager * _manager;
+
+        ChunkCollectionInfoPtr _coll;
 
         BSONObj _min;
         BSONObj _max;
@@ -221,11 +245,14 @@ namespace mongo {
         static long mkDataWritten();
 
         ShardKeyPattern skey() const;
+
+        /** @return the loaded ChunkManager for our collection, if any */
+        ChunkManagerPtr currentManager() const;
+        ChunkManagerPtr reload( bool force = true ) const;
     };
 
     class ChunkRange {
     public:
-        const ChunkManager* getManager() const { return _manager; }
         Shard getShard() const { return _shard; }
 
         const BSONObj& getMin() const { return _min; }
@@ -235,14 +262,14 @@ namespace mongo {
         bool contains(const BSONObj& obj) const;
 
         ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end)
-            : _manager(begin->second->getManager())
+            : _coll(begin->second->getCollectionInfo())
             , _shard(begin->second->getShard())
             , _min(begin->second->getMin())
             , _max(boost::prior(end)->second->getMax()) {
             verify( begin != end );
 
             DEV while (begin != end) {
-                verify(begin->second->getManager() == _manager);
+                verify(begin->second->getCollectionInfo() == _coll);
                 verify(begin->second->getShard() == _shard);
                 ++begin;
             }
@@ -250,12 +277,12 @@ namespace mongo {
 
         // Merge min and max (must be adjacent ranges)
         ChunkRange(const ChunkRange& min, const ChunkRange& max)
-            : _manager(min.getManager())
+            : _coll(min._coll)
             , _shard(min.getShard())
             , _min(min.getMin())
             , _max(max.getMax()) {
             verify(min.getShard() == max.getShard());
-            verify(min.getManager() == max.getManager());
+            verify(min._coll == max._coll);
             verify(min.getMax() == max.getMin());
         }
 
@@ -264,7 +291,7 @@ namespace mongo {
         }
 
     private:
-        const ChunkManager* _manager;
+        const ChunkCollectionInfoPtr _coll;
         const Shard _shard;
         const BSONObj _min;
         const BSONObj _max;
@@ -279,8 +306,14 @@ namespace mongo {
 
         void reloadAll(const ChunkMap& chunks);
 
+        /**
+         * Rebuilds only the ranges around the chunks in [min, max), after those chunks changed.
+         * Once every changed span has been reloaded the ranges match chunks again.
+         */
+        void reloadRange(const ChunkMap& chunks, const BSONObj& min, const BSONObj& max);
+
         // Slow operation -- wrap with DEV
-        void assertValid() const;
+        void assertValid(const ChunkMap& chunks) const;
 
         ChunkRangeMap::const_iterator upper_bound(const BSONObj& o) const { return _ranges.upper_bound(o); }
         ChunkRangeMap::const_iterator lower_bound(const BSONObj& o) const { return _ranges.lower_bound(o); }
@@ -356,11 +389,18 @@ namespace mongo {
         ChunkPtr findChunkOnServer( const Shard& shard ) const;
 
         void getShardsForQuery( set<Shard>& shards , const BSONObj& query ) const;
+        /**
+         * For each of shards that needs less than all of query, sets narrowed[shard] to query with
+         * the $in values on the leading shard key field and the $or clauses that can only match
+         * elsewhere removed.  Shards missing from narrowed should be sent query unchanged.
+         */
+        void narrowQueryForShards( const BSONObj& query , const set<Shard>& shards ,
+                                   map<Shard,BSONObj>& narrowed ) const;
         void getAllShards( set<Shard>& all ) const;
         /** @param shards set to the shards covered by the interval [min, max], see SERVER-4791 */
         void getShardsForRange(set<Shard>& shards, const BSONObj& min, const BSONObj& max, bool fullKeyReq = true) const;
 
-        ChunkMap getChunkMap() const { return _chunkMap; }
+        const ChunkMap& getChunkMap() const { return _chunkMap; }
 
         /**
          * Returns true if, for this shard, the chunks are identical in both chunk managers
@@ -389,7 +429,8 @@ namespace mongo {
 
         void _printChunks() const;
 
-        int getCurrentDesiredChunkSize() const;
+        int getCurrentDesiredChunkSize() const { return getDesiredChunkSize( numChunks() ); }
+        static int getDesiredChunkSize( int numChunks );
 
     private:
         ChunkManagerPtr reload(bool force=true) const; // doesn't modify self!
@@ -399,9 +440,14 @@ namespace mongo {
         // helpers for loading
 
         // returns true if load was consistent
+        // changed is filled with the [min, max) bounds of every chunk read from the config server
         bool _load( const string& config, ChunkMap& chunks, set<Shard>& shards,
-                                    ShardVersionMap& shardVersions, ChunkManagerPtr oldManager);
+                    ShardVersionMap& shardVersions, ChunkManagerPtr oldManager,
+                    vector< pair<BSONObj,BSONObj> >& changed );
         static bool _isValid(const ChunkMap& chunks);
+        // only checks the chunks around the changed bounds, the rest must already be valid
+        static bool _isValid(const ChunkMap& chunks, const vector< pair<BSONObj,BSONObj> >& changed);
+        static bool _isContiguous(ChunkMap::const_iterator begin, ChunkMap::const_iterator end);
 
         // end helpers
 
@@ -410,6 +456,9 @@ namespace mongo {
         const ShardKeyPattern _key;
         const bool _unique;
 
+        // shared with the managers this one is based on and with our chunks
+        const ChunkCollectionInfoPtr _coll;
+
         const ChunkMap _chunkMap;
         const ChunkRangeManager _chunkRanges;
 
@@ -437,15 +486,12 @@ namespace mongo {
         public:
 
             SplitHeuristics() :
-                _splitTickets( maxParallelSplits ),
                 _staleMinorSetMutex( "SplitHeuristics::staleMinorSet" ),
                 _staleMinorCount( 0 ) {}
 
             void markMinorForReload( const string& ns, ShardChunkVersion majorVersion );
             void getMarkedMinorVersions( set<ShardChunkVersion>& minorVersions );
 
-            TicketHolder _splitTickets;
-
             mutex _staleMinorSetMutex;
 
             // mutex protects below
@@ -474,7 +520,6 @@ namespace mongo {
         //
 
         friend class Chunk;
-        friend class ChunkRangeManager; // only needed for CRM::assertValid()
         static AtomicUInt NextSequenceNumber;
         
         /** Just for testing */
@@ -514,7 +559,7 @@ namespace mongo {
         Chunk _c;
     };
     */
-    inline string Chunk::genID() const { return genID(_manager->getns(), _min); }
+    inline string Chunk::genID() const { return genID(_coll->ns, _min); }
 
     bool setShardVersion( DBClientBase & conn , const string& ns , ShardChunkVersion version , bool authoritative , BSONObj& result );
 
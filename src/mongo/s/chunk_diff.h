@@ -40,7 +40,8 @@ namespace mongo {
      * slow for big clusters, so this is the alternative for now.
      * TODO: Standardize between mongos and mongod and convert template parameters to types.
      */
-    template < class ValType, class ShardType >
+    template < class ValType, class ShardType,
+               class RangeMapType = std::map<BSONObj, ValType, BSONObjCmp> >
     class ConfigDiffTracker {
     public:
 
@@ -49,7 +50,8 @@ namespace mongo {
         //
 
         // RangeMap stores ranges indexed by max or  min key
-        typedef typename std::map<BSONObj, ValType, BSONObjCmp> RangeMap;
+        // any ordered map with the std::map insert, erase and bound methods will do
+        typedef RangeMapType RangeMap;
 
         // RangeOverlap is a pair of iterators defining a subset of ranges
         typedef typename std::pair< typename RangeMap::iterator, typename RangeMap::iterator> RangeOverlap;
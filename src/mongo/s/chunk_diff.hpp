@@ -22,8 +22,8 @@
 
 namespace mongo {
 
-    template < class ValType, class ShardType >
-    bool ConfigDiffTracker<ValType,ShardType>::
+    template < class ValType, class ShardType, class RangeMapType >
+    bool ConfigDiffTracker<ValType,ShardType,RangeMapType>::
         isOverlapping( const BSONObj& min, const BSONObj& max )
     {
         RangeOverlap overlap = overlappingRange( min, max );
@@ -31,8 +31,8 @@ namespace mongo {
         return overlap.first != overlap.second;
     }
 
-    template < class ValType, class ShardType >
-    void ConfigDiffTracker<ValType,ShardType>::
+    template < class ValType, class ShardType, class RangeMapType >
+    void ConfigDiffTracker<ValType,ShardType,RangeMapType>::
         removeOverlapping( const BSONObj& min, const BSONObj& max )
     {
         verifyAttached();
@@ -42,8 +42,8 @@ namespace mongo {
         _currMap->erase( overlap.first, overlap.second );
     }
 
-    template < class ValType, class ShardType >
-    typename ConfigDiffTracker<ValType,ShardType>::RangeOverlap ConfigDiffTracker<ValType,ShardType>::
+    template < class ValType, class ShardType, class RangeMapType >
+    typename ConfigDiffTracker<ValType,ShardType,RangeMapType>::RangeOverlap ConfigDiffTracker<ValType,ShardType,RangeMapType>::
         overlappingRange( const BSONObj& min, const BSONObj& max )
     {
         verifyAttached();
@@ -71,8 +71,8 @@ namespace mongo {
         return RangeOverlap( low, high );
     }
 
-    template < class ValType, class ShardType >
-    int ConfigDiffTracker<ValType,ShardType>::
+    template < class ValType, class ShardType, class RangeMapType >
+    int ConfigDiffTracker<ValType,ShardType,RangeMapType>::
         calculateConfigDiff( string config,
                              const set<ShardChunkVersion>& extraMinorVersions )
     {
@@ -103,8 +103,8 @@ namespace mongo {
         }
     }
 
-    template < class ValType, class ShardType >
-    int ConfigDiffTracker<ValType,ShardType>::
+    template < class ValType, class ShardType, class RangeMapType >
+    int ConfigDiffTracker<ValType,ShardType,RangeMapType>::
         calculateConfigDiff( DBClientCursorInterface& diffCursor )
     {
         verifyAttached();
@@ -177,8 +177,8 @@ namespace mongo {
         return chunksFound;
     }
 
-    template < class ValType, class ShardType >
-    Query ConfigDiffTracker<ValType,ShardType>::
+    template < class ValType, class ShardType, class RangeMapType >
+    Query ConfigDiffTracker<ValType,ShardType,RangeMapType>::
         configDiffQuery( const set<ShardChunkVersion>& extraMinorVersions ) const
     {
         verifyAttached();
@@ -24,6 +24,7 @@
 #include "../db/stats/counters.h"
 
 #include "../client/connpool.h"
+#include "../client/parallel.h"
 
 #include "client_info.h"
 #include "request.h"
@@ -174,23 +175,9 @@ namespace mongo {
             _addWriteBack( writebacks , res );
 
             // hit other machines just to block
-            for ( set<string>::const_iterator i=sinceLastGetError().begin(); i!=sinceLastGetError().end(); ++i ) {
-                string temp = *i;
-                if ( temp == theShard )
-                    continue;
-
-                try {
-                    ShardConnection conn( temp , "" );
-                    ON_BLOCK_EXIT_OBJ( conn, &ShardConnection::done );
-                    _addWriteBack( writebacks , conn->getLastErrorDetailed() );
-
-                }
-                catch( std::exception &e ){
-                    warning() << "could not clear last error from shard " << temp << causedBy( e ) << endl;
-                }
-
-            }
-            clearSinceLastGetError();
+            set<string> skip;
+            skip.insert( theShard );
+            _blockOnOtherShards( skip , writebacks );
 
             if ( writebacks.size() ){
                 vector<BSONObj> v = _handleWriteBacks( writebacks , fromWriteBackListener );
@@ -227,49 +214,68 @@ namespace mongo {
         int updatedExistingStat = 0; // 0 is none, -1 has but false, 1 has true
 
         // hit each shard
-        vector<string> errors;
-        vector<BSONObj> errorObjects;
+        // the getLastError requests are all sent before any reply is read, so the wait is for the
+        // slowest shard rather than the sum of them
+        vector< shared_ptr<ShardConnection> > conns;
+        vector< shared_ptr<Future::CommandResult> > futures;
         for ( set<string>::iterator i = shards->begin(); i != shards->end(); i++ ) {
             string theShard = *i;
             bbb.append( theShard );
-            boost::scoped_ptr<ShardConnection> conn;
-            BSONObj res;
-            bool ok = false;
             try {
-                conn.reset( new ShardConnection( theShard , "" ) ); // constructor can throw if shard is down
-                ok = (*conn)->runCommand( "admin" , options , res );
-                shardRawGLE.append( theShard , res );
+                conns.push_back( shared_ptr<ShardConnection>( new ShardConnection( theShard , "" ) ) ); // constructor can throw if shard is down
             }
             catch( std::exception &e ){
+                warning() << "could not get last error from a shard " << theShard << causedBy( e ) << endl;
+                for ( unsigned j = 0; j < futures.size(); j++ ) {
+                    futures[j]->join();
+                    conns[j]->done();
+                }
+                return false;
+            }
+            futures.push_back( Future::spawnCommand( theShard , "admin" , options , 0 , conns.back()->get() ) );
+        }
 
-              // Safe to return here, since we haven't started any extra processing yet, just collecting
-              // responses.
+        vector<string> errors;
+        vector<BSONObj> errorObjects;
+        bool failed = false;
+        for ( unsigned j = 0; j < futures.size(); j++ ) {
+            shared_ptr<Future::CommandResult> res = futures[j];
+            bool ok = res->join();
+            conns[j]->done();
 
-              warning() << "could not get last error from a shard " << theShard << causedBy( e ) << endl;
-                conn->done();
+            if ( failed )
+                continue;
 
-                return false;
+            string theShard = res->getServer();
+            if ( ! ok && res->result().isEmpty() ) {
+                // Safe to return once the other connections are cleaned up, since we haven't
+                // started any extra processing yet, just collecting responses.
+                warning() << "could not get last error from a shard " << theShard << endl;
+                failed = true;
+                continue;
             }
 
-            _addWriteBack( writebacks, res );
+            shardRawGLE.append( theShard , res->result() );
+            _addWriteBack( writebacks, res->result() );
 
-            string temp = DBClientWithCommands::getLastErrorString( res );
-            if ( (*conn)->type() != ConnectionString::SYNC && ( ok == false || temp.size() ) ) {
+            string temp = DBClientWithCommands::getLastErrorString( res->result() );
+            if ( conns[j]->get()->type() != ConnectionString::SYNC && ( ok == false || temp.size() ) ) {
                 errors.push_back( temp );
-                errorObjects.push_back( res );
+                errorObjects.push_back( res->result() );
             }
 
-            n += res["n"].numberLong();
-            if ( res["updatedExisting"].type() ) {
-                if ( res["updatedExisting"].trueValue() )
+            n += res->result()["n"].numberLong();
+            if ( res->result()["updatedExisting"].type() ) {
+                if ( res->result()["updatedExisting"].trueValue() )
                     updatedExistingStat = 1;
                 else if ( updatedExistingStat == 0 )
                     updatedExistingStat = -1;
             }
-
-            conn->done();
         }
 
+        if ( failed )
+            return false;
+
         bbb.done();
         result.append( "shardRawGLE" , shardRawGLE.obj() );
 
@@ -278,21 +284,7 @@ namespace mongo {
             result.appendBool( "updatedExisting" , updatedExistingStat > 0 );
 
         // hit other machines just to block
-        for ( set<string>::const_iterator i=sinceLastGetError().begin(); i!=sinceLastGetError().end(); ++i ) {
-            string temp = *i;
-            if ( shards->count( temp ) )
-                continue;
-
-            ShardConnection conn( temp , "" );
-            try {
-                _addWriteBack( writebacks, conn->getLastErrorDetailed() );
-            }
-            catch( std::exception &e ){
-                warning() << "could not clear last error from a shard " << temp << causedBy( e ) << endl;
-            }
-            conn.done();
-        }
-        clearSinceLastGetError();
+        _blockOnOtherShards( *shards , writebacks );
 
         if ( errors.size() == 0 ) {
             result.appendNull( "err" );
@@ -323,6 +315,34 @@ namespace mongo {
         return true;
     }
 
+    void ClientInfo::_blockOnOtherShards( const set<string>& skip , vector<WBInfo>& writebacks ) {
+        vector< shared_ptr<ShardConnection> > conns;
+        vector< shared_ptr<Future::CommandResult> > futures;
+        for ( set<string>::const_iterator i=sinceLastGetError().begin(); i!=sinceLastGetError().end(); ++i ) {
+            string temp = *i;
+            if ( skip.count( temp ) )
+                continue;
+
+            try {
+                shared_ptr<ShardConnection> conn( new ShardConnection( temp , "" ) );
+                futures.push_back( Future::spawnCommand( temp , "admin" , BSON( "getlasterror" << 1 ) , 0 , conn->get() ) );
+                conns.push_back( conn );
+            }
+            catch( std::exception &e ){
+                warning() << "could not clear last error from a shard " << temp << causedBy( e ) << endl;
+            }
+        }
+
+        for ( unsigned j = 0; j < futures.size(); j++ ) {
+            if ( futures[j]->join() || ! futures[j]->result().isEmpty() )
+                _addWriteBack( writebacks , futures[j]->result() );
+            else
+                warning() << "could not clear last error from a shard " << futures[j]->getServer() << endl;
+            conns[j]->done();
+        }
+        clearSinceLastGetError();
+    }
+
     boost::thread_specific_ptr<ClientInfo> ClientInfo::_tlInfo;
 
 } // namespace mongo
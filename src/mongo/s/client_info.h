@@ -101,6 +101,8 @@ namespace mongo {
         // for getLastError
         void _addWriteBack( vector<WBInfo>& all , const BSONObj& o );
         vector<BSONObj> _handleWriteBacks( vector<WBInfo>& all , bool fromWriteBackListener );
+        /** waits for the writes of every shard in sinceLastGetError() not in skip, all at once */
+        void _blockOnOtherShards( const set<string>& skip , vector<WBInfo>& writebacks );
 
 
         int _id; // unique client id
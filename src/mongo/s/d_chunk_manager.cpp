@@ -28,6 +28,127 @@
 
 namespace mongo {
 
+    ShardKeyExtractor::ShardKeyExtractor( const BSONObj& keyPattern )
+        : _pattern( keyPattern.getOwned() ) , _topLevel( true ) {
+        BSONObjIterator i( _pattern );
+        while ( i.more() ) {
+            const char* name = i.next().fieldName();
+            _names.push_back( name );
+            if ( strchr( name , '.' ) )
+                _topLevel = false;
+        }
+
+        BSONObjBuilder b;
+        b.appendNull( "" );
+        _null = b.obj();
+    }
+
+    void ShardKeyExtractor::extract( const BSONObj& obj , BSONElement* key ) const {
+        const unsigned n = _names.size();
+        if ( _topLevel ) {
+            for ( unsigned i = 0; i < n; i++ )
+                key[i] = BSONElement();
+            obj.getFields( n , const_cast<const char**>( &_names[0] ) , key );
+        }
+        else {
+            for ( unsigned i = 0; i < n; i++ )
+                key[i] = obj.getFieldDotted( _names[i] );
+        }
+
+        for ( unsigned i = 0; i < n; i++ ) {
+            if ( key[i].eoo() )
+                key[i] = _null.firstElement();
+        }
+    }
+
+    static void appendBoundFields( const BSONObj& bound , unsigned nFields , vector<BSONElement>* fields ) {
+        verify( (unsigned)bound.nFields() == nFields );
+        BSONObjIterator i( bound );
+        while ( i.more() )
+            fields->push_back( i.next() );
+    }
+
+    ShardChunkFilter::ShardChunkFilter( const ShardKeyExtractor& extractor , const map<BSONObj,BSONObj,BSONObjCmp>& chunks )
+        : _extractor( extractor ) , _nFields( extractor.nFields() ) {
+        _mins.reserve( chunks.size() );
+        _maxs.reserve( chunks.size() );
+        _minFields.reserve( chunks.size() * _nFields );
+        _maxFields.reserve( chunks.size() * _nFields );
+
+        for ( map<BSONObj,BSONObj,BSONObjCmp>::const_iterator i = chunks.begin(); i != chunks.end(); ++i ) {
+            _mins.push_back( i->first );
+            _maxs.push_back( i->second );
+            appendBoundFields( i->first , _nFields , &_minFields );
+            appendBoundFields( i->second , _nFields , &_maxFields );
+        }
+    }
+
+    int ShardChunkFilter::_compare( const vector<BSONElement>& bounds , int i , const BSONElement* key ) const {
+        const BSONElement* bound = &bounds[ i * _nFields ];
+        for ( unsigned j = 0; j < _nFields; j++ ) {
+            int x = bound[j].woCompare( key[j] , false );
+            if ( x )
+                return x;
+        }
+        return 0;
+    }
+
+    int ShardChunkFilter::find( const BSONElement* key ) const {
+        int n = _mins.size();
+        if ( n == 0 )
+            return -1;
+
+        // the last chunk with min <= key; both halves are kept the same size so the only data
+        // dependent step is how far base moves
+        int base = 0;
+        while ( n > 1 ) {
+            int half = n / 2;
+            base += ( _compare( _minFields , base + half , key ) <= 0 ) * half;
+            n -= half;
+        }
+
+        if ( _compare( _minFields , base , key ) > 0 || _compare( _maxFields , base , key ) <= 0 )
+            return -1;
+        return base;
+    }
+
+    // shard keys longer than this are rare enough to allocate for
+    static const unsigned LocalKeyFields = 8;
+
+    int ShardChunkFilter::find( const BSONObj& obj ) const {
+        if ( _mins.empty() )
+            return -1;
+
+        BSONElement local[LocalKeyFields];
+        boost::scoped_array<BSONElement> big;
+        BSONElement* key = local;
+        if ( _nFields > LocalKeyFields ) {
+            big.reset( new BSONElement[_nFields] );
+            key = big.get();
+        }
+
+        _extractor.extract( obj , key );
+        return find( key );
+    }
+
+    int ShardChunkFilter::findKey( const BSONObj& keyObj ) const {
+        if ( _mins.empty() )
+            return -1;
+
+        BSONElement local[LocalKeyFields];
+        boost::scoped_array<BSONElement> big;
+        BSONElement* key = local;
+        if ( _nFields > LocalKeyFields ) {
+            big.reset( new BSONElement[_nFields] );
+            key = big.get();
+        }
+
+        BSONObjIterator it( keyObj );
+        for ( unsigned i = 0; i < _nFields; i++ )
+            key[i] = it.next();
+        return find( key );
+    }
+
     /**
      * This is an adapter so we can use config diffs - mongos and mongod do them slightly
      * differently
@@ -232,6 +353,9 @@ namespace mongo {
         verify( ! min.isEmpty() );
 
         _rangesMap.insert( make_pair( min , max ) );
+
+        _filter = ShardChunkFilter( ShardKeyExtractor( _key ) , _chunksMap );
+        _loadCounters.reset( new ChunkLoadCounters[ _chunksMap.size() ] );
     }
 
     static bool contains( const BSONObj& min , const BSONObj& max , const BSONObj& point ) {
@@ -242,34 +366,33 @@ namespace mongo {
         verify( cc );
         if ( _rangesMap.size() == 0 )
             return false;
-        
-        return _belongsToMe( cc->extractFields( _key , true ) );
-    }
-
-    bool ShardChunkManager::belongsToMe( const BSONObj& obj ) const {
-        if ( _rangesMap.size() == 0 )
-            return false;
 
-        return _belongsToMe( obj.extractFields( _key , true ) );
+        return _filter.findKey( cc->extractFields( _key , true ) ) >= 0;
     }
 
-    bool ShardChunkManager::_belongsToMe( const BSONObj& x ) const {
-        RangeMap::const_iterator it = _rangesMap.upper_bound( x );
-        if ( it != _rangesMap.begin() )
-            it--;
-
-        bool good = contains( it->first , it->second , x );
+    void ShardChunkManager::getGaps( vector< pair<BSONObj,BSONObj> >* gaps ) const {
+        verify( gaps );
+        gaps->clear();
+
+        BSONObjBuilder minb;
+        BSONObjBuilder maxb;
+        BSONObjIterator i( _key );
+        while ( i.more() ) {
+            const char* field = i.next().fieldName();
+            minb.appendMinKey( field );
+            maxb.appendMaxKey( field );
+        }
 
-#if 0
-        if ( ! good ) {
-            log() << "bad: " << x << " " << it->first << " " << x.woCompare( it->first ) << " " << x.woCompare( it->second ) << endl;
-            for ( RangeMap::const_iterator i=_rangesMap.begin(); i!=_rangesMap.end(); ++i ) {
-                log() << "\t" << i->first << "\t" << i->second << "\t" << endl;
-            }
+        BSONObj min = minb.obj();
+        for ( RangeMap::const_iterator it = _rangesMap.begin(); it != _rangesMap.end(); ++it ) {
+            if ( min.woCompare( it->first ) < 0 )
+                gaps->push_back( make_pair( min , it->first ) );
+            min = it->second;
         }
-#endif
 
-        return good;
+        BSONObj max = maxb.obj();
+        if ( min.woCompare( max ) < 0 )
+            gaps->push_back( make_pair( min , max ) );
     }
 
     bool ShardChunkManager::getNextChunk( const BSONObj& lookupKey, BSONObj* foundMin , BSONObj* foundMax ) const {
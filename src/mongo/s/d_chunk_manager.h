@@ -20,6 +20,7 @@
 
 #include "../pch.h"
 
+#include "../bson/util/atomic_int.h"
 #include "../db/jsobj.h"
 #include "util.h"
 
@@ -31,6 +32,80 @@ namespace mongo {
     class ShardChunkManager;
     typedef shared_ptr<ShardChunkManager> ShardChunkManagerPtr;
 
+    /** Operations on one chunk not yet folded into ShardingState's load statistics. */
+    struct ChunkLoadCounters {
+        AtomicUInt reads;
+        AtomicUInt writes;
+        AtomicUInt bytes;
+    };
+
+    /**
+     * The plan for pulling the shard key fields out of documents, worked out once per key pattern.
+     *
+     * extract() fills an array of elements in key pattern order that point into the document, so
+     * no key object is built.  Top level patterns are read in one pass over the document.  A
+     * missing field is returned as null, as with extractFields( pattern , true ).
+     */
+    class ShardKeyExtractor {
+    public:
+        ShardKeyExtractor() : _topLevel( true ) {}
+        explicit ShardKeyExtractor( const BSONObj& keyPattern );
+
+        unsigned nFields() const { return _names.size(); }
+
+        /** @param key OUT nFields() elements, valid as long as obj's data */
+        void extract( const BSONObj& obj , BSONElement* key ) const;
+
+    private:
+        BSONObj _pattern;
+        vector<const char*> _names; // into _pattern
+        bool _topLevel;
+        BSONObj _null;
+    };
+
+    /**
+     * The chunks of a ShardChunkManager compiled for testing one document after another.
+     *
+     * Chunk bounds are kept in flat sorted vectors and compared field by field with the
+     * elements of a ShardKeyExtractor.  The binary search halves its range whatever the outcome
+     * of each comparison, so the loop does not branch on the data.
+     */
+    class ShardChunkFilter {
+    public:
+        ShardChunkFilter() : _nFields(0) {}
+
+        /** @param chunks min -> max of disjoint chunks */
+        ShardChunkFilter( const ShardKeyExtractor& extractor , const map<BSONObj,BSONObj,BSONObjCmp>& chunks );
+
+        /**
+         * @param key shard key elements from extractor()
+         * @return the index of the chunk holding key, or -1 if no chunk does
+         */
+        int find( const BSONElement* key ) const;
+
+        /** @return the index of the chunk holding obj's shard key, or -1 */
+        int find( const BSONObj& obj ) const;
+
+        /** @return the index of the chunk holding key, a shard key in key pattern order, or -1 */
+        int findKey( const BSONObj& key ) const;
+
+        const ShardKeyExtractor& extractor() const { return _extractor; }
+        unsigned numChunks() const { return _mins.size(); }
+        const BSONObj& chunkMin( int i ) const { return _mins[i]; }
+
+    private:
+        /** compares key to the ith bound in bounds */
+        int _compare( const vector<BSONElement>& bounds , int i , const BSONElement* key ) const;
+
+        ShardKeyExtractor _extractor;
+        unsigned _nFields;
+        vector<BSONObj> _mins;
+        vector<BSONObj> _maxs;
+        // the fields of _mins and _maxs, _nFields per chunk
+        vector<BSONElement> _minFields;
+        vector<BSONElement> _maxFields;
+    };
+
     /**
      * Controls the boundaries of all the chunks for a given collection that live in this shard.
      *
@@ -105,7 +180,7 @@ namespace mongo {
          * @param obj document containing sharding keys (and, optionally, other attributes)
          * @return true if shards hold the object
          */
-        bool belongsToMe( const BSONObj& obj ) const;
+        bool belongsToMe( const BSONObj& obj ) const { return _filter.find( obj ) >= 0; }
 
         /**
          * Checks whether a document belongs to this shard.
@@ -114,7 +189,7 @@ namespace mongo {
          * @return true if shards hold the object
          */
         bool belongsToMe( ClientCursor* cc ) const;
-        
+
         /**
          * Given a chunk's min key (or empty doc), gets the boundary of the chunk following that one (the first).
          *
@@ -125,6 +200,20 @@ namespace mongo {
          */
         bool getNextChunk( const BSONObj& lookupKey, BSONObj* foundMin , BSONObj* foundMax ) const;
 
+        /**
+         * Gets the parts of the key space where this shard has no chunk, in order.
+         *
+         * @param gaps OUT the min and max of each gap; max is excluded, except for a gap ending at
+         *        the top of the key space (all MaxKey)
+         */
+        void getGaps( vector< pair<BSONObj,BSONObj> >* gaps ) const;
+
+        /** the chunks, compiled for per document lookups */
+        const ShardChunkFilter& filter() const { return _filter; }
+
+        /** @param chunk index of a chunk in filter() */
+        ChunkLoadCounters& loadCounters( int chunk ) const { return _loadCounters[chunk]; }
+
         // accessors
 
         ShardChunkVersion getVersion() const { return _version; }
@@ -134,11 +223,6 @@ namespace mongo {
         string toString() const;
     private:
 
-        /**
-         * @same as belongsToMe to but key has to be the shard key
-         */
-        bool _belongsToMe( const BSONObj& key ) const;
-
         ShardChunkVersion _collVersion;
         // highest ShardChunkVersion for which this ShardChunkManager's information is accurate
         ShardChunkVersion _version;
@@ -154,6 +238,12 @@ namespace mongo {
         // redundant but we expect high chunk continguity, expecially in small installations
         RangeMap _rangesMap;
 
+        // _chunksMap for lookups, built with _rangesMap
+        ShardChunkFilter _filter;
+
+        // one per chunk of _filter, bumped without locking by every operation on the chunk
+        boost::scoped_array<ChunkLoadCounters> _loadCounters;
+
         /** constructors helpers */
         void _fillCollectionKey( const BSONObj& collectionDoc );
         void _fillChunks( DBClientCursorInterface* cursor );
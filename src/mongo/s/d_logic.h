@@ -140,6 +140,57 @@ namespace mongo {
 
         bool inCriticalMigrateSection();
 
+        // load statistics support, read by the balancer
+
+        /**
+         * Counts an operation against the chunk holding a document.  The count goes to manager's
+         * atomic per chunk counters, and only reaches the statistics under a lock when reported.
+         *
+         * @param ns the collection
+         * @param manager the collection's current manager
+         * @param chunk the index of the chunk in manager's filter()
+         * @param write whether the operation wrote the document rather than read it
+         * @param bytes size of the data read or written
+         */
+        void noteChunkOp( const string& ns , const ShardChunkManager& manager , int chunk , bool write , int bytes );
+
+        /**
+         * Counts a logged insert or full document update, see logOp().  Updates with modifiers and deletes log
+         * objects without the shard key, and are counted through noteDocumentWrite() instead.
+         */
+        void noteChunkWrite( const char* opstr , const char* ns , const BSONObj& obj );
+
+        /**
+         * Counts a write of a stored document, an update with modifiers or a delete, before it happens.
+         */
+        void noteDocumentWrite( const char* ns , const BSONObj& doc , int bytes );
+
+        /**
+         * Appends { min , reads , writes , bytes } for each chunk of a collection that saw operations, then halves
+         * the counts so that each report weighs recent load the most.
+         */
+        void reportChunkLoad( const string& ns , BSONArrayBuilder& b );
+
+        // orphans: documents in a collection's data files that none of this shard's chunks hold
+
+        /**
+         * Checks whether queries through manager have to filter out orphans.  Worked out from the
+         * shard key index once per manager, and remembered until a range deletion.  Must be
+         * called under a lock on ns, with its database as the context.
+         *
+         * @return true if ns may hold orphans, or manager is not the current one
+         */
+        bool holdsOrphans( const string& ns , const ShardChunkManagerPtr& manager );
+
+        /** notes a write outside the chunks, which bumps orphanEpoch() */
+        void noteOrphans( const string& ns );
+
+        /** notes that a range was emptied, so orphans have to be looked for again */
+        void noteRangeDeleted( const string& ns );
+
+        /** bumped on each noteOrphans(), so queries that yielded can tell when to start filtering */
+        unsigned orphanEpoch() const { return _orphanEpoch.get(); }
+
     private:
         bool _enabled;
 
@@ -158,6 +209,37 @@ namespace mongo {
         // a ShardChunkManager carries all state we need for a collection at this shard, including its version information
         typedef map<string,ShardChunkManagerPtr> ChunkManagersMap;
         ChunkManagersMap _chunks;
+
+        struct ChunkLoad {
+            ChunkLoad() : reads( 0 ) , writes( 0 ) , bytes( 0 ) {}
+            long long reads;
+            long long writes;
+            long long bytes;
+        };
+
+        /** replaces ns's manager, folding in the load counted against the old one; _mutex held */
+        void _setManager( const string& ns , const ShardChunkManagerPtr& manager );
+
+        /** moves the counters of manager's chunks into _loads; _loadMutex held */
+        void _foldChunkLoad( const string& ns , const ShardChunkManager& manager );
+
+        // protects _loads, apart from _mutex as it is taken for every operation
+        mutable mongo::mutex _loadMutex;
+
+        // map from a namespace into the load of its chunks, keyed by their min, as folded in from
+        // the counters of its managers
+        typedef map<BSONObj,ChunkLoad,BSONObjCmp> ChunkLoadMap;
+        map<string,ChunkLoadMap> _loads;
+
+        struct OrphanVerdict {
+            OrphanVerdict() : orphans( true ) {}
+            ShardChunkManagerPtr manager;
+            bool orphans;
+        };
+
+        // map from a namespace into whether it holds orphans, protected by _mutex
+        map<string,OrphanVerdict> _orphans;
+        AtomicUInt _orphanEpoch;
     };
 
     extern ShardingState shardingState;
@@ -247,5 +329,6 @@ namespace mongo {
 
     void logOpForSharding( const char * opstr , const char * ns , const BSONObj& obj , BSONObj * patt );
     void aboutToDeleteForSharding( const Database* db , const DiskLoc& dl );
+    void noteWriteForSharding( const char * ns , const BSONObj& doc , int bytes );
 
 }
@@ -46,6 +46,7 @@
 #include "../util/startup_test.h"
 #include "../util/processinfo.h"
 #include "../util/ramlog.h"
+#include "../util/compress.h"
 
 #include "shard.h"
 #include "d_logic.h"
@@ -175,6 +176,7 @@ namespace mongo {
                 RemoveSaver rs("moveChunk",ns,"post-cleanup");
                 long long numDeleted = Helpers::removeRange( ns , min , max , true , false , cmdLine.moveParanoia ? &rs : 0, true );
                 log() << "moveChunk deleted: " << numDeleted << migrateLog;
+                shardingState.noteRangeDeleted( ns );
             }
             
             
@@ -470,7 +472,11 @@ namespace mongo {
             return true;
         }
 
-        bool clone( string& errmsg , BSONObjBuilder& result ) {
+        /**
+         * @param compress if set, the batch may be returned snappy compressed in
+         *        "compressedObjects" rather than as the "objects" array
+         */
+        bool clone( string& errmsg , BSONObjBuilder& result , bool compress ) {
             if ( ! _getActive() ) {
                 errmsg = "not active";
                 return false;
@@ -539,7 +545,18 @@ namespace mongo {
                 
             }
 
-            result.appendArray( "objects" , a.arr() );
+            BSONArray arr = a.arr();
+            if ( compress ) {
+                string packed;
+                mongo::compress( arr.objdata() , arr.objsize() , &packed );
+                // incompressible documents are sent as they are
+                if ( packed.size() < (size_t)arr.objsize() ) {
+                    result.appendBinData( "compressedObjects" , packed.size() , BinDataGeneral , packed.data() );
+                    return true;
+                }
+            }
+
+            result.appendArray( "objects" , arr );
             return true;
         }
 
@@ -681,12 +698,17 @@ namespace mongo {
 
     void logOpForSharding( const char * opstr , const char * ns , const BSONObj& obj , BSONObj * patt ) {
         migrateFromStatus.logOp( opstr , ns , obj , patt );
+        shardingState.noteChunkWrite( opstr , ns , obj );
     }
 
     void aboutToDeleteForSharding( const Database* db , const DiskLoc& dl ) {
         migrateFromStatus.aboutToDelete( db , dl );
     }
 
+    void noteWriteForSharding( const char * ns , const BSONObj& doc , int bytes ) {
+        shardingState.noteDocumentWrite( ns , doc , bytes );
+    }
+
     class TransferModsCommand : public ChunkCommandHelper {
     public:
         TransferModsCommand() : ChunkCommandHelper( "_transferMods" ) {}
@@ -702,7 +724,7 @@ namespace mongo {
         InitialCloneCommand() : ChunkCommandHelper( "_migrateClone" ) {}
 
         bool run(const string& , BSONObj& cmdObj, int, string& errmsg, BSONObjBuilder& result, bool) {
-            return migrateFromStatus.clone( errmsg, result );
+            return migrateFromStatus.clone( errmsg, result, cmdObj["compress"].trueValue() );
         }
     } initialCloneCommand;
 
@@ -1305,6 +1327,7 @@ namespace mongo {
             state = READY;
             errmsg = "";
 
+            bulkLoad = false;
             numCloned = 0;
             clonedBytes = 0;
             numCatchup = 0;
@@ -1346,6 +1369,9 @@ namespace mongo {
             ScopedDbConnection& conn = *connPtr;
             conn->getLastError(); // just test connection
 
+            // non-unique indexes to build once the initial clone is done
+            vector<BSONObj> deferredIndexes;
+
             {
                 // 1. copy indexes
                 auto_ptr<DBClientCursor> indexes = conn->getIndexes( ns );
@@ -1356,59 +1382,65 @@ namespace mongo {
 
                 Client::WriteContext ct( ns );
 
+                // If we have no documents yet, it is cheaper to build the secondary indexes over
+                // the cloned data than to maintain them one insert at a time.  Unique indexes are
+                // built first all the same, so a duplicate fails the migrate before any copying.
+                NamespaceDetails* d = nsdetails( ns.c_str() );
+                bulkLoad = ( d == 0 || d->stats.nrecords == 0 );
+
                 string system_indexes = cc().database()->name + ".system.indexes";
                 for ( unsigned i=0; i<all.size(); i++ ) {
                     BSONObj idx = all[i];
+                    if ( bulkLoad && ! IndexDetails::isIdIndexPattern( idx["key"].Obj() ) &&
+                         ! idx["unique"].trueValue() ) {
+                        deferredIndexes.push_back( idx );
+                        continue;
+                    }
                     theDataFileMgr.insertAndLog( system_indexes.c_str() , idx, true /* flag fromMigrate in oplog */ );
                 }
 
                 timing.done(1);
             }
 
-            {
+            if ( ! bulkLoad ) {
                 // 2. delete any data already in range
                 Lock::DBWrite lk( ns );
                 RemoveSaver rs( "moveChunk" , ns , "preCleanup" );
                 long long num = Helpers::removeRange( ns , min , max , true , false , cmdLine.moveParanoia ? &rs : 0, true /* flag fromMigrate in oplog */ );
-                if ( num )
+                if ( num ) {
                     warning() << "moveChunkCmd deleted data already in chunk # objects: " << num << migrateLog;
-
-                timing.done(2);
+                    shardingState.noteRangeDeleted( ns );
+                }
             }
-
+            timing.done(2);
 
             {
                 // 3. initial bulk clone
                 state = CLONE;
 
-                while ( true ) {
-                    BSONObj res;
-                    if ( ! conn->runCommand( "admin" , BSON( "_migrateClone" << 1 ) , res ) ) {  // gets array of objects to copy, in disk order
-                        state = FAIL;
-                        errmsg = "_migrateClone failed: ";
-                        errmsg += res.toString();
-                        error() << errmsg << migrateLog;
-                        conn.done();
-                        return;
+                bool cloned;
+                try {
+                    cloned = _clone( conn );
+                }
+                catch ( ... ) {
+                    try {
+                        _buildIndexes( deferredIndexes );
                     }
-
-                    BSONObj arr = res["objects"].Obj();
-                    int thisTime = 0;
-
-                    BSONObjIterator i( arr );
-                    while( i.more() ) {
-                        BSONObj o = i.next().Obj();
-                        {
-                            Lock::DBWrite lk( ns );
-                            Helpers::upsert( ns, o, true );
-                        }
-                        thisTime++;
-                        numCloned++;
-                        clonedBytes += o.objsize();
+                    catch ( std::exception& e ) {
+                        error() << "migrate failed to build deferred indexes for " << ns
+                                << " after a failed clone" << causedBy( e ) << migrateLog;
                     }
+                    throw; // the clone's exception
+                }
 
-                    if ( thisTime == 0 )
-                        break;
+                // even after a failed clone, so the collection is always indexed like the donor's
+                _buildIndexes( deferredIndexes );
+
+                if ( ! cloned ) {
+                    state = FAIL;
+                    error() << errmsg << migrateLog;
+                    conn.done();
+                    return;
                 }
 
                 timing.done(3);
@@ -1518,6 +1550,101 @@ namespace mongo {
             conn.done();
         }
 
+        /**
+         * Copies the documents of the chunk from the donor, in batches of up to 16MB.
+         * @return false and sets errmsg if the donor failed a batch
+         */
+        bool _clone( ScopedDbConnection& conn ) {
+            ElapsedTracker tracker( 128, 10 ); // same as ClientCursor::_yieldSometimesTracker
+
+            while ( true ) {
+                BSONObj res;
+                // gets array of objects to copy, in disk order
+                if ( ! conn->runCommand( "admin" , BSON( "_migrateClone" << 1 << "compress" << true ) , res ) ) {
+                    errmsg = "_migrateClone failed: ";
+                    errmsg += res.toString();
+                    return false;
+                }
+
+                string unpacked;
+                BSONObj arr;
+                if ( res["compressedObjects"].type() == BinData ) {
+                    int len;
+                    const char* packed = res["compressedObjects"].binData( len );
+                    massert( 16327 , "_migrateClone returned a corrupt compressed batch" ,
+                             uncompress( packed , len , &unpacked ) &&
+                             unpacked.size() >= 5 &&
+                             (size_t)*reinterpret_cast<const int*>( unpacked.data() ) == unpacked.size() );
+                    arr = BSONObj( unpacked.data() );
+                }
+                else {
+                    // older donors don't compress
+                    arr = res["objects"].Obj();
+                }
+
+                int thisTime = 0;
+
+                BSONObjIterator i( arr );
+                while( i.more() ) {
+                    // apply the batch in runs under one write lock, yielding between runs
+                    Lock::DBWrite lk( ns );
+                    Client::Context ctx( ns );
+                    while( i.more() ) {
+                        BSONObj o = i.next().Obj();
+                        _cloneOne( o );
+                        thisTime++;
+                        numCloned++;
+                        clonedBytes += o.objsize();
+                        if ( tracker.intervalHasElapsed() )
+                            break;
+                    }
+                }
+
+                if ( thisTime == 0 )
+                    return true;
+            }
+        }
+
+        void _cloneOne( const BSONObj& o ) {
+            if ( bulkLoad ) {
+                // the collection was empty, so plain inserts will do unless something
+                // else wrote the same _id in the meantime
+                try {
+                    theDataFileMgr.insertAndLog( ns.c_str() , o , false , true /* flag fromMigrate in oplog */ );
+                    return;
+                }
+                catch ( DBException& e ) {
+                    if ( e.getCode() != 11000 )
+                        throw;
+                }
+            }
+            Helpers::upsert( ns, o, true );
+        }
+
+        /** builds indexes in the background, so the db lock is yielded during the builds */
+        void _buildIndexes( const vector<BSONObj>& indexes ) {
+            if ( indexes.empty() )
+                return;
+
+            Timer t;
+            Client::WriteContext ct( ns );
+            string system_indexes = cc().database()->name + ".system.indexes";
+            for ( unsigned i=0; i<indexes.size(); i++ ) {
+                BSONObjBuilder b;
+                BSONObjIterator j( indexes[i] );
+                while ( j.more() ) {
+                    BSONElement e = j.next();
+                    if ( ! str::equals( e.fieldName() , "background" ) )
+                        b.append( e );
+                }
+                b.appendBool( "background" , true );
+                BSONObj idx = b.obj();
+                theDataFileMgr.insertAndLog( system_indexes.c_str() , idx, true /* flag fromMigrate in oplog */ );
+            }
+            log() << "migrate built " << indexes.size() << " deferred indexes for " << ns
+                  << " in " << t.millis() << "ms" << migrateLog;
+        }
+
         void status( BSONObjBuilder& b ) {
             b.appendBool( "active" , getActive() );
 
@@ -1672,6 +1799,9 @@ namespace mongo {
         BSONObj min;
         BSONObj max;
 
+        // the collection was empty when the migration started
+        bool bulkLoad;
+
         long long numCloned;
         long long clonedBytes;
         long long numCatchup;
@@ -229,6 +229,208 @@ namespace mongo {
         }
     } cmdCheckShardingIndex;
 
+    /**
+     * Approximates the split points of an index range from the internal levels of its btree.
+     *
+     * Only buckets above the leaves are walked, descending into the children that may hold keys in
+     * [min, max).  Of the leaves, only the ones straddling min or max are read and counted exactly,
+     * plus a sample whose average size stands in for every other leaf.  Split points are taken
+     * from the separator keys of the parents of the leaves, so each one is a real index key and a
+     * resulting chunk is off its target by at most about one leaf.
+     */
+    template< class V >
+    class SplitPointEstimator {
+    public:
+        typedef BtreeBucket<V> Bucket;
+
+        // leaves read to estimate the size of the others
+        static const int SampleLeaves = 32;
+
+        SplitPointEstimator( const IndexDetails& idx , const BSONObj& min , const BSONObj& max )
+            : _head( idx.head ) , _ordering( Ordering::make( idx.keyPattern() ) ) ,
+              _min( min ) , _max( max ) , _total( 0 ) {
+        }
+
+        /**
+         * Collects the leaves and separator keys covering the range.
+         * @return false if the tree has fewer than two levels above the leaves, in which case
+         *         scanning the range exactly is cheap anyway
+         */
+        bool collect() {
+            int height = 0;
+            for ( DiskLoc loc = _head; ; height++ ) {
+                const Bucket* b = loc.btree<V>();
+                loc = b->getN() ? DiskLoc( b->keyNode( 0 ).prevChildBucket ) : DiskLoc( b->getNextChild() );
+                if ( loc.isNull() )
+                    break;
+            }
+            if ( height < 2 )
+                return false;
+
+            _collect( _head , height , BSONObj() , BSONObj() );
+            _estimateLeaves();
+            return true;
+        }
+
+        /** @return the estimated number of keys in the range */
+        long long total() const { return (long long)_total; }
+
+        /**
+         * Adds a split key each time more than keyCount keys were passed, skipping a key equal to
+         * the previous split point as SplitVector does.
+         */
+        void pick( long long keyCount , long long maxSplitPoints ,
+                   vector<BSONObj>& splitKeys , set<BSONObj>& tooFrequentKeys ) const {
+            double currCount = 0;
+            BSONObj last = _min;
+            for ( typename vector<Item>::const_iterator i = _items.begin(); i != _items.end(); ++i ) {
+                currCount += i->count;
+                if ( ! i->leaf.isNull() || currCount <= keyCount )
+                    continue;
+
+                if ( i->key.woCompare( last , _ordering , false ) == 0 ) {
+                    tooFrequentKeys.insert( i->key );
+                    continue;
+                }
+                splitKeys.push_back( i->key );
+                last = i->key;
+                currCount = 0;
+
+                if ( maxSplitPoints && (long long)splitKeys.size() >= maxSplitPoints )
+                    break;
+            }
+        }
+
+    private:
+        /** a bucket at leaf level, or a separator key if 'leaf' is null */
+        struct Item {
+            DiskLoc leaf;
+            bool boundary; // the leaf may hold keys outside [min, max)
+            double count;
+            BSONObj key;
+        };
+
+        int compare( const BSONObj& l , const BSONObj& r ) const {
+            return l.woCompare( r , _ordering , false );
+        }
+
+        /**
+         * Walks a bucket whose keys all lie within [lower, upper], where an empty bound stands for
+         * the end of the index.  Children one level up from the leaves are recorded as items.
+         */
+        void _collect( const DiskLoc& loc , int height , const BSONObj& lower , const BSONObj& upper ) {
+            const Bucket* b = loc.btree<V>();
+            int n = b->getN();
+            BSONObj childLower = lower;
+            for ( int i = 0; i <= n; i++ ) {
+                DiskLoc child = i < n ? DiskLoc( b->keyNode( i ).prevChildBucket ) : DiskLoc( b->getNextChild() );
+                BSONObj key = i < n ? b->keyNode( i ).key.toBson().getOwned() : BSONObj();
+                BSONObj childUpper = i < n ? key : upper;
+
+                bool beforeMin = ! childUpper.isEmpty() && compare( childUpper , _min ) < 0;
+                bool afterMax = ! childLower.isEmpty() && compare( childLower , _max ) >= 0;
+                if ( afterMax )
+                    return;
+
+                if ( ! child.isNull() && ! beforeMin ) {
+                    if ( height > 1 ) {
+                        _collect( child , height - 1 , childLower , childUpper );
+                    }
+                    else {
+                        Item leaf;
+                        leaf.leaf = child;
+                        leaf.boundary = childLower.isEmpty() || compare( childLower , _min ) < 0 ||
+                                        childUpper.isEmpty() || compare( childUpper , _max ) >= 0;
+                        leaf.count = 0;
+                        _items.push_back( leaf );
+                    }
+                }
+
+                if ( i < n && b->isUsed( i ) && compare( key , _min ) >= 0 && compare( key , _max ) < 0 ) {
+                    Item sep;
+                    sep.boundary = false;
+                    sep.count = 1;
+                    sep.key = key;
+                    _items.push_back( sep );
+                }
+                childLower = childUpper;
+            }
+        }
+
+        /** counts the boundary leaves and a sample of the others, and fills in every leaf count */
+        void _estimateLeaves() {
+            vector<Item*> inner;
+            for ( typename vector<Item>::iterator i = _items.begin(); i != _items.end(); ++i ) {
+                if ( i->leaf.isNull() ) {
+                    _total += i->count;
+                }
+                else if ( i->boundary ) {
+                    i->count = _countInRange( i->leaf );
+                    _total += i->count;
+                }
+                else {
+                    inner.push_back( &*i );
+                }
+            }
+            if ( inner.empty() )
+                return;
+
+            size_t step = max( inner.size() / SampleLeaves , (size_t)1 );
+            double sampled = 0;
+            int samples = 0;
+            for ( size_t i = 0; i < inner.size(); i += step ) {
+                sampled += inner[i]->leaf.template btree<V>()->getN();
+                samples++;
+            }
+            double avg = sampled / samples;
+            for ( size_t i = 0; i < inner.size(); i++ ) {
+                inner[i]->count = avg;
+                _total += avg;
+            }
+        }
+
+        int _countInRange( const DiskLoc& loc ) const {
+            const Bucket* b = loc.btree<V>();
+            int count = 0;
+            for ( int i = 0; i < b->getN(); i++ ) {
+                if ( ! b->isUsed( i ) )
+                    continue;
+                BSONObj key = b->keyNode( i ).key.toBson();
+                if ( compare( key , _min ) >= 0 && compare( key , _max ) < 0 )
+                    count++;
+            }
+            return count;
+        }
+
+        const DiskLoc _head;
+        const Ordering _ordering;
+        const BSONObj _min;
+        const BSONObj _max;
+        vector<Item> _items; // in index order
+        double _total;
+    };
+
+    /**
+     * Fills splitKeys with the estimated split points of [min, max), see SplitPointEstimator.  When
+     * forcing, the range is split at its estimated median.
+     * @return the estimated number of keys in the range, or -1 if the index is too small to estimate
+     */
+    template< class V >
+    static long long estimateSplitKeys( const IndexDetails& idx , const BSONObj& min , const BSONObj& max ,
+                                        bool force , long long keyCount , long long maxSplitPoints ,
+                                        vector<BSONObj>& splitKeys , set<BSONObj>& tooFrequentKeys ) {
+        SplitPointEstimator<V> estimator( idx , min , max );
+        if ( ! estimator.collect() )
+            return -1;
+
+        if ( force ) {
+            keyCount = estimator.total() / 2;
+            maxSplitPoints = 1;
+        }
+        estimator.pick( keyCount , maxSplitPoints , splitKeys , tooFrequentKeys );
+        return estimator.total();
+    }
+
     class SplitVector : public Command {
     public:
         SplitVector() : Command( "splitVector" , false ) {}
@@ -244,6 +446,8 @@ namespace mongo {
                  "  \n"
                  "  { splitVector : \"blog.post\" , keyPattern:{x:1} , min:{x:10} , max:{x:20}, force: true }\n"
                  "  'force' will produce one split point even if data is small; defaults to false\n"
+                 "  'estimate: true' picks approximate split points from the upper levels of the index\n"
+                 "  instead of scanning it, on indexes large enough for that to matter\n"
                  "NOTE: This command may take a while to run";
         }
 
@@ -362,6 +566,41 @@ namespace mongo {
                     keyCount = maxChunkObjects;
                 }
                 
+                if ( jsobj["estimate"].trueValue() ) {
+                    Timer timer;
+                    set<BSONObj> tooFrequentKeys;
+                    long long estimatedKeys = -1;
+                    if ( idx->version() == 0 )
+                        estimatedKeys = estimateSplitKeys<V0>( *idx , min , max , force , keyCount ,
+                                                               maxSplitPoints , splitKeys , tooFrequentKeys );
+                    else if ( idx->version() == 1 )
+                        estimatedKeys = estimateSplitKeys<V1>( *idx , min , max , force , keyCount ,
+                                                               maxSplitPoints , splitKeys , tooFrequentKeys );
+
+                    if ( estimatedKeys >= 0 ) {
+                        for ( set<BSONObj>::const_iterator it = tooFrequentKeys.begin(); it != tooFrequentKeys.end(); ++it ) {
+                            warning() << "chunk is larger than " << maxChunkSize << " bytes because of key "
+                                      << it->replaceFieldNames( idx->keyPattern() ).clientReadable() << endl;
+                        }
+                        for ( vector<BSONObj>::iterator it = splitKeys.begin(); it != splitKeys.end() ; ++it ) {
+                            *it = it->replaceFieldNames( idx->keyPattern() ).clientReadable();
+                        }
+
+                        LOG( timer.millis() > cmdLine.slowMS ? 0 : 1 )
+                            << "estimated the split vector for " << ns << " over " << keyPattern
+                            << " keyCount: " << keyCount << " numSplits: " << splitKeys.size()
+                            << " estimatedKeys: " << estimatedKeys << " took " << timer.millis() << "ms"
+                            << endl;
+
+                        result.append( "splitKeys" , splitKeys );
+                        result.appendBool( "estimated" , true );
+                        return true;
+                    }
+
+                    LOG(1) << "index over " << keyPattern << " is too small to estimate split points for "
+                           << ns << ", scanning it" << endl;
+                }
+
                 //
                 // 2. Traverse the index and add the keyCount-th key to the result vector. If that key
                 //    appeared in the vector before, we omit it. The invariant here is that all the
@@ -29,6 +29,7 @@
 #include "../db/commands.h"
 #include "../db/jsobj.h"
 #include "../db/db.h"
+#include "../db/dbhelpers.h"
 #include "../db/replutil.h"
 #include "../client/connpool.h"
 
@@ -37,6 +38,7 @@
 #include "shard.h"
 #include "d_logic.h"
 #include "config.h"
+#include "balancer_policy.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
 using namespace std;
@@ -47,7 +49,8 @@ namespace mongo {
 
     ShardingState::ShardingState()
         : _enabled(false) , _mutex( "ShardingState" ),
-          _configServerTickets( 3 /* max number of concurrent config server refresh threads */ ) {
+          _configServerTickets( 3 /* max number of concurrent config server refresh threads */ ),
+          _loadMutex( "ShardingState::loads" ) {
     }
 
     void ShardingState::enable( const string& server ) {
@@ -109,6 +112,10 @@ namespace mongo {
         _shardName.clear();
         _shardHost.clear();
         _chunks.clear();
+        _orphans.clear();
+
+        scoped_lock llk( _loadMutex );
+        _loads.clear();
     }
 
     // TODO we shouldn't need three ways for checking the version. Fix this.
@@ -155,7 +162,7 @@ namespace mongo {
         version = ( p->getNumChunks() > 1 ) ? version : ShardChunkVersion( 0 , OID() );
 
         ShardChunkManagerPtr cloned( p->cloneMinus( min , max , version ) );
-        _chunks[ns] = cloned;
+        _setManager( ns , cloned );
     }
 
     void ShardingState::undoDonateChunk( const string& ns , const BSONObj& min , const BSONObj& max , ShardChunkVersion version ) {
@@ -164,7 +171,7 @@ namespace mongo {
         ChunkManagersMap::const_iterator it = _chunks.find( ns );
         verify( it != _chunks.end() ) ;
         ShardChunkManagerPtr p( it->second->clonePlus( min , max , version ) );
-        _chunks[ns] = p;
+        _setManager( ns , p );
     }
 
     void ShardingState::splitChunk( const string& ns , const BSONObj& min , const BSONObj& max , const vector<BSONObj>& splitKeys ,
@@ -174,13 +181,18 @@ namespace mongo {
         ChunkManagersMap::const_iterator it = _chunks.find( ns );
         verify( it != _chunks.end() ) ;
         ShardChunkManagerPtr p( it->second->cloneSplit( min , max , splitKeys , version ) );
-        _chunks[ns] = p;
+        _setManager( ns , p );
     }
 
     void ShardingState::resetVersion( const string& ns ) {
-        scoped_lock lk( _mutex );
+        {
+            scoped_lock lk( _mutex );
+            _chunks.erase( ns );
+            _orphans.erase( ns );
+        }
 
-        _chunks.erase( ns );
+        scoped_lock lk( _loadMutex );
+        _loads.erase( ns );
     }
 
     bool ShardingState::trySetVersion( const string& ns , ConfigVersion& version /* IN-OUT */ ) {
@@ -243,7 +255,7 @@ namespace mongo {
             // make sure we keep the freshest config info only
             ChunkManagersMap::const_iterator it = _chunks.find( ns );
             if ( it == _chunks.end() || p->getVersion() >= it->second->getVersion() ) {
-                _chunks[ns] = p;
+                _setManager( ns , p );
             }
 
             ShardChunkVersion oldVersion = version;
@@ -297,6 +309,193 @@ namespace mongo {
         }
     }
 
+    // folded early past this, well before the byte counter could wrap
+    static const unsigned ChunkLoadFoldBytes = 1u << 30;
+
+    void ShardingState::noteChunkOp( const string& ns , const ShardChunkManager& manager , int chunk ,
+                                     bool write , int bytes ) {
+        ChunkLoadCounters& counters = manager.loadCounters( chunk );
+        if ( write )
+            counters.writes++;
+        else
+            counters.reads++;
+        counters.bytes.signedAdd( bytes );
+
+        if ( counters.bytes.get() > ChunkLoadFoldBytes ) {
+            scoped_lock lk( _loadMutex );
+            _foldChunkLoad( ns , manager );
+        }
+    }
+
+    void ShardingState::_foldChunkLoad( const string& ns , const ShardChunkManager& manager ) {
+        const ShardChunkFilter& filter = manager.filter();
+        ChunkLoadMap* loads = 0;
+        for ( unsigned i = 0; i < filter.numChunks(); i++ ) {
+            ChunkLoadCounters& counters = manager.loadCounters( i );
+            unsigned reads = counters.reads.get();
+            unsigned writes = counters.writes.get();
+            unsigned bytes = counters.bytes.get();
+            if ( reads == 0 && writes == 0 )
+                continue;
+
+            // taken out by subtracting what was read, so concurrent operations are not lost
+            counters.reads.signedAdd( -(int)reads );
+            counters.writes.signedAdd( -(int)writes );
+            counters.bytes.signedAdd( -(int)bytes );
+
+            if ( ! loads )
+                loads = &_loads[ns];
+            ChunkLoad& load = (*loads)[filter.chunkMin( i )];
+            load.reads += reads;
+            load.writes += writes;
+            load.bytes += bytes;
+        }
+    }
+
+    void ShardingState::_setManager( const string& ns , const ShardChunkManagerPtr& manager ) {
+        ChunkManagersMap::iterator it = _chunks.find( ns );
+        if ( it != _chunks.end() ) {
+            // what is counted against the old manager by operations still using it is lost
+            scoped_lock lk( _loadMutex );
+            _foldChunkLoad( ns , *it->second );
+        }
+        _chunks[ns] = manager;
+    }
+
+    static bool hasFields( const BSONObj& obj , const BSONObj& pattern ) {
+        BSONForEach( e , pattern ) {
+            if ( obj.getFieldDotted( e.fieldName() ).eoo() )
+                return false;
+        }
+        return true;
+    }
+
+    void ShardingState::noteChunkWrite( const char* opstr , const char* ns , const BSONObj& obj ) {
+        if ( ! _enabled )
+            return;
+
+        char op = opstr[0];
+        if ( op != 'i' && op != 'u' )
+            return;
+
+        ShardChunkManagerPtr manager = getShardChunkManager( ns );
+        if ( ! manager )
+            return;
+
+        // an insert and a full document update log the document itself, an update with modifiers
+        // logs the modifiers
+        if ( ! hasFields( obj , manager->getKey() ) )
+            return;
+
+        int chunk = manager->filter().find( obj );
+        if ( chunk < 0 ) {
+            noteOrphans( ns );
+            return;
+        }
+
+        noteChunkOp( ns , *manager , chunk , true , obj.objsize() );
+    }
+
+    void ShardingState::noteDocumentWrite( const char* ns , const BSONObj& doc , int bytes ) {
+        if ( ! _enabled )
+            return;
+
+        ShardChunkManagerPtr manager = getShardChunkManager( ns );
+        if ( ! manager )
+            return;
+
+        // changing a stored document doesn't make an orphan, so there is nothing to note otherwise
+        int chunk = manager->filter().find( doc );
+        if ( chunk >= 0 )
+            noteChunkOp( ns , *manager , chunk , true , bytes );
+    }
+
+    void ShardingState::reportChunkLoad( const string& ns , BSONArrayBuilder& b ) {
+        ShardChunkManagerPtr manager = getShardChunkManager( ns );
+
+        scoped_lock lk( _loadMutex );
+        if ( manager )
+            _foldChunkLoad( ns , *manager );
+
+        map<string,ChunkLoadMap>::iterator i = _loads.find( ns );
+        if ( i == _loads.end() )
+            return;
+
+        ChunkLoadMap& loads = i->second;
+        for ( ChunkLoadMap::iterator it = loads.begin(); it != loads.end(); ) {
+            ChunkLoad& load = it->second;
+            b.append( BSON( "min" << it->first <<
+                            ChunkLoadFields::reads( load.reads ) <<
+                            ChunkLoadFields::writes( load.writes ) <<
+                            ChunkLoadFields::bytes( load.bytes ) ) );
+
+            load.reads /= 2;
+            load.writes /= 2;
+            load.bytes /= 2;
+            if ( load.reads == 0 && load.writes == 0 )
+                loads.erase( it++ );
+            else
+                ++it;
+        }
+
+        if ( loads.empty() )
+            _loads.erase( i );
+    }
+
+    bool ShardingState::holdsOrphans( const string& ns , const ShardChunkManagerPtr& manager ) {
+        verify( manager );
+        {
+            scoped_lock lk( _mutex );
+            map<string,OrphanVerdict>::const_iterator i = _orphans.find( ns );
+            if ( i != _orphans.end() && i->second.manager == manager )
+                return i->second.orphans;
+
+            // an older manager, kept by a cursor from before a migration or split, is not worth
+            // looking for orphans for
+            ChunkManagersMap::const_iterator it = _chunks.find( ns );
+            if ( it == _chunks.end() || it->second != manager )
+                return true;
+        }
+
+        vector< pair<BSONObj,BSONObj> > gaps;
+        manager->getGaps( &gaps );
+
+        bool orphans = false;
+        for ( unsigned i = 0; i < gaps.size() && ! orphans; i++ ) {
+            bool maxInclusive = gaps[i].second.firstElement().type() == MaxKey;
+            orphans = Helpers::hasKeysInRange( ns , gaps[i].first , gaps[i].second , maxInclusive );
+        }
+        LOG(1) << ns << ( orphans ? " holds" : " holds no" ) << " orphans in " << gaps.size()
+               << " gaps between its chunks at " << manager->getVersion().toString() << endl;
+
+        scoped_lock lk( _mutex );
+        OrphanVerdict& v = _orphans[ns];
+        if ( v.manager != manager ) {
+            v.manager = manager;
+            v.orphans = orphans;
+        }
+        return v.orphans;
+    }
+
+    void ShardingState::noteOrphans( const string& ns ) {
+        {
+            scoped_lock lk( _mutex );
+            ChunkManagersMap::const_iterator it = _chunks.find( ns );
+            if ( it == _chunks.end() )
+                return;
+
+            OrphanVerdict& v = _orphans[ns];
+            v.manager = it->second;
+            v.orphans = true;
+        }
+        _orphanEpoch++;
+    }
+
+    void ShardingState::noteRangeDeleted( const string& ns ) {
+        scoped_lock lk( _mutex );
+        _orphans.erase( ns );
+    }
+
     ShardingState shardingState;
 
     // -----ShardingState END ----
@@ -703,6 +902,32 @@ namespace mongo {
 
     } getShardVersion;
 
+    class GetChunkLoad : public MongodShardCommand {
+    public:
+        GetChunkLoad() : MongodShardCommand( "getChunkLoad" ) {}
+
+        virtual void help( stringstream& help ) const {
+            help << "per chunk operation counts for the balancer, halved on every call\n"
+                 << " example: { getChunkLoad : 'alleyinsider.foo' } ";
+        }
+
+        virtual LockType locktype() const { return NONE; }
+
+        bool run(const string& , BSONObj& cmdObj, int, string& errmsg, BSONObjBuilder& result, bool) {
+            string ns = cmdObj["getChunkLoad"].valuestrsafe();
+            if ( ns.size() == 0 ) {
+                errmsg = "need to specify full namespace";
+                return false;
+            }
+
+            BSONArrayBuilder b( result.subarrayStart( "chunks" ) );
+            shardingState.reportChunkLoad( ns , b );
+            b.done();
+            return true;
+        }
+
+    } getChunkLoad;
+
     class ShardingStateCmd : public MongodShardCommand {
     public:
         ShardingStateCmd() : MongodShardCommand( "shardingState" ) {}
@@ -0,0 +1,330 @@
+// @file multiplexed_connection.cpp
+
+/**
+*    Copyright (C) 2012 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pch.h"
+
+#include "mongo/s/multiplexed_connection.h"
+
+#include "mongo/client/dbclient_rs.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/s/shard.h"
+#include "mongo/s/util.h"
+
+namespace mongo {
+
+    MultiplexedConnectionPool multiplexedConnectionPool;
+
+    static MessagingPort* masterPort( DBClientBase* conn ) {
+        switch ( conn->type() ) {
+        case ConnectionString::MASTER:
+            return &((DBClientConnection*)conn)->port();
+        case ConnectionString::SET:
+            return &((DBClientReplicaSet*)conn)->masterConn().port();
+        default:
+            uasserted( 16328 , str::stream() << "can't multiplex a connection to " << conn->toString() );
+        }
+        return 0;
+    }
+
+    MultiplexedConnection::MultiplexedConnection( const string& host , DBClientBase* conn )
+        : _host( host ) , _conn( conn ) , _port( 0 ) ,
+          _sendMutex( "MultiplexedConnection::send" ) , _mutex( "MultiplexedConnection" ) ,
+          _reading( false ) , _failed( false ) , _pending( 0 ) {
+        try {
+            _port = masterPort( conn );
+        }
+        catch ( std::exception& ) {
+            delete conn;
+            throw;
+        }
+    }
+
+    MultiplexedConnection::~MultiplexedConnection() {
+        for ( map<unsigned,Message*>::iterator i = _replies.begin(); i != _replies.end(); ++i )
+            delete i->second;
+
+        // never returned to the pool, as replies to abandoned requests may still be on the way
+        if ( versionManager.isVersionableCB( _conn ) )
+            versionManager.resetShardVersionCB( _conn );
+        delete _conn;
+    }
+
+    bool MultiplexedConnection::say( Message& toSend , bool expectReply ) {
+        scoped_lock sl( _sendMutex );
+        {
+            scoped_lock lk( _mutex );
+            if ( _failed )
+                return false;
+            // counted before the send so the reply can't be read first
+            if ( expectReply )
+                _pending++;
+        }
+
+        try {
+            _port->say( toSend );
+            return true;
+        }
+        catch ( SocketException& e ) {
+            log() << "multiplexed connection to " << _host << " failed sending" << causedBy( e ) << endl;
+        }
+
+        scoped_lock lk( _mutex );
+        if ( expectReply )
+            _pending--;
+        _failed = true;
+        _replied.notify_all();
+        return false;
+    }
+
+    bool MultiplexedConnection::recv( unsigned id , Message& response ) {
+        while ( true ) {
+            {
+                scoped_lock lk( _mutex );
+                while ( true ) {
+                    map<unsigned,Message*>::iterator i = _replies.find( id );
+                    if ( i != _replies.end() ) {
+                        auto_ptr<Message> m( i->second );
+                        _replies.erase( i );
+                        response = *m;
+                        return true;
+                    }
+                    if ( _failed )
+                        return false;
+                    if ( ! _reading )
+                        break;
+                    _replied.wait( lk.boost() );
+                }
+                _reading = true;
+            }
+            _readOne();
+        }
+    }
+
+    void MultiplexedConnection::_readOne() {
+        auto_ptr<Message> m( new Message() );
+        bool ok = false;
+        try {
+            ok = _port->recv( *m );
+        }
+        catch ( SocketException& e ) {
+            log() << "multiplexed connection to " << _host << " failed receiving" << causedBy( e ) << endl;
+        }
+
+        scoped_lock lk( _mutex );
+        _reading = false;
+        if ( ! ok ) {
+            _failed = true;
+        }
+        else {
+            _pending--;
+            unsigned to = m->header()->responseTo;
+            if ( _abandoned.erase( to ) == 0 ) {
+                verify( _replies.count( to ) == 0 );
+                _replies[to] = m.release();
+            }
+        }
+        _replied.notify_all();
+    }
+
+    void MultiplexedConnection::abandon( unsigned id ) {
+        scoped_lock lk( _mutex );
+        map<unsigned,Message*>::iterator i = _replies.find( id );
+        if ( i != _replies.end() ) {
+            delete i->second;
+            _replies.erase( i );
+            return;
+        }
+        if ( ! _failed )
+            _abandoned.insert( id );
+    }
+
+    void MultiplexedConnection::fail() {
+        scoped_lock lk( _mutex );
+        _failed = true;
+        _replied.notify_all();
+    }
+
+    bool MultiplexedConnection::isFailed() const {
+        scoped_lock lk( _mutex );
+        return _failed;
+    }
+
+    int MultiplexedConnection::pending() const {
+        scoped_lock lk( _mutex );
+        return _pending;
+    }
+
+    // ---- MultiplexedChannel -----
+
+    MultiplexedChannel::MultiplexedChannel( const MultiplexedConnectionPtr& conn )
+        : _conn( conn ) {
+    }
+
+    MultiplexedChannel::~MultiplexedChannel() {
+        abandonPending();
+    }
+
+    void MultiplexedChannel::abandonPending() {
+        for ( std::deque<unsigned>::iterator i = _lazy.begin(); i != _lazy.end(); ++i )
+            _conn->abandon( *i );
+        _lazy.clear();
+    }
+
+    bool MultiplexedChannel::call( Message& toSend , Message& response , bool assertOk , string* actualServer ) {
+        if ( ! _conn->say( toSend , true ) || ! _conn->recv( toSend.header()->id , response ) ) {
+            if ( assertOk )
+                uasserted( 10278 , str::stream() << "dbclient error communicating with server: " << getServerAddress() );
+            return false;
+        }
+        if ( actualServer )
+            *actualServer = getServerAddress();
+        return true;
+    }
+
+    void MultiplexedChannel::say( Message& toSend , bool isRetry , string* actualServer ) {
+        int op = toSend.operation();
+        // writes would break getLastError for every other channel of the socket
+        massert( 16329 , "multiplexed shard connections only carry queries" ,
+                 op == dbQuery || op == dbGetMore || op == dbKillCursors );
+        if ( op == dbQuery ) {
+            // an awaitData getMore would hold up every other channel's replies, and an exhaust
+            // query gets many replies to one request
+            DbMessage d( toSend );
+            QueryMessage q( d );
+            massert( 16331 , "multiplexed shard connections don't carry tailable or exhaust queries" ,
+                     ! ( q.queryOptions & ( QueryOption_CursorTailable | QueryOption_AwaitData | QueryOption_Exhaust ) ) );
+        }
+
+        bool expectReply = op != dbKillCursors;
+        if ( ! _conn->say( toSend , expectReply ) )
+            throw SocketException( SocketException::SEND_ERROR , getServerAddress() );
+        if ( expectReply )
+            _lazy.push_back( toSend.header()->id );
+        if ( actualServer )
+            *actualServer = getServerAddress();
+    }
+
+    bool MultiplexedChannel::recv( Message& m ) {
+        verify( ! _lazy.empty() );
+        unsigned id = _lazy.front();
+        _lazy.pop_front();
+        return _conn->recv( id , m );
+    }
+
+    bool MultiplexedChannel::recvReply( Message& m , MSGID requestId ) {
+        std::deque<unsigned>::iterator i = find( _lazy.begin() , _lazy.end() , (unsigned)requestId );
+        if ( i != _lazy.end() )
+            _lazy.erase( i );
+        return _conn->recv( requestId , m );
+    }
+
+    void MultiplexedChannel::checkResponse( const char* data , int nReturned , bool* retry , string* host ) {
+        if ( retry )
+            *retry = false;
+        if ( host )
+            *host = getServerAddress();
+
+        if ( nReturned ) {
+            verify( data );
+            BSONObj o( data );
+            if ( isNotMasterErrorString( getErrField( o ) ) ) {
+                // the pool will connect to the new primary
+                _conn->fail();
+            }
+        }
+    }
+
+    void MultiplexedChannel::killCursor( long long cursorId ) {
+        StackBufBuilder b;
+        b.appendNum( (int)0 ); // reserved
+        b.appendNum( (int)1 ); // number
+        b.appendNum( cursorId );
+
+        Message m;
+        m.setData( dbKillCursors , b.buf() , b.len() );
+        say( m );
+    }
+
+    // ---- MultiplexedConnectionPool -----
+
+    MultiplexedConnectionPtr MultiplexedConnectionPool::_leastLoaded( const string& host ) {
+        vector<MultiplexedConnectionPtr>& conns = _hosts[host];
+        for ( unsigned i = 0; i < conns.size(); ) {
+            if ( conns[i]->isFailed() ) {
+                conns.erase( conns.begin() + i );
+                continue;
+            }
+            i++;
+        }
+
+        MultiplexedConnectionPtr best;
+        if ( (int)conns.size() < _perHost )
+            return best;
+
+        int bestPending = 0;
+        for ( unsigned i = 0; i < conns.size(); i++ ) {
+            int p = conns[i]->pending();
+            if ( ! best || p < bestPending ) {
+                best = conns[i];
+                bestPending = p;
+            }
+        }
+        return best;
+    }
+
+    MultiplexedConnectionPtr MultiplexedConnectionPool::get( const string& host ) {
+        {
+            scoped_lock lk( _mutex );
+            MultiplexedConnectionPtr best = _leastLoaded( host );
+            if ( best )
+                return best;
+        }
+
+        // connecting can be slow, so not under the lock
+        MultiplexedConnectionPtr c( new MultiplexedConnection( host , shardConnectionPool.get( host ) ) );
+
+        scoped_lock lk( _mutex );
+        // other threads may have filled the host up while we connected; ours is then closed
+        MultiplexedConnectionPtr best = _leastLoaded( host );
+        if ( best )
+            return best;
+
+        LOG(1) << "new multiplexed connection to " << host << endl;
+        _hosts[host].push_back( c );
+        return c;
+    }
+
+    void MultiplexedConnectionPool::appendInfo( BSONObjBuilder& b ) {
+        b.append( "connectionsPerHost" , _perHost );
+
+        BSONObjBuilder bb( b.subobjStart( "hosts" ) );
+        scoped_lock lk( _mutex );
+        for ( HostMap::iterator i = _hosts.begin(); i != _hosts.end(); ++i ) {
+            int pending = 0;
+            for ( unsigned j = 0; j < i->second.size(); j++ )
+                pending += i->second[j]->pending();
+
+            BSONObjBuilder temp( bb.subobjStart( i->first ) );
+            temp.append( "connections" , (int)i->second.size() );
+            temp.append( "pending" , pending );
+            temp.done();
+        }
+        bb.done();
+    }
+
+}
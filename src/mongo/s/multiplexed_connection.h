@@ -0,0 +1,169 @@
+// @file multiplexed_connection.h - shard connections shared by the queries of many clients
+
+/**
+*    Copyright (C) 2012 10gen Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "../pch.h"
+
+#include "../client/connpool.h"
+#include "../util/concurrency/mutex.h"
+
+namespace mongo {
+
+    /**
+     * One socket to a shard that many client threads send their queries over at once.
+     *
+     * Requests are written whole under a send mutex, so they never interleave.  The server
+     * answers the requests of a socket in order, and every reply carries the id of the request
+     * it answers in responseTo, so replies are matched to their waiters by that id.  There is no
+     * reader thread: the first waiter to find nobody reading reads replies until its own has
+     * arrived, handing the others to their waiters as it goes.
+     *
+     * Only operations the server answers (queries and getMores) may be sent with expectReply;
+     * the others (killCursors) are sent without it.  Writes are never sent this way, because
+     * getLastError reports on the last write of the whole socket.
+     *
+     * Once a send or receive fails, or a reply says the server is no longer primary, the
+     * connection is failed: every waiter returns false and the pool replaces it.
+     */
+    class MultiplexedConnection : boost::noncopyable {
+    public:
+        /** @param conn a connection from shardConnectionPool, which this takes ownership of */
+        MultiplexedConnection( const string& host , DBClientBase* conn );
+        ~MultiplexedConnection();
+
+        /**
+         * Sends toSend, setting its request id.
+         * @return false if the connection has failed
+         */
+        bool say( Message& toSend , bool expectReply );
+
+        /**
+         * Waits for the reply to request id.
+         * @return false if the connection failed before the reply arrived
+         */
+        bool recv( unsigned id , Message& response );
+
+        /** the reply to request id will not be waited for, and is dropped when it arrives */
+        void abandon( unsigned id );
+
+        void fail();
+
+        bool isFailed() const;
+
+        /** @return the number of requests whose replies have not been read yet */
+        int pending() const;
+
+        const string& getServerAddress() const { return _host; }
+        double getSoTimeout() const { return _conn->getSoTimeout(); }
+
+    private:
+        /** reads one reply, called by the waiter that took the reading role */
+        void _readOne();
+
+        const string _host;
+        DBClientBase* _conn;
+        MessagingPort* _port;
+
+        mongo::mutex _sendMutex;
+
+        mutable mongo::mutex _mutex;
+        boost::condition _replied;
+        bool _reading;
+        bool _failed;
+        int _pending;
+        map<unsigned,Message*> _replies; // read and not yet taken
+        set<unsigned> _abandoned;
+    };
+
+    typedef shared_ptr<MultiplexedConnection> MultiplexedConnectionPtr;
+
+    /**
+     * What a client thread sees of a MultiplexedConnection: a DBClientBase for the queries of one
+     * thread, so it is not thread safe.  It keeps the ids of requests sent with say() in order
+     * for recv(), and recvReply() takes any of them, so lazy queries and prefetched getMores
+     * work.
+     *
+     * mongod keeps shard versions per socket, while they are tracked per channel here, so
+     * channels only carry queries of unsharded collections (see ShardConnection).  Their version
+     * is always 0, whichever channel set it, and a query of a collection that has since been
+     * sharded gets a stale config error and comes back with a chunk manager.
+     */
+    class MultiplexedChannel : public DBClientBase {
+    public:
+        MultiplexedChannel( const MultiplexedConnectionPtr& conn );
+        virtual ~MultiplexedChannel();
+
+        /** drops the replies of lazy requests that will not be read */
+        void abandonPending();
+
+        virtual bool call( Message& toSend , Message& response , bool assertOk = true , string* actualServer = 0 );
+        virtual void say( Message& toSend , bool isRetry = false , string* actualServer = 0 );
+        virtual void sayPiggyBack( Message& toSend ) { say( toSend ); }
+        virtual bool recv( Message& m );
+        virtual bool recvReply( Message& m , MSGID requestId );
+        virtual void checkResponse( const char* data , int nReturned , bool* retry = NULL , string* host = NULL );
+        virtual bool lazySupported() const { return true; }
+
+        virtual bool callRead( Message& toSend , Message& response ) { return call( toSend , response ); }
+        virtual void killCursor( long long cursorID );
+
+        virtual string toString() { return _conn->getServerAddress() + " (multiplexed)"; }
+        virtual string getServerAddress() const { return _conn->getServerAddress(); }
+        virtual bool isFailed() const { return _conn->isFailed(); }
+        virtual ConnectionString::ConnectionType type() const { return ConnectionString::MASTER; }
+        virtual double getSoTimeout() const { return _conn->getSoTimeout(); }
+
+    private:
+        MultiplexedConnectionPtr _conn;
+        std::deque<unsigned> _lazy;
+    };
+
+    /**
+     * Up to a fixed number of MultiplexedConnections per shard, handed to the client threads
+     * with the fewest requests outstanding.  Disabled while the number is 0.
+     */
+    class MultiplexedConnectionPool : boost::noncopyable {
+    public:
+        MultiplexedConnectionPool() : _mutex( "MultiplexedConnectionPool" ) , _perHost(0) {}
+
+        void setConnectionsPerHost( int n ) { _perHost = n; }
+        int getConnectionsPerHost() const { return _perHost; }
+        bool enabled() const { return _perHost > 0; }
+
+        MultiplexedConnectionPtr get( const string& host );
+
+        void appendInfo( BSONObjBuilder& b );
+
+    private:
+        /**
+         * drops the failed connections to host, must be called under _mutex
+         * @return the one with the fewest requests outstanding, or none if host may have another
+         */
+        MultiplexedConnectionPtr _leastLoaded( const string& host );
+
+        typedef map<string,vector<MultiplexedConnectionPtr>,DBConnectionPool::serverNameCompare> HostMap;
+
+        mongo::mutex _mutex;
+        int _perHost;
+        HostMap _hosts;
+    };
+
+    extern MultiplexedConnectionPool multiplexedConnectionPool;
+
+}
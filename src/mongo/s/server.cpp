@@ -41,6 +41,7 @@
 #include "balance.h"
 #include "grid.h"
 #include "cursors.h"
+#include "multiplexed_connection.h"
 #include "shard_version.h"
 #include "../util/processinfo.h"
 #include "mongo/util/util.h"
@@ -325,6 +326,11 @@ int _main(int argc, char* argv[]) {
     ( "test" , "just run unit tests" )
     ( "upgrade" , "upgrade meta data version" )
     ( "chunkSize" , po::value<int>(), "maximum amount of data per chunk" )
+    ( "queryConnectionsPerShard" , po::value<int>(), "share this many connections to each shard between "
+                                                    "the plain queries of all clients to unsharded collections; "
+                                                    "queries of sharded collections, slaveOk, tailable and "
+                                                    "exhaust queries, commands and writes keep a connection "
+                                                    "per client (default 0, one per client)" )
     ( "ipv6", "enable IPv6 support (disabled by default)" )
     ( "jsonp","allow JSONP access via http (has security implications)" )
     ( "noscripting", "disable scripting engine" )
@@ -367,6 +373,15 @@ int _main(int argc, char* argv[]) {
         Chunk::MaxChunkSize = csize * 1024 * 1024;
     }
 
+    if ( params.count( "queryConnectionsPerShard" ) ) {
+        int n = params["queryConnectionsPerShard"].as<int>();
+        if ( n < 0 ) {
+            out() << "error: queryConnectionsPerShard can't be negative" << endl;
+            return 11;
+        }
+        multiplexedConnectionPool.setConnectionsPerHost( n );
+    }
+
     if ( params.count( "localThreshold" ) ) {
         cmdLine.defaultLocalThresholdMillis = params["localThreshold"].as<int>();
     }
@@ -216,9 +216,14 @@ namespace mongo {
 
     class ShardConnection : public AScopedConnection {
     public:
-        ShardConnection( const Shard * s , const string& ns, ChunkManagerPtr manager = ChunkManagerPtr() );
-        ShardConnection( const Shard& s , const string& ns, ChunkManagerPtr manager = ChunkManagerPtr() );
-        ShardConnection( const string& addr , const string& ns, ChunkManagerPtr manager = ChunkManagerPtr() );
+        /**
+         * @param queryOnly the connection will only be used for queries, getMores and killCursors,
+         *        none of them tailable or exhaust, so without a manager it may share a socket with
+         *        other clients' queries (see multiplexedConnectionPool)
+         */
+        ShardConnection( const Shard * s , const string& ns, ChunkManagerPtr manager = ChunkManagerPtr() , bool queryOnly = false );
+        ShardConnection( const Shard& s , const string& ns, ChunkManagerPtr manager = ChunkManagerPtr() , bool queryOnly = false );
+        ShardConnection( const string& addr , const string& ns, ChunkManagerPtr manager = ChunkManagerPtr() , bool queryOnly = false );
 
         ~ShardConnection();
 
@@ -278,10 +283,11 @@ namespace mongo {
         static void checkMyConnectionVersions( const string & ns );
 
     private:
-        void _init();
+        void _init( bool queryOnly );
         void _finishInit();
 
         bool _finishedInit;
+        bool _multiplexed;
 
         string _addr;
         string _ns;
@@ -20,6 +20,7 @@
 #include "shard.h"
 #include "config.h"
 #include "request.h"
+#include "multiplexed_connection.h"
 #include <set>
 
 namespace mongo {
@@ -61,6 +62,12 @@ namespace mongo {
                 delete ss;
             }
             _hosts.clear();
+
+            for ( ChannelMap::iterator i=_channels.begin(); i!=_channels.end(); ++i ) {
+                versionManager.resetShardVersionCB( i->second );
+                delete i->second;
+            }
+            _channels.clear();
         }
 
         DBClientBase * get( const string& addr , const string& ns ) {
@@ -87,6 +94,24 @@ namespace mongo {
             return shardConnectionPool.get( addr );
         }
 
+        /**
+         * @return this thread's channel to addr, which stays owned by ClientConnections.
+         * A channel whose socket failed is replaced, along with the shard versions set through it.
+         */
+        DBClientBase * getMultiplexed( const string& addr , const string& ns ) {
+            _check( ns );
+
+            MultiplexedChannel* &c = _channels[addr];
+            if ( c && c->isFailed() ) {
+                versionManager.resetShardVersionCB( c );
+                delete c;
+                c = 0;
+            }
+            if ( ! c )
+                c = new MultiplexedChannel( multiplexedConnectionPool.get( addr ) );
+            return c;
+        }
+
         void done( const string& addr , DBClientBase* conn ) {
             Status* s = _hosts[addr];
             verify( s );
@@ -143,6 +168,8 @@ namespace mongo {
         
         typedef map<string,Status*,DBConnectionPool::serverNameCompare> HostMap;
         HostMap _hosts;
+        typedef map<string,MultiplexedChannel*,DBConnectionPool::serverNameCompare> ChannelMap;
+        ChannelMap _channels;
         set<string> _seenNS;
         // -----
 
@@ -160,24 +187,30 @@ namespace mongo {
 
     thread_specific_ptr<ClientConnections> ClientConnections::_perThread;
 
-    ShardConnection::ShardConnection( const Shard * s , const string& ns, ChunkManagerPtr manager )
+    ShardConnection::ShardConnection( const Shard * s , const string& ns, ChunkManagerPtr manager, bool queryOnly )
         : _addr( s->getConnString() ) , _ns( ns ), _manager( manager ) {
-        _init();
+        _init( queryOnly );
     }
 
-    ShardConnection::ShardConnection( const Shard& s , const string& ns, ChunkManagerPtr manager )
+    ShardConnection::ShardConnection( const Shard& s , const string& ns, ChunkManagerPtr manager, bool queryOnly )
         : _addr( s.getConnString() ) , _ns( ns ), _manager( manager ) {
-        _init();
+        _init( queryOnly );
     }
 
-    ShardConnection::ShardConnection( const string& addr , const string& ns, ChunkManagerPtr manager )
+    ShardConnection::ShardConnection( const string& addr , const string& ns, ChunkManagerPtr manager, bool queryOnly )
         : _addr( addr ) , _ns( ns ), _manager( manager ) {
-        _init();
+        _init( queryOnly );
     }
 
-    void ShardConnection::_init() {
+    void ShardConnection::_init( bool queryOnly ) {
         verify( _addr.size() );
-        _conn = ClientConnections::threadInstance()->get( _addr , _ns );
+        // mongod keeps shard versions per socket, so one versioned collection would make every
+        // channel of the socket run under whichever chunk manager set its version last
+        _multiplexed = queryOnly && ! _manager && multiplexedConnectionPool.enabled();
+        if ( _multiplexed )
+            _conn = ClientConnections::threadInstance()->getMultiplexed( _addr , _ns );
+        else
+            _conn = ClientConnections::threadInstance()->get( _addr , _ns );
         _finishedInit = false;
     }
 
@@ -201,13 +234,21 @@ namespace mongo {
 
     void ShardConnection::done() {
         if ( _conn ) {
-            ClientConnections::threadInstance()->done( _addr , _conn );
+            if ( _multiplexed )
+                static_cast<MultiplexedChannel*>( _conn )->abandonPending();
+            else
+                ClientConnections::threadInstance()->done( _addr , _conn );
             _conn = 0;
             _finishedInit = true;
         }
     }
 
     void ShardConnection::kill() {
+        if ( _multiplexed ) {
+            // the channel belongs to the thread, and is replaced if its socket failed
+            done();
+            return;
+        }
         if ( _conn ) {
             if( versionManager.isVersionableCB( _conn ) ) versionManager.resetShardVersionCB( _conn );
             delete _conn;
@@ -238,7 +279,7 @@ namespace mongo {
 
     ShardConnection::~ShardConnection() {
         if ( _conn ) {
-            if ( ! _conn->isFailed() ) {
+            if ( ! _multiplexed && ! _conn->isFailed() ) {
                 /* see done() comments above for why we log this line */
                 log() << "sharded connection to " << _conn->getServerAddress() << " not being returned to the pool" << endl;
             }
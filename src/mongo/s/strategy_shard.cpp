@@ -228,20 +228,25 @@ namespace mongo {
 
             while( ! insertsForChunks.empty() ){
 
-                ChunkPtr c = insertsForChunks.begin()->first;
-                vector<BSONObj>& objs = insertsForChunks.begin()->second;
-
-                const Shard& shard = c->getShard();
+                // Send all the chunks living on one shard as a single message, so a bulk insert
+                // costs one round of version checking and one send per shard rather than per chunk
+                const Shard shard = insertsForChunks.begin()->first->getShard();
                 const string& ns = r.getns();
 
+                vector<ChunkPtr> chunks;
+                vector<BSONObj> objs;
+                for( map<ChunkPtr, vector<BSONObj> >::iterator i = insertsForChunks.begin(); i != insertsForChunks.end(); ++i ){
+                    if( i->first->getShard() != shard )
+                        continue;
+                    chunks.push_back( i->first );
+                    objs.insert( objs.end(), i->second.begin(), i->second.end() );
+                }
+
                 ShardConnection dbcon( shard, ns, manager );
 
                 try {
 
-                    LOG(4) << "  server:" << c->getShard().toString() << " bulk insert " << objs.size() << " documents" << endl;
-
-                    // Taken from single-shard bulk insert, should not need multiple methods in future
-                    // insert( c->getShard() , r.getns() , objs , flags);
+                    LOG(4) << "  server:" << shard.toString() << " bulk insert " << objs.size() << " documents to " << chunks.size() << " chunks" << endl;
 
                     // It's okay if the version is set here, an exception will be thrown if the version is incompatible
                     dbcon.setVersion();
@@ -251,16 +256,18 @@ namespace mongo {
 
                     dbcon.done();
 
-                    int bytesWritten = 0;
-                    for (vector<BSONObj>::iterator vecIt = objs.begin(); vecIt != objs.end(); ++vecIt) {
-                        r.gotInsert(); // Record the correct number of individual inserts
-                        bytesWritten += (*vecIt).objsize();
-                    }
+                    for( vector<ChunkPtr>::iterator c = chunks.begin(); c != chunks.end(); ++c ){
+                        vector<BSONObj>& chunkObjs = insertsForChunks[ *c ];
+
+                        int bytesWritten = 0;
+                        for (vector<BSONObj>::iterator vecIt = chunkObjs.begin(); vecIt != chunkObjs.end(); ++vecIt) {
+                            r.gotInsert(); // Record the correct number of individual inserts
+                            bytesWritten += (*vecIt).objsize();
+                        }
 
-                    // TODO: The only reason we're grouping by chunks here is for auto-split, more efficient
-                    // to track this separately and bulk insert to shards
-                    if ( r.getClientInfo()->autoSplitOk() )
-                        c->splitIfShould( bytesWritten );
+                        if ( r.getClientInfo()->autoSplitOk() )
+                            (*c)->splitIfShould( bytesWritten );
+                    }
 
                 }
                 catch ( StaleConfigException& e ) {
@@ -270,7 +277,7 @@ namespace mongo {
                     // Assume the inserts did *not* succeed, so we don't want to erase them
 
                     int logLevel = retries < 2;
-                    LOG( logLevel ) << "retrying bulk insert of " << objs.size() << " documents to chunk " << c << " because of StaleConfigException: " << e << endl;
+                    LOG( logLevel ) << "retrying bulk insert of " << objs.size() << " documents to shard " << shard << " because of StaleConfigException: " << e << endl;
 
                     if( retries > 2 ){
                         versionManager.forceRemoteCheckShardVersionCB( e.getns() );
@@ -295,15 +302,18 @@ namespace mongo {
                     dbcon.kill();
 
                     // These inserts won't be retried, as something weird happened here
-                    insertsForChunks.erase( insertsForChunks.begin() );
+                    for( vector<ChunkPtr>::iterator c = chunks.begin(); c != chunks.end(); ++c )
+                        insertsForChunks.erase( *c );
 
-                    // Throw if this is the last chunk bulk-inserted to
+                    // Throw if this is the last shard bulk-inserted to
                     if( insertsForChunks.empty() ){
                         throw;
                     }
+                    continue;
                 }
 
-                insertsForChunks.erase( insertsForChunks.begin() );
+                for( vector<ChunkPtr>::iterator c = chunks.begin(); c != chunks.end(); ++c )
+                    insertsForChunks.erase( *c );
             }
         }
 
@@ -48,12 +48,15 @@ public:
     bool _restoreOptions;
     bool _restoreIndexes;
     int _w;
+    unsigned _batchSize;
+    vector<BSONObj> _batch; // documents buffered for the next bulk insert into _curns
+    int _batchBytes;
     string _curns;
     string _curdb;
     string _curcoll;
     set<string> _users; // For restoring users with --drop
     auto_ptr<Matcher> _opmatcher; // For oplog replay
-    Restore() : BSONTool( "restore" ) , _drop(false) {
+    Restore() : BSONTool( "restore" ) , _drop(false) , _batchBytes(0) {
         add_options()
         ("drop" , "drop each collection before import" )
         ("oplogReplay", "replay oplog for point-in-time restore")
@@ -62,6 +65,7 @@ public:
         ("noOptionsRestore" , "don't restore collection options")
         ("noIndexRestore" , "don't restore indexes")
         ("w" , po::value<int>()->default_value(1) , "minimum number of replicas per write" )
+        ("batchSize" , po::value<int>()->default_value(1000) , "max number of documents per insert message" )
         ;
         add_hidden_options()
         ("dir", po::value<string>()->default_value("dump"), "directory to restore from")
@@ -99,6 +103,7 @@ public:
         _restoreOptions = !hasParam("noOptionRestore");
         _restoreIndexes = !hasParam("noIndexRestore");
         _w = getParam( "w" , 1 );
+        _batchSize = max( getParam( "batchSize" , 1000 ) , 1 );
 
         bool doOplog = hasParam( "oplogReplay" );
 
@@ -317,6 +322,7 @@ public:
         }
 
         processFile( root );
+        flushBatch();
         if (_drop && root.leaf() == "system.users.bson") {
             // Delete any users that used to exist but weren't in the dump file
             for (set<string>::iterator it = _users.begin(); it != _users.end(); ++it) {
@@ -366,17 +372,36 @@ public:
             conn().update(_curns, Query(userMatch), obj);
             _users.erase(obj["user"].String());
         } else {
-            conn().insert( _curns , obj );
-
-            // wait for insert to propagate to "w" nodes (doesn't warn if w used without replset)
-            if ( _w > 1 ) {
-                conn().getLastErrorDetailed(false, false, _w);
-            }
+            _batch.push_back( obj.getOwned() );
+            _batchBytes += obj.objsize();
+            if ( _batch.size() >= _batchSize || _batchBytes >= BatchBytesLimit )
+                flushBatch();
         }
     }
 
 private:
 
+    // keeps each bulk insert message well under MaxMessageSizeBytes even with one max size document
+    static const int BatchBytesLimit = 8 * 1024 * 1024;
+
+    /** sends the buffered documents as one insert message.  each document is still independent:
+        ContinueOnError keeps a duplicate key from dropping the rest of the batch.
+    */
+    void flushBatch() {
+        if ( _batch.empty() )
+            return;
+
+        conn().insert( _curns , _batch , InsertOption_ContinueOnError );
+
+        // wait for inserts to propagate to "w" nodes (doesn't warn if w used without replset)
+        if ( _w > 1 ) {
+            conn().getLastErrorDetailed(false, false, _w);
+        }
+
+        _batch.clear();
+        _batchBytes = 0;
+    }
+
     BSONObj parseMetadataFile(string filePath) {
         long long fileSize = boost::filesystem::file_size(filePath);
         ifstream file(filePath.c_str(), ios_base::in);
@@ -0,0 +1,313 @@
+// persistent_map.h
+
+/*    Copyright 2012 10gen Inc.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+namespace mongo {
+
+    /**
+     * An ordered map whose copies share structure.
+     *
+     * The map is an AVL tree of immutable nodes.  Insert and erase copy only the O(log n) nodes on
+     * the path to the change and share every other subtree with the map they started from, so
+     * copying a map is O(1) and a modified copy costs O(log n) extra memory per change.
+     *
+     * The interface is the subset of std::map needed for ordered range lookups.  Entries can't be
+     * modified in place, so there are only const iterators; use set() to replace a value.
+     * Iterators are invalidated by any modification of the map object they came from, but copies
+     * of the map are unaffected.  As with std::map, a map object must not be modified while
+     * another thread reads it, while distinct copies may be used freely from different threads.
+     */
+    template< class K, class V, class Cmp = std::less<K> >
+    class PersistentMap {
+        struct Node;
+        typedef boost::shared_ptr<const Node> NodePtr;
+
+        struct Node {
+            Node( const std::pair<const K,V>& v, const NodePtr& l, const NodePtr& r, int h )
+                : value( v ), left( l ), right( r ), height( h ) {
+            }
+            const std::pair<const K,V> value;
+            const NodePtr left;
+            const NodePtr right;
+            const int height;
+        };
+
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef std::pair<const K,V> value_type;
+        typedef Cmp key_compare;
+        typedef size_t size_type;
+
+        class const_iterator {
+        public:
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef typename PersistentMap::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type* pointer;
+            typedef const value_type& reference;
+
+            const_iterator() : _root() {}
+
+            reference operator*() const { return _path.back()->value; }
+            pointer operator->() const { return &_path.back()->value; }
+
+            const_iterator& operator++() { next(); return *this; }
+            const_iterator operator++(int) { const_iterator old( *this ); next(); return old; }
+            const_iterator& operator--() { prev(); return *this; }
+            const_iterator operator--(int) { const_iterator old( *this ); prev(); return old; }
+
+            bool operator==( const const_iterator& other ) const { return node() == other.node(); }
+            bool operator!=( const const_iterator& other ) const { return node() != other.node(); }
+
+        private:
+            friend class PersistentMap;
+
+            explicit const_iterator( const Node* root ) : _root( root ) {}
+
+            const Node* node() const { return _path.empty() ? 0 : _path.back(); }
+
+            void pushLeftmost( const Node* n ) {
+                for( ; n; n = n->left.get() )
+                    _path.push_back( n );
+            }
+
+            void pushRightmost( const Node* n ) {
+                for( ; n; n = n->right.get() )
+                    _path.push_back( n );
+            }
+
+            void next() {
+                const Node* n = _path.back();
+                if ( n->right ) {
+                    pushLeftmost( n->right.get() );
+                    return;
+                }
+                // climb until we arrive from a left subtree
+                _path.pop_back();
+                while( ! _path.empty() && _path.back()->right.get() == n ) {
+                    n = _path.back();
+                    _path.pop_back();
+                }
+            }
+
+            void prev() {
+                if ( _path.empty() ) {
+                    // end()
+                    pushRightmost( _root );
+                    return;
+                }
+                const Node* n = _path.back();
+                if ( n->left ) {
+                    pushRightmost( n->left.get() );
+                    return;
+                }
+                _path.pop_back();
+                while( ! _path.empty() && _path.back()->left.get() == n ) {
+                    n = _path.back();
+                    _path.pop_back();
+                }
+            }
+
+            const Node* _root;
+            // every node from the root down to the current one, empty at end()
+            std::vector<const Node*> _path;
+        };
+        typedef const_iterator iterator;
+
+        explicit PersistentMap( const Cmp& cmp = Cmp() ) : _size(), _cmp( cmp ) {}
+
+        const_iterator begin() const {
+            const_iterator i( _root.get() );
+            i.pushLeftmost( _root.get() );
+            return i;
+        }
+        const_iterator end() const { return const_iterator( _root.get() ); }
+
+        size_type size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        key_compare key_comp() const { return _cmp; }
+
+        /** @return the first entry whose key is not less than k */
+        const_iterator lower_bound( const K& k ) const { return bound( k, false ); }
+
+        /** @return the first entry whose key is greater than k */
+        const_iterator upper_bound( const K& k ) const { return bound( k, true ); }
+
+        const_iterator find( const K& k ) const {
+            const_iterator i = lower_bound( k );
+            if ( i == end() || _cmp( k, i->first ) )
+                return end();
+            return i;
+        }
+
+        size_type count( const K& k ) const { return find( k ) == end() ? 0 : 1; }
+
+        /**
+         * Adds v unless its key is already present, like std::map::insert.
+         * @return true if v was added
+         */
+        bool insert( const value_type& v ) {
+            bool added = false;
+            _root = insert( _root, v, false, added );
+            if ( added )
+                _size++;
+            return added;
+        }
+
+        /** Adds or replaces the entry for k. */
+        void set( const K& k, const V& val ) {
+            bool added = false;
+            _root = insert( _root, value_type( k, val ), true, added );
+            if ( added )
+                _size++;
+        }
+
+        /** @return the number of entries removed */
+        size_type erase( const K& k ) {
+            bool removed = false;
+            _root = erase( _root, k, removed );
+            if ( ! removed )
+                return 0;
+            _size--;
+            return 1;
+        }
+
+        /** Removes the entries in [first, last), which must be iterators into this map. */
+        void erase( const_iterator first, const_iterator last ) {
+            std::vector<K> keys;
+            for( ; first != last; ++first )
+                keys.push_back( first->first );
+            for( typename std::vector<K>::const_iterator i = keys.begin(); i != keys.end(); ++i )
+                erase( *i );
+        }
+
+        void clear() {
+            _root.reset();
+            _size = 0;
+        }
+
+        void swap( PersistentMap& other ) {
+            _root.swap( other._root );
+            std::swap( _size, other._size );
+            std::swap( _cmp, other._cmp );
+        }
+
+    private:
+        static int height( const NodePtr& n ) { return n ? n->height : 0; }
+
+        static NodePtr make( const value_type& v, const NodePtr& l, const NodePtr& r ) {
+            return NodePtr( new Node( v, l, r, 1 + std::max( height( l ), height( r ) ) ) );
+        }
+
+        /** makes a node from subtrees whose heights differ by at most 2, rotating as needed */
+        static NodePtr balance( const value_type& v, const NodePtr& l, const NodePtr& r ) {
+            int hl = height( l );
+            int hr = height( r );
+            if ( hl > hr + 1 ) {
+                if ( height( l->left ) >= height( l->right ) )
+                    return make( l->value, l->left, make( v, l->right, r ) );
+                const Node* lr = l->right.get();
+                return make( lr->value, make( l->value, l->left, lr->left ), make( v, lr->right, r ) );
+            }
+            if ( hr > hl + 1 ) {
+                if ( height( r->right ) >= height( r->left ) )
+                    return make( r->value, make( v, l, r->left ), r->right );
+                const Node* rl = r->left.get();
+                return make( rl->value, make( v, l, rl->left ), make( r->value, rl->right, r->right ) );
+            }
+            return make( v, l, r );
+        }
+
+        NodePtr insert( const NodePtr& n, const value_type& v, bool replace, bool& added ) const {
+            if ( ! n ) {
+                added = true;
+                return make( v, NodePtr(), NodePtr() );
+            }
+            if ( _cmp( v.first, n->value.first ) ) {
+                NodePtr l = insert( n->left, v, replace, added );
+                return l == n->left ? n : balance( n->value, l, n->right );
+            }
+            if ( _cmp( n->value.first, v.first ) ) {
+                NodePtr r = insert( n->right, v, replace, added );
+                return r == n->right ? n : balance( n->value, n->left, r );
+            }
+            return replace ? make( v, n->left, n->right ) : n;
+        }
+
+        NodePtr erase( const NodePtr& n, const K& k, bool& removed ) const {
+            if ( ! n )
+                return n;
+            if ( _cmp( k, n->value.first ) ) {
+                NodePtr l = erase( n->left, k, removed );
+                return l == n->left ? n : balance( n->value, l, n->right );
+            }
+            if ( _cmp( n->value.first, k ) ) {
+                NodePtr r = erase( n->right, k, removed );
+                return r == n->right ? n : balance( n->value, n->left, r );
+            }
+            removed = true;
+            if ( ! n->left )
+                return n->right;
+            if ( ! n->right )
+                return n->left;
+            // replace n with its successor
+            const Node* succ = n->right.get();
+            while( succ->left )
+                succ = succ->left.get();
+            return balance( succ->value, n->left, eraseMin( n->right ) );
+        }
+
+        static NodePtr eraseMin( const NodePtr& n ) {
+            if ( ! n->left )
+                return n->right;
+            return balance( n->value, eraseMin( n->left ), n->right );
+        }
+
+        const_iterator bound( const K& k, bool upper ) const {
+            const_iterator i( _root.get() );
+            size_t found = 0;
+            for( const Node* n = _root.get(); n; ) {
+                i._path.push_back( n );
+                bool after = upper ? _cmp( k, n->value.first ) : ! _cmp( n->value.first, k );
+                if ( after ) {
+                    found = i._path.size();
+                    n = n->left.get();
+                }
+                else {
+                    n = n->right.get();
+                }
+            }
+            i._path.resize( found );
+            return i;
+        }
+
+        NodePtr _root;
+        size_type _size;
+        Cmp _cmp;
+    };
+
+} // namespace mongo
@@ -135,6 +135,9 @@ namespace mongo {
         pid_t _pid;
         static mongo::mutex _sysInfoLock;
 
+        /** resident pages per NUMA node, linux only */
+        void appendNumaResidentPages( BSONObjBuilder& info );
+
         static bool checkNumaEnabled();
 
         const SystemInfo& sysInfo() const {
@@ -381,6 +381,55 @@ namespace mongo {
 
         LinuxProc p(_pid);
         info.append("page_faults", (int)p._maj_flt);
+
+        static const bool multipleNodes = boost::filesystem::exists( "/sys/devices/system/node/node1" );
+        if ( multipleNodes )
+            appendNumaResidentPages( info );
+    }
+
+    static mongo::mutex numaMapsMutex( "numaMaps" );
+    static BSONObj numaResidentPages;
+    static unsigned long long numaResidentPagesMillis = 0;
+
+    /** how long per node page counts are reused before numa_maps is read again */
+    static const unsigned long long NumaMapsRefreshMillis = 60 * 1000;
+
+    /**
+    * Sum the per node page counts ("N<node>=<pages>") over all mappings in /proc/<pid>/numa_maps.
+    * Reading it costs a walk of the page tables of every mapping, which is large with big data
+    * files mapped, so the counts are refreshed at most once every NumaMapsRefreshMillis.
+    */
+    void ProcessInfo::appendNumaResidentPages( BSONObjBuilder& info ) {
+        scoped_lock lk( numaMapsMutex );
+        unsigned long long now = curTimeMillis64();
+        if ( numaResidentPagesMillis == 0 || now - numaResidentPagesMillis >= NumaMapsRefreshMillis ) {
+            char name[128];
+            sprintf( name , "/proc/%d/numa_maps" , _pid );
+
+            FILE* f = fopen( name , "r" );
+            if ( f == NULL )
+                return;
+
+            map<int,long long> pages;
+            char word[256];
+            while ( fscanf( f , "%255s" , word ) == 1 ) {
+                int node;
+                long long n;
+                if ( word[0] == 'N' && sscanf( word , "N%d=%lld" , &node , &n ) == 2 )
+                    pages[node] += n;
+            }
+            fclose( f );
+
+            BSONObjBuilder b;
+            for ( map<int,long long>::const_iterator i = pages.begin(); i != pages.end(); ++i ) {
+                char field[32];
+                sprintf( field , "N%d" , i->first );
+                b.appendNumber( field , i->second );
+            }
+            numaResidentPages = b.obj();
+            numaResidentPagesMillis = now;
+        }
+        info.append( "numa_resident_pages" , numaResidentPages );
     }
 
     /**
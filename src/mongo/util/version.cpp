@@ -164,7 +164,7 @@ namespace mongo {
             warned = true;
         }
 
-        if (boost::filesystem::exists("/sys/devices/system/node/node1")){
+        if (!cmdLine.numaInterleave && boost::filesystem::exists("/sys/devices/system/node/node1")){
             // We are on a box with a NUMA enabled kernel and more than 1 numa node (they start at node0)
             // Now we look at the first line of /proc/self/numa_maps
             //
@@ -202,6 +202,7 @@ namespace mongo {
                         log() << "** WARNING: You are running on a NUMA machine." << startupWarningsLog;
                         log() << "**          We suggest launching mongod like this to avoid performance problems:" << startupWarningsLog;
                         log() << "**              numactl --interleave=all mongod [other options]" << startupWarningsLog;
+                        log() << "**          or start mongod with --numaInterleave" << startupWarningsLog;
                         warned = true;
                     }
                 }